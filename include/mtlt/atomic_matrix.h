@@ -40,7 +40,9 @@
 #endif
 
 #include <mtlt/matrix_config.h>
+#include <mtlt/matrix_allocator.h>
 #include <mtlt/matrix_type_traits.h>
+#include <mtlt/matrix_decomposition.h>
 #include <mtlt/matrix_normal_iterator.h>
 #include <mtlt/matrix_reverse_iterator.h>
 
@@ -66,7 +68,8 @@ namespace mtlt {
  *
  * @endcode
  */
-template<typename T, template<typename> class Atomic = std::atomic>
+template<typename T, template<typename> class Atomic = std::atomic,
+	typename Allocator = default_allocator<T, Atomic<T>>>
 class atomic_matrix;
 
 /**
@@ -93,19 +96,22 @@ using fundamental_atomic_matrix = typename std::conditional<!std::is_fundamental
 															detail::incomplete_compile_error_generation_type,
 															atomic_matrix<T, Atomic>>::type;
 
-template<typename T, template<typename> class Atomic>
+template<typename T, template<typename> class Atomic, typename Allocator>
 class atomic_matrix final {
 public:
   static_assert(is_atomic<Atomic<T>>::value,
 				"\nAtomic<T> must be atomic type");
+  static_assert(std::is_same<typename std::allocator_traits<Allocator>::value_type, Atomic<T>>::value,
+				"Allocator must allocate items of type Atomic<T>");
 
 public:
   using atomic_type = Atomic<T>;
   using atomic_value_type = typename atomic_type::value_type;
-  using value_type = typename std::allocator_traits<std::allocator<atomic_type>>::value_type;
-  using pointer = typename std::allocator_traits<std::allocator<atomic_type>>::pointer;
-  using const_pointer = typename std::allocator_traits<std::allocator<atomic_type>>::const_pointer;
-  using size_type = typename std::allocator_traits<std::allocator<atomic_type>>::size_type;
+  using allocator_type = Allocator;
+  using value_type = typename std::allocator_traits<Allocator>::value_type;
+  using pointer = typename std::allocator_traits<Allocator>::pointer;
+  using const_pointer = typename std::allocator_traits<Allocator>::const_pointer;
+  using size_type = typename std::allocator_traits<Allocator>::size_type;
   using reference = value_type &;
   using const_reference = const value_type &;
   using iterator = matrix_normal_iterator<pointer>;
@@ -116,12 +122,20 @@ public:
 public:
   MATRIX_CXX17_CONSTEXPR atomic_matrix() noexcept = default;
 
-  MATRIX_CXX17_CONSTEXPR atomic_matrix(size_type rows, size_type cols, atomic_value_type f = {})
-	  : rows_(rows), cols_(cols), data_(new value_type[rows * cols]{}) {
-	if (f != value_type{})
-	  fill(f);
+  MATRIX_CXX17_CONSTEXPR explicit atomic_matrix(const allocator_type &allocator) noexcept
+	  : allocator_(allocator) {}
 
-  }
+  MATRIX_CXX17_CONSTEXPR atomic_matrix(size_type rows, size_type cols, atomic_value_type f = {},
+									   const allocator_type &allocator = allocator_type())
+	  : allocator_(allocator), rows_(rows), cols_(cols), data_(allocate(rows * cols, f)) {}
+
+  /**
+   * The atomics are default constructed, before C++20 it leaves them uninitialized
+   */
+  MATRIX_CXX17_CONSTEXPR atomic_matrix(size_type rows, size_type cols, uninitialized_t,
+									   const allocator_type &allocator = allocator_type())
+	  : allocator_(allocator), rows_(rows), cols_(cols),
+		data_(allocate_uninitialized(rows * cols, std::is_trivially_default_constructible<value_type>())) {}
 
   MATRIX_CXX17_CONSTEXPR explicit atomic_matrix(size_type square) : atomic_matrix(square, square) {};
 
@@ -129,8 +143,9 @@ public:
 	  typename std::enable_if<
 		  std::is_convertible<typename Container::value_type, atomic_value_type>::value ||
 			  std::is_same<typename Container::value_type, atomic_type>::value, bool>::type = true>
-  MATRIX_CXX17_CONSTEXPR atomic_matrix(size_type rows, size_type cols, const Container &container)
-	  : atomic_matrix(rows, cols) {
+  MATRIX_CXX17_CONSTEXPR atomic_matrix(size_type rows, size_type cols, const Container &container,
+									   const allocator_type &allocator = allocator_type())
+	  : atomic_matrix(rows, cols, atomic_value_type{}, allocator) {
 	auto it = begin();
 	for (const auto &value : container) {
 	  (*it).store(value);
@@ -139,8 +154,9 @@ public:
   }
 
   MATRIX_CXX17_CONSTEXPR atomic_matrix(size_type rows, size_type cols,
-									   const std::initializer_list<atomic_value_type> &initializer)
-	  : atomic_matrix(rows, cols) {
+									   const std::initializer_list<atomic_value_type> &initializer,
+									   const allocator_type &allocator = allocator_type())
+	  : atomic_matrix(rows, cols, atomic_value_type{}, allocator) {
 	auto it = begin();
 	for (const auto &value : initializer) {
 	  (*it).store(value);
@@ -148,14 +164,17 @@ public:
 	}
   }
 
-  static atomic_matrix identity(size_type rows, size_type cols) {
-	atomic_matrix identity(rows, cols);
+  static atomic_matrix identity(size_type rows, size_type cols, const allocator_type &allocator = allocator_type()) {
+	atomic_matrix identity(rows, cols, atomic_value_type{}, allocator);
 	identity.to_identity();
 	return identity;
   }
 
   MATRIX_CXX17_CONSTEXPR atomic_matrix(const atomic_matrix &other)
-	  : atomic_matrix(other.rows_, other.cols_) {
+	  : atomic_matrix(other, std::allocator_traits<Allocator>::select_on_container_copy_construction(other.allocator_)) {}
+
+  MATRIX_CXX17_CONSTEXPR atomic_matrix(const atomic_matrix &other, const allocator_type &allocator)
+	  : atomic_matrix(other.rows_, other.cols_, uninitialized, allocator) {
 	auto it = begin();
 	for (const auto &value : other) {
 	  (*it).store(value);
@@ -164,36 +183,81 @@ public:
   }
 
   MATRIX_CXX17_CONSTEXPR atomic_matrix(atomic_matrix &&other) noexcept
-	  : rows_(other.rows_), cols_(other.cols_), data_(other.data_) {
+	  : allocator_(std::move(other.allocator_)), rows_(other.rows_), cols_(other.cols_), data_(other.data_) {
 	other.rows_ = other.cols_ = size_type{};
 	other.data_ = nullptr;
   }
 
-  MATRIX_CXX17_CONSTEXPR atomic_matrix &operator=(atomic_matrix &&other) noexcept {
+  /**
+   * The storage of other is taken if the allocator propagates on move
+   * assignment or the allocators are equal, otherwise the values are
+   * stored one by one to the storage of this allocator
+   */
+  MATRIX_CXX17_CONSTEXPR atomic_matrix &operator=(atomic_matrix &&other)
+	  noexcept(detail::allocator_move_steals<Allocator>::value) {
 	if (&other == this)
 	  return *this;
 
-	std::swap(rows_, other.rows_);
-	std::swap(cols_, other.cols_);
-	std::swap(data_, other.data_);
+	if (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+	  clear();
+	  allocator_ = std::move(other.allocator_);
+	  take_storage(other);
+	} else if (allocator_ == other.allocator_) {
+	  take_storage(other);
+	} else if (data_ != nullptr && size() == other.size()) {
+	  store_from(other);
+	} else {
+	  atomic_matrix tmp(other.rows_, other.cols_, uninitialized, allocator_);
+	  tmp.store_from(other);
+	  take_storage(tmp);
+	}
 
 	return *this;
   }
 
+  /**
+   * The allocator of other is taken only if it propagates on copy assignment,
+   * the storage is reused when the sizes are equal
+   */
   MATRIX_CXX17_CONSTEXPR atomic_matrix &operator=(const atomic_matrix &other) {
 	if (&other == this)
 	  return *this;
 
-	atomic_matrix tmp(other);
-	*this = std::move(tmp);
+	if (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value && allocator_ != other.allocator_)
+	  clear();
+	if (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value)
+	  allocator_ = other.allocator_;
 
+	if (data_ != nullptr && size() == other.size()) {
+	  store_from(other);
+	  return *this;
+	}
+
+	atomic_matrix tmp(other, allocator_);
+	take_storage(tmp);
 	return *this;
   }
 
+  /**
+   * The allocators are swapped only if they propagate on swap,
+   * otherwise they must be equal, as for the standard containers
+   */
+  void swap(atomic_matrix &other) noexcept {
+	using std::swap;
+	if (std::allocator_traits<Allocator>::propagate_on_container_swap::value)
+	  swap(allocator_, other.allocator_);
+
+	swap(rows_, other.rows_);
+	swap(cols_, other.cols_);
+	swap(data_, other.data_);
+  }
+
   ~atomic_matrix() noexcept {
-	delete[] data_;
+	deallocate(data_, rows_ * cols_);
   }
 
+  allocator_type get_allocator() const noexcept { return allocator_; }
+
 public:
   MATRIX_CXX17_CONSTEXPR
   iterator begin() noexcept {
@@ -291,7 +355,7 @@ public:
 	if (rows_ == rows)
 	  return;
 
-	atomic_matrix tmp(rows, cols_);
+	atomic_matrix tmp(rows, cols_, atomic_value_type{}, allocator_);
 	const size_type min_rows = std::min(rows, rows_);
 
 	for (size_type row = 0; row != min_rows; ++row)
@@ -305,7 +369,7 @@ public:
 	if (cols_ == cols)
 	  return;
 
-	atomic_matrix tmp(rows_, cols);
+	atomic_matrix tmp(rows_, cols, atomic_value_type{}, allocator_);
 	const size_type min_cols = std::min(cols, cols_);
 
 	for (size_type row = 0; row != rows_; ++row)
@@ -319,7 +383,7 @@ public:
 	if (cols_ == cols && rows_ == rows)
 	  return;
 
-	atomic_matrix tmp(rows, cols);
+	atomic_matrix tmp(rows, cols, atomic_value_type{}, allocator_);
 	const size_type min_cols = std::min(cols, cols_);
 	const size_type min_rows = std::min(rows, rows_);
 
@@ -331,8 +395,8 @@ public:
   }
 
   void clear() noexcept {
+	deallocate(data_, rows_ * cols_);
 	rows_ = cols_ = size_type{};
-	delete[] data_;
 	data_ = nullptr;
   }
 
@@ -382,11 +446,11 @@ public:
   }
 
 #if __cplusplus > 201703L
-  template<typename U> requires(std::convertible_to<U, T>)
-  atomic_matrix &mul(const atomic_matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator> requires(std::convertible_to<U, T>)
+  atomic_matrix &mul(const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
 #else
-  template<typename U>
-  atomic_matrix &mul(const atomic_matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator>
+  atomic_matrix &mul(const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
 	static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
 	if (cols_ != rhs.rows())
@@ -395,7 +459,7 @@ public:
 	const size_type cols = rhs.cols();
 	const size_type rows = rows_;
 
-	atomic_matrix multiplied(rows, cols);
+	atomic_matrix multiplied(rows, cols, atomic_value_type{}, allocator_);
 	for (size_type row = 0; row != rows; ++row)
 	  for (size_type col = 0; col != cols; ++col)
 		for (size_type k = 0; k != cols_; ++k) {
@@ -434,11 +498,11 @@ public:
   }
 
 #if __cplusplus > 201703L
-  template<typename U> requires(std::convertible_to<U, T>)
-  atomic_matrix &add(const atomic_matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator> requires(std::convertible_to<U, T>)
+  atomic_matrix &add(const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
 #else
-  template<typename U>
-  atomic_matrix &add(const atomic_matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator>
+  atomic_matrix &add(const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
 	static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
 	if (rhs.rows() != rows_ || rhs.cols() != cols_)
@@ -454,11 +518,11 @@ public:
   }
 
 #if __cplusplus > 201703L
-  template<typename U> requires(std::convertible_to<U, T>)
-  atomic_matrix &sub(const atomic_matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator> requires(std::convertible_to<U, T>)
+  atomic_matrix &sub(const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
 #else
-  template<typename U>
-  atomic_matrix &sub(const atomic_matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator>
+  atomic_matrix &sub(const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
 	static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
 	if (rhs.rows() != rows_ || rhs.cols() != cols_)
@@ -528,7 +592,7 @@ public:
   }
 
   atomic_matrix zero() const {
-	return atomic_matrix(rows_, cols_);
+	return atomic_matrix(rows_, cols_, atomic_value_type{}, allocator_);
   }
 
   atomic_matrix &to_identity() {
@@ -562,7 +626,7 @@ public:
 	if (rhs.rows() != rows_)
 	  throw std::logic_error("Can't join left rhs matrix to lhs, because lhs.rows() != rhs.rows()");
 
-	atomic_matrix join_matrix(rows_, cols_ + rhs.cols());
+	atomic_matrix join_matrix(rows_, cols_ + rhs.cols(), atomic_value_type{}, allocator_);
 
 	size_type cols2 = rhs.cols();
 
@@ -596,7 +660,7 @@ public:
 	if (rhs.rows() != rows_)
 	  throw std::logic_error("Can't join right rhs matrix to lhs, because lhs.rows() != rhs.rows()");
 
-	atomic_matrix join_matrix(rows_, cols_ + rhs.cols());
+	atomic_matrix join_matrix(rows_, cols_ + rhs.cols(), atomic_value_type{}, allocator_);
 	size_type cols2 = rhs.cols();
 
 	for (size_type row = 0; row != join_matrix.rows(); ++row)
@@ -623,7 +687,7 @@ public:
 
 	size_type old_rows = rows_;
 	size_type rows2 = rhs.rows();
-	atomic_matrix join_matrix(rows_ + rhs.rows(), cols_);
+	atomic_matrix join_matrix(rows_ + rhs.rows(), cols_, atomic_value_type{}, allocator_);
 
 	for (size_type row = 0; row != join_matrix.rows(); ++row)
 	  for (size_type col = 0; col != join_matrix.cols(); ++col) {
@@ -655,7 +719,7 @@ public:
 	if (rhs.rows() != rows_)
 	  throw std::logic_error("Can't join bottom rhs matrix to lhs, because lhs.cols() != rhs.cols()");
 
-	atomic_matrix join_matrix(rows_ + rhs.rows(), cols_);
+	atomic_matrix join_matrix(rows_ + rhs.rows(), cols_, atomic_value_type{}, allocator_);
 	size_type rows2 = rhs.rows();
 
 	for (size_type row = 0; row != join_matrix.rows(); ++row)
@@ -671,7 +735,7 @@ public:
 
 public:
   atomic_matrix transpose() const {
-	atomic_matrix transposed(cols_, rows_);
+	atomic_matrix transposed(cols_, rows_, uninitialized, allocator_);
 
 	for (size_type row = 0; row != rows_; ++row)
 	  for (size_type col = 0; col != cols_; ++col)
@@ -681,7 +745,7 @@ public:
   }
 
   atomic_matrix minor(size_type row, size_type col) const {
-	atomic_matrix minor(rows() - 1, cols() - 1);
+	atomic_matrix minor(rows() - 1, cols() - 1, atomic_value_type{}, allocator_);
 
 	size_type skip_row = 0, skip_col = 0;
 	for (size_type r = 0; r != minor.rows_; ++r) {
@@ -765,26 +829,43 @@ public:
 	return determinant_value;
   }
 
+  /**
+   * Cofactor expansion along the first row, O(n!) without allocations.
+   * It is an explicit opt-in for tiny matrices, throws above
+   * detail::cofactor_max_size rows
+   */
   double determinant_laplacian() const {
 	if (rows_ != cols_)
-	  throw std::logic_error("determinant_gaussian can be found only for square matrices");
+	  throw std::logic_error("determinant_laplacian can be found only for square matrices");
+	if (rows_ > detail::cofactor_max_size)
+	  throw std::logic_error("determinant_laplacian is O(n!), use determinant_gaussian or determinant_bareiss");
 
-	int sign = 1;
-	double determinant_value{};
+	size_type columns[detail::cofactor_max_size] = {};
+	for (size_type col = 0; col != cols_; ++col)
+	  columns[col] = col;
 
-	if (rows_ == 1 && cols_ == 1)
-	  determinant_value = (*this)(0, 0);
-	else if (rows_ == 2 && cols_ == 2)
-	  determinant_value = ((*this)(0, 0) * (*this)(1, 1)) - ((*this)(1, 0) * (*this)(0, 1));
-	else {
-	  for (size_type col = 0; col != cols_; ++col) {
-		atomic_matrix minored = minor(0, col);
-		determinant_value += sign * (*this)(0, col) * minored.determinant_laplacian();
-		sign = -sign;
-	  }
-	}
+	return detail::cofactor_determinant(*this, 0, columns, cols_);
+  }
 
-	return determinant_value;
+  /**
+   * Exact determinant of an integral matrix by fraction-free Bareiss
+   * elimination in O(n^3), items are loaded once into a twice wider integer
+   */
+#if __cplusplus > 201703L
+  atomic_value_type determinant_bareiss() const requires (std::integral<atomic_value_type>) {
+#else
+  atomic_value_type determinant_bareiss() const {
+	static_assert(std::is_integral<atomic_value_type>::value, "T must be integral type");
+#endif
+	if (rows_ != cols_)
+	  throw std::logic_error("determinant_bareiss can be found only for square matrices");
+
+	std::vector<typename detail::bareiss_type<atomic_value_type>::type> factors(rows_ * cols_);
+	for (size_type row = 0; row != rows_; ++row)
+	  for (size_type col = 0; col != cols_; ++col)
+		factors[row * cols_ + col] = (*this)(row, col).load();
+
+	return static_cast<atomic_value_type>(detail::bareiss_determinant(rows_, factors.data()));
   }
 
   atomic_value_type trace() const {
@@ -801,7 +882,7 @@ public:
 	if (rows_ != cols_)
 	  throw std::logic_error("Complements matrix can be found only for square matrices");
 
-	atomic_matrix complements(rows_, cols_);
+	atomic_matrix complements(rows_, cols_, atomic_value_type{}, allocator_);
 
 	for (size_type row = 0; row != rows_; ++row) {
 	  for (size_type col = 0; col != cols_; ++col) {
@@ -910,22 +991,103 @@ public:
   }
 
 private:
+  /**
+   * Storage of n atomics constructed from args, the constructed
+   * items are destroyed if one of the constructors throws
+   */
+  /**
+   * Releases the storage of this matrix and takes the storage of other,
+   * which must be released by the allocator of this matrix
+   */
+  void take_storage(atomic_matrix &other) noexcept {
+	clear();
+	rows_ = other.rows_;
+	cols_ = other.cols_;
+	data_ = other.data_;
+
+	other.rows_ = other.cols_ = size_type{};
+	other.data_ = nullptr;
+  }
+
+  /**
+   * Stores the values of other, which has the same number of items
+   */
+  void store_from(const atomic_matrix &other) noexcept {
+	auto it = begin();
+	for (const auto &value : other) {
+	  (*it).store(value.load());
+	  ++it;
+	}
+	rows_ = other.rows_;
+	cols_ = other.cols_;
+  }
+
+  template<typename ...Args>
+  pointer allocate(size_type n, const Args &...args) {
+	if (n == 0)
+	  return nullptr;
+
+	pointer storage = std::allocator_traits<Allocator>::allocate(allocator_, n);
+	size_type constructed = 0;
+
+	try {
+	  for (; constructed != n; ++constructed)
+		std::allocator_traits<Allocator>::construct(allocator_, storage + constructed, args...);
+	} catch (...) {
+	  destroy(storage, constructed);
+	  std::allocator_traits<Allocator>::deallocate(allocator_, storage, n);
+	  throw;
+	}
+
+	return storage;
+  }
+
+  pointer allocate_uninitialized(size_type n, std::true_type) {
+	return n == 0 ? nullptr : std::allocator_traits<Allocator>::allocate(allocator_, n);
+  }
+
+  pointer allocate_uninitialized(size_type n, std::false_type) {
+	return allocate(n);
+  }
+
+  void destroy(pointer storage, size_type n) noexcept {
+	for (size_type i = 0; i != n; ++i)
+	  std::allocator_traits<Allocator>::destroy(allocator_, storage + i);
+  }
+
+  void deallocate(pointer storage, size_type n) noexcept {
+	if (storage == nullptr)
+	  return;
+
+	destroy(storage, n);
+	std::allocator_traits<Allocator>::deallocate(allocator_, storage, n);
+  }
+
+private:
+  allocator_type allocator_{};
   size_type rows_{}, cols_{};
   pointer data_ = nullptr;
 };
 
-template<typename T, template<typename> class Atomic>
-std::ostream &operator<<(std::ostream &out, const atomic_matrix<T, Atomic> &rhs) {
+template<typename T, template<typename> class Atomic, typename Allocator>
+std::ostream &operator<<(std::ostream &out, const atomic_matrix<T, Atomic, Allocator> &rhs) {
   rhs.print(out);
   return out;
 }
 
+template<typename T, template<typename> class Atomic, typename Allocator>
+void inline swap(atomic_matrix<T, Atomic, Allocator> &lhs, atomic_matrix<T, Atomic, Allocator> &rhs) noexcept {
+  lhs.swap(rhs);
+}
+
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline &operator+=(atomic_matrix<T, Atomic> &lhs, const atomic_matrix<U, Atomic> &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator, typename OtherAllocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline &operator+=(atomic_matrix<T, Atomic, Allocator> &lhs,
+													   const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline &operator+=(atomic_matrix<T, Atomic> &lhs, const atomic_matrix<U, Atomic> &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator, typename OtherAllocator>
+atomic_matrix<T, Atomic, Allocator> inline &operator+=(atomic_matrix<T, Atomic, Allocator> &lhs,
+													   const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.add(rhs);
@@ -933,11 +1095,13 @@ atomic_matrix<T, Atomic> inline &operator+=(atomic_matrix<T, Atomic> &lhs, const
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline &operator-=(atomic_matrix<T, Atomic> &lhs, const atomic_matrix<U, Atomic> &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator, typename OtherAllocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline &operator-=(atomic_matrix<T, Atomic, Allocator> &lhs,
+													   const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline &operator-=(atomic_matrix<T, Atomic> &lhs, const atomic_matrix<U, Atomic> &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator, typename OtherAllocator>
+atomic_matrix<T, Atomic, Allocator> inline &operator-=(atomic_matrix<T, Atomic, Allocator> &lhs,
+													   const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.sub(rhs);
@@ -945,11 +1109,13 @@ atomic_matrix<T, Atomic> inline &operator-=(atomic_matrix<T, Atomic> &lhs, const
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline &operator*=(atomic_matrix<T, Atomic> &lhs, const atomic_matrix<U, Atomic> &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator, typename OtherAllocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline &operator*=(atomic_matrix<T, Atomic, Allocator> &lhs,
+													   const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline &operator*=(atomic_matrix<T, Atomic> &lhs, const atomic_matrix<U, Atomic> &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator, typename OtherAllocator>
+atomic_matrix<T, Atomic, Allocator> inline &operator*=(atomic_matrix<T, Atomic, Allocator> &lhs,
+													   const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.mul(rhs);
@@ -957,11 +1123,11 @@ atomic_matrix<T, Atomic> inline &operator*=(atomic_matrix<T, Atomic> &lhs, const
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline &operator+=(atomic_matrix<T, Atomic> &lhs, const U &value) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline &operator+=(atomic_matrix<T, Atomic, Allocator> &lhs, const U &value) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline &operator+=(atomic_matrix<T, Atomic> &lhs, const U &value) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator>
+atomic_matrix<T, Atomic, Allocator> inline &operator+=(atomic_matrix<T, Atomic, Allocator> &lhs, const U &value) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.add(value);
@@ -969,11 +1135,11 @@ atomic_matrix<T, Atomic> inline &operator+=(atomic_matrix<T, Atomic> &lhs, const
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline &operator-=(atomic_matrix<T, Atomic> &lhs, const U &value) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline &operator-=(atomic_matrix<T, Atomic, Allocator> &lhs, const U &value) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline &operator-=(atomic_matrix<T, Atomic> &lhs, const U &value) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator>
+atomic_matrix<T, Atomic, Allocator> inline &operator-=(atomic_matrix<T, Atomic, Allocator> &lhs, const U &value) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.sub(value);
@@ -981,11 +1147,11 @@ atomic_matrix<T, Atomic> inline &operator-=(atomic_matrix<T, Atomic> &lhs, const
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline &operator*=(atomic_matrix<T, Atomic> &lhs, const U &value) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline &operator*=(atomic_matrix<T, Atomic, Allocator> &lhs, const U &value) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline &operator*=(atomic_matrix<T, Atomic> &lhs, const U &value) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator>
+atomic_matrix<T, Atomic, Allocator> inline &operator*=(atomic_matrix<T, Atomic, Allocator> &lhs, const U &value) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.mul(value);
@@ -993,11 +1159,11 @@ atomic_matrix<T, Atomic> inline &operator*=(atomic_matrix<T, Atomic> &lhs, const
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline &operator/=(atomic_matrix<T, Atomic> &lhs, const U &value) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline &operator/=(atomic_matrix<T, Atomic, Allocator> &lhs, const U &value) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline &operator/=(atomic_matrix<T, Atomic> &lhs, const U &value) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator>
+atomic_matrix<T, Atomic, Allocator> inline &operator/=(atomic_matrix<T, Atomic, Allocator> &lhs, const U &value) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.div(value);
@@ -1005,116 +1171,122 @@ atomic_matrix<T, Atomic> inline &operator/=(atomic_matrix<T, Atomic> &lhs, const
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline operator+(const atomic_matrix<T, Atomic> &lhs, const atomic_matrix<U, Atomic> &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator, typename OtherAllocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline operator+(const atomic_matrix<T, Atomic, Allocator> &lhs,
+													 const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline operator+(const atomic_matrix<T, Atomic> &lhs, const atomic_matrix<U, Atomic> &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator, typename OtherAllocator>
+atomic_matrix<T, Atomic, Allocator> inline operator+(const atomic_matrix<T, Atomic, Allocator> &lhs,
+													 const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  atomic_matrix<T, Atomic> result(lhs);
+  atomic_matrix<T, Atomic, Allocator> result(lhs);
   result.add(rhs);
   return result;
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline operator-(const atomic_matrix<T, Atomic> &lhs, const atomic_matrix<U, Atomic> &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator, typename OtherAllocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline operator-(const atomic_matrix<T, Atomic, Allocator> &lhs,
+													 const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline operator-(const atomic_matrix<T, Atomic> &lhs, const atomic_matrix<U, Atomic> &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator, typename OtherAllocator>
+atomic_matrix<T, Atomic, Allocator> inline operator-(const atomic_matrix<T, Atomic, Allocator> &lhs,
+													 const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  atomic_matrix<T, Atomic> result(lhs);
+  atomic_matrix<T, Atomic, Allocator> result(lhs);
   result.sub(rhs);
   return result;
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline operator*(const atomic_matrix<T, Atomic> &lhs, const atomic_matrix<U, Atomic> &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator, typename OtherAllocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline operator*(const atomic_matrix<T, Atomic, Allocator> &lhs,
+													 const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline operator*(const atomic_matrix<T, Atomic> &lhs, const atomic_matrix<U, Atomic> &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator, typename OtherAllocator>
+atomic_matrix<T, Atomic, Allocator> inline operator*(const atomic_matrix<T, Atomic, Allocator> &lhs,
+													 const atomic_matrix<U, Atomic, OtherAllocator> &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  atomic_matrix<T, Atomic> result(lhs);
+  atomic_matrix<T, Atomic, Allocator> result(lhs);
   result.mul(rhs);
   return result;
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline operator+(const atomic_matrix<T, Atomic> &lhs, const U &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline operator+(const atomic_matrix<T, Atomic, Allocator> &lhs, const U &rhs) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline operator+(const atomic_matrix<T, Atomic> &lhs, const U &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator>
+atomic_matrix<T, Atomic, Allocator> inline operator+(const atomic_matrix<T, Atomic, Allocator> &lhs, const U &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  atomic_matrix<T, Atomic> result(lhs);
+  atomic_matrix<T, Atomic, Allocator> result(lhs);
   result.add(rhs);
   return result;
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline operator-(const atomic_matrix<T, Atomic> &lhs, const U &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline operator-(const atomic_matrix<T, Atomic, Allocator> &lhs, const U &rhs) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline operator-(const atomic_matrix<T, Atomic> &lhs, const U &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator>
+atomic_matrix<T, Atomic, Allocator> inline operator-(const atomic_matrix<T, Atomic, Allocator> &lhs, const U &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  atomic_matrix<T, Atomic> result(lhs);
+  atomic_matrix<T, Atomic, Allocator> result(lhs);
   result.sub(rhs);
   return result;
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline operator*(const atomic_matrix<T, Atomic> &lhs, const U &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline operator*(const atomic_matrix<T, Atomic, Allocator> &lhs, const U &rhs) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline operator*(const atomic_matrix<T, Atomic> &lhs, const U &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator>
+atomic_matrix<T, Atomic, Allocator> inline operator*(const atomic_matrix<T, Atomic, Allocator> &lhs, const U &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  atomic_matrix<T, Atomic> result(lhs);
+  atomic_matrix<T, Atomic, Allocator> result(lhs);
   result.mul(rhs);
   return result;
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<U, Atomic> inline operator*(const U &rhs, const atomic_matrix<T, Atomic> &lhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator> requires (std::convertible_to<U, T>)
+atomic_matrix<U, Atomic, Allocator> inline operator*(const U &rhs, const atomic_matrix<T, Atomic, Allocator> &lhs) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<U, Atomic> inline operator*(const U &rhs, const atomic_matrix<T, Atomic> &lhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator>
+atomic_matrix<U, Atomic, Allocator> inline operator*(const U &rhs, const atomic_matrix<T, Atomic, Allocator> &lhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  atomic_matrix<T, Atomic> result(lhs);
+  atomic_matrix<T, Atomic, Allocator> result(lhs);
   result.mul(rhs);
   return result;
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U, template<typename> class Atomic> requires (std::convertible_to<U, T>)
-atomic_matrix<T, Atomic> inline operator/(const atomic_matrix<T, Atomic> &lhs, const U &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator> requires (std::convertible_to<U, T>)
+atomic_matrix<T, Atomic, Allocator> inline operator/(const atomic_matrix<T, Atomic, Allocator> &lhs, const U &rhs) {
 #else
-template<typename T, typename U, template<typename> class Atomic>
-atomic_matrix<T, Atomic> inline operator/(const atomic_matrix<T, Atomic> &lhs, const U &rhs) {
+template<typename T, typename U, template<typename> class Atomic, typename Allocator>
+atomic_matrix<T, Atomic, Allocator> inline operator/(const atomic_matrix<T, Atomic, Allocator> &lhs, const U &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  atomic_matrix<T, Atomic> result(lhs);
+  atomic_matrix<T, Atomic, Allocator> result(lhs);
   result.div(rhs);
   return result;
 }
 
-template<typename T, template<typename> class Atomic>
-bool inline operator==(const atomic_matrix<T, Atomic> &lhs, const atomic_matrix<T, Atomic> &rhs) {
+template<typename T, template<typename> class Atomic, typename Allocator>
+bool inline operator==(const atomic_matrix<T, Atomic, Allocator> &lhs, const atomic_matrix<T, Atomic, Allocator> &rhs) {
   return lhs.equal_to(rhs);
 }
 
-template<typename T, template<typename> class Atomic>
-bool inline operator!=(const atomic_matrix<T, Atomic> &lhs, const atomic_matrix<T, Atomic> &rhs) {
+template<typename T, template<typename> class Atomic, typename Allocator>
+bool inline operator!=(const atomic_matrix<T, Atomic, Allocator> &lhs, const atomic_matrix<T, Atomic, Allocator> &rhs) {
   return !(lhs == rhs);
 }
 
@@ -27,6 +27,7 @@
 #include <random>
 #include <chrono>
 #include <vector>
+#include <memory>
 #include <iomanip>
 #include <numeric>
 #include <iostream>
@@ -34,14 +35,19 @@
 #include <functional>
 
 #if __cplusplus > 201703L
+#include <span>
 #include <concepts>
 #endif
 
 #include <mtlt/matrix_normal_iterator.h>
 #include <mtlt/matrix_reverse_iterator.h>
 
+#include <mtlt/matrix_gemm.h>
 #include <mtlt/matrix_config.h>
+#include <mtlt/matrix_layout.h>
+#include <mtlt/matrix_allocator.h>
 #include <mtlt/matrix_type_traits.h>
+#include <mtlt/matrix_decomposition.h>
 
 namespace mtlt {
 
@@ -68,10 +74,20 @@ namespace mtlt {
  * mtlt::static_matrix<int, 3, 3> static_matrix({...});
  * mtlt::matrix<int> matrix(3, 3, static_matrix); // OK
  *
+ * mtlt::matrix<float> matrix(3, 3); // matrix.data() is 64 byte aligned
+ * mtlt::matrix<float, std::allocator<float>> matrix(3, 3); // OK, storage of std::allocator
+ *
+ * mtlt::matrix<double, mtlt::aligned_allocator<double>, mtlt::column_major> matrix(3, 3); // OK, columns are contiguous
+ *
  * @endcode
  *
+ * All the storage is allocated by Allocator, the default one
+ * aligns the items of fundamental types to a cache line.
+ * Layout places the items in the storage (see matrix_layout.h), the iterators,
+ * the constructors from lists and containers and to_vector() use row major
+ * order for every layout, data() and adopt() use the order of the storage
  */
-template<typename T>
+template<typename T, typename Allocator = default_allocator<T>, typename Layout = row_major>
 class matrix;
 
 /**
@@ -94,118 +110,279 @@ using fundamental_matrix = typename std::conditional<!std::is_fundamental<T>::va
 													 detail::incomplete_compile_error_generation_type,
 													 matrix<T>>::type;
 
-template<typename T>
+template<typename T, typename Allocator, typename Layout>
 class matrix final {
+  using allocator_traits = std::allocator_traits<Allocator>;
+  static_assert(std::is_same<typename allocator_traits::value_type, T>::value,
+				"Allocator must allocate items of type T");
+  using layout_iterators = detail::layout_iterators<typename allocator_traits::pointer, Layout>;
+  using const_layout_iterators = detail::layout_iterators<typename allocator_traits::const_pointer, Layout>;
+
 public:
-  using value_type = typename std::allocator_traits<std::allocator<T>>::value_type;
-  using pointer = typename std::allocator_traits<std::allocator<T>>::pointer;
-  using const_pointer = typename std::allocator_traits<std::allocator<T>>::const_pointer;
-  using size_type = typename std::allocator_traits<std::allocator<T>>::size_type;
+  using allocator_type = Allocator;
+  using layout_type = Layout;
+  using value_type = typename allocator_traits::value_type;
+  using pointer = typename allocator_traits::pointer;
+  using const_pointer = typename allocator_traits::const_pointer;
+  using size_type = typename allocator_traits::size_type;
   using reference = value_type &;
   using const_reference = const value_type &;
-  using iterator = matrix_normal_iterator<pointer>;
-  using const_iterator = matrix_normal_iterator<const_pointer>;
-  using reverse_iterator = matrix_reverse_iterator<iterator>;
-  using const_reverse_iterator = matrix_reverse_iterator<const_iterator>;
+  using iterator = typename layout_iterators::iterator;
+  using const_iterator = typename const_layout_iterators::iterator;
+  using reverse_iterator = typename layout_iterators::reverse_iterator;
+  using const_reverse_iterator = typename const_layout_iterators::reverse_iterator;
 
 public:
   MATRIX_CXX17_CONSTEXPR matrix() noexcept = default;
 
-  MATRIX_CXX17_CONSTEXPR matrix(size_type rows, size_type cols, value_type f = {})
-	  : rows_(rows), cols_(cols), data_(new value_type[rows * cols]{}) {
-	if (f != value_type{})
-	  fill(f);
-  }
+  MATRIX_CXX17_CONSTEXPR explicit matrix(const allocator_type &allocator) noexcept
+	  : allocator_(allocator) {}
+
+  /**
+   * Every item is copy constructed from f in one pass over the storage
+   */
+  MATRIX_CXX17_CONSTEXPR matrix(size_type rows, size_type cols, value_type f = {},
+								const allocator_type &allocator = allocator_type())
+	  : allocator_(allocator), rows_(rows), cols_(cols), data_(allocate(rows * cols, f)) {}
+
+  /**
+   * The items of trivial types are left uninitialized, the cost
+   * doesn't depend on the size until the storage is written
+   *
+   * @code
+   *
+   * mtlt::matrix<float> noise(50000, 50000, mtlt::uninitialized);
+   * noise.fill_random(-1.0f, 1.0f);
+   *
+   * @endcode
+   */
+  MATRIX_CXX17_CONSTEXPR matrix(size_type rows, size_type cols, uninitialized_t,
+								const allocator_type &allocator = allocator_type())
+	  : allocator_(allocator), rows_(rows), cols_(cols),
+		data_(allocate_uninitialized(rows * cols, std::is_trivially_default_constructible<value_type>())) {}
 
   MATRIX_CXX17_CONSTEXPR explicit matrix(size_type square) : matrix(square, square) {};
 
-  MATRIX_CXX17_CONSTEXPR explicit matrix(const std::vector<std::vector<value_type>> &matrix_vector)
-	  : matrix(matrix_vector.size(), matrix_vector[0].size()) {
+  MATRIX_CXX17_CONSTEXPR explicit matrix(const std::vector<std::vector<value_type>> &matrix_vector,
+										 const allocator_type &allocator = allocator_type())
+	  : matrix(matrix_vector.size(), matrix_vector[0].size(), value_type{}, allocator) {
 	for (size_type row = 0; row != rows_; ++row)
 	  for (size_type col = 0; col != cols_; ++col)
 		(*this)(row, col) = matrix_vector[row][col];
   }
 
-  MATRIX_CXX20_CONSTEXPR matrix(size_type rows, size_type cols, const std::initializer_list<T> &initializer)
-	  : matrix(rows, cols) {
+  MATRIX_CXX20_CONSTEXPR matrix(size_type rows, size_type cols, const std::initializer_list<T> &initializer,
+								const allocator_type &allocator = allocator_type())
+	  : matrix(rows, cols, value_type{}, allocator) {
 	std::copy(initializer.begin(), initializer.end(), begin());
   }
 
 #if __cplusplus > 201703L
   template<typename Container> requires(std::convertible_to<typename Container::value_type, T>)
-  MATRIX_CXX17_CONSTEXPR matrix(size_type rows, size_type cols, const Container &container)
-	  : matrix(rows, cols) {
+  MATRIX_CXX17_CONSTEXPR matrix(size_type rows, size_type cols, const Container &container,
+								const allocator_type &allocator = allocator_type())
+	  : matrix(rows, cols, value_type{}, allocator) {
 #else
   template<typename Container,
 	  typename std::enable_if<
 		  std::is_convertible<typename Container::value_type, value_type>::value, bool>::type = true>
-  MATRIX_CXX20_CONSTEXPR matrix(size_type rows, size_type cols, const Container &container)
-	  : matrix(rows, cols) {
+  MATRIX_CXX20_CONSTEXPR matrix(size_type rows, size_type cols, const Container &container,
+								const allocator_type &allocator = allocator_type())
+	  : matrix(rows, cols, value_type{}, allocator) {
 #endif // C++ <= 201703L
 	std::copy(container.begin(), container.end(), begin());
   }
 
-  static matrix identity(size_type rows, size_type cols) {
-	matrix identity(rows, cols);
+  static matrix identity(size_type rows, size_type cols, const allocator_type &allocator = allocator_type()) {
+	matrix identity(rows, cols, value_type{}, allocator);
 	identity.to_identity();
 	return identity;
   }
 
   MATRIX_CXX17_CONSTEXPR matrix(const matrix &other)
-	  : matrix(other.rows_, other.cols_) {
-	std::copy(other.begin(), other.end(), begin());
+	  : matrix(other, allocator_traits::select_on_container_copy_construction(other.allocator_)) {}
+
+  MATRIX_CXX17_CONSTEXPR matrix(const matrix &other, const allocator_type &allocator)
+	  : matrix(other.rows_, other.cols_, uninitialized, allocator) {
+	std::copy(other.data_, other.data_ + other.size(), data_);
+  }
+
+  /**
+   * Copy of a matrix of other layout or allocator, the items are
+   * moved between the layouts in square blocks
+   *
+   * @code
+   *
+   * mtlt::matrix<double> a(4096, 4096);
+   * mtlt::matrix<double, mtlt::aligned_allocator<double>, mtlt::column_major> columns(a);
+   *
+   * @endcode
+   */
+  template<typename OtherAllocator, typename OtherLayout>
+  MATRIX_CXX17_CONSTEXPR explicit matrix(const matrix<value_type, OtherAllocator, OtherLayout> &other,
+										 const allocator_type &allocator = allocator_type())
+	  : matrix(other.rows(), other.cols(), uninitialized, allocator) {
+	detail::copy_blocked(other, *this);
   }
 
   MATRIX_CXX17_CONSTEXPR matrix(matrix &&other) noexcept
-	  : rows_(other.rows_), cols_(other.cols_), data_(other.data_) {
+	  : allocator_(std::move(other.allocator_)), external_(std::move(other.external_)),
+		rows_(other.rows_), cols_(other.cols_), data_(other.data_) {
 	other.rows_ = other.cols_ = size_type{};
 	other.data_ = nullptr;
   }
 
+  /**
+   * The allocator of other is taken only if it propagates on copy assignment,
+   * the storage is reused when the sizes are equal
+   */
   MATRIX_CXX17_CONSTEXPR matrix &operator=(const matrix &other) {
 	if (&other == this)
 	  return *this;
 
-	matrix tmp(other);
-	*this = std::move(tmp);
+	if (allocator_traits::propagate_on_container_copy_assignment::value && allocator_ != other.allocator_)
+	  clear();
+	if (allocator_traits::propagate_on_container_copy_assignment::value)
+	  allocator_ = other.allocator_;
 
+	if (!external_ && data_ != nullptr && size() == other.size()) {
+	  std::copy(other.data_, other.data_ + other.size(), data_);
+	  rows_ = other.rows_;
+	  cols_ = other.cols_;
+	  return *this;
+	}
+
+	matrix tmp(other, allocator_);
+	take_storage(tmp);
 	return *this;
   }
 
-  MATRIX_CXX17_CONSTEXPR matrix &operator=(matrix &&other) noexcept {
+  /**
+   * The storage of other is taken if the allocator propagates on move
+   * assignment or the allocators are equal, otherwise the items are moved
+   * one by one to the storage of this allocator
+   */
+  MATRIX_CXX17_CONSTEXPR matrix &operator=(matrix &&other) noexcept(detail::allocator_move_steals<Allocator>::value) {
 	if (&other == this)
 	  return *this;
 
-	std::swap(rows_, other.rows_);
-	std::swap(cols_, other.cols_);
-	std::swap(data_, other.data_);
+	if (allocator_traits::propagate_on_container_move_assignment::value) {
+	  clear();
+	  allocator_ = std::move(other.allocator_);
+	  take_storage(other);
+	} else if (allocator_ == other.allocator_ || other.external_) {
+	  take_storage(other);
+	} else if (!external_ && data_ != nullptr && size() == other.size()) {
+	  std::move(other.data_, other.data_ + other.size(), data_);
+	  rows_ = other.rows_;
+	  cols_ = other.cols_;
+	} else {
+	  matrix tmp(other.rows_, other.cols_, uninitialized, allocator_);
+	  std::move(other.data_, other.data_ + other.size(), tmp.data_);
+	  take_storage(tmp);
+	}
 
 	return *this;
   }
 
+  /**
+   * The allocators are swapped only if they propagate on swap,
+   * otherwise they must be equal, as for the standard containers
+   */
+  void swap(matrix &other) noexcept {
+	using std::swap;
+	if (allocator_traits::propagate_on_container_swap::value)
+	  swap(allocator_, other.allocator_);
+
+	swap(external_, other.external_);
+	swap(rows_, other.rows_);
+	swap(cols_, other.cols_);
+	swap(data_, other.data_);
+  }
+
   ~matrix() noexcept {
-	delete[] data_;
+	if (!external_)
+	  deallocate(data_, rows_ * cols_);
+  }
+
+  allocator_type get_allocator() const noexcept { return allocator_; }
+
+  /**
+   * Takes the ownership of rows x cols constructed items without copying them,
+   * deleter(data) is called instead of the allocator when the storage is released:
+   * by the destructor, clear(), resize() or the assignment of other storage.
+   * Copies of the matrix allocate their own storage
+   *
+   * @code
+   *
+   * float *mapped = static_cast<float *>(mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+   * auto m = mtlt::matrix<float>::adopt(mapped, rows, cols, [bytes](float *p) { munmap(p, bytes); });
+   *
+   * std::shared_ptr<arrow::Buffer> buffer = ...;
+   * auto batch = mtlt::matrix<double>::adopt(buffer->mutable_data_as<double>(), rows, cols,
+   *                                          [buffer](double *) {}); // Keeps the buffer alive
+   *
+   * @endcode
+   */
+  template<typename Deleter>
+  static matrix adopt(pointer data, size_type rows, size_type cols, Deleter deleter,
+					  const allocator_type &allocator = allocator_type()) {
+	matrix adopted(allocator);
+	adopted.external_ = std::shared_ptr<value_type>(data, std::move(deleter));
+	adopted.rows_ = rows;
+	adopted.cols_ = cols;
+	adopted.data_ = data;
+	return adopted;
+  }
+
+  /**
+   * Moves the buffer of the vector into the matrix, items.size() must be rows * cols
+   */
+  template<typename VectorAllocator>
+  static matrix adopt(std::vector<value_type, VectorAllocator> &&items, size_type rows, size_type cols,
+					  const allocator_type &allocator = allocator_type()) {
+	if (items.size() != rows * cols)
+	  throw std::logic_error("Can't adopt vector because items.size() != rows * cols");
+
+	std::shared_ptr<std::vector<value_type, VectorAllocator>> owner =
+		std::make_shared<std::vector<value_type, VectorAllocator>>(std::move(items));
+
+	matrix adopted(allocator);
+	adopted.rows_ = rows;
+	adopted.cols_ = cols;
+	adopted.data_ = owner->data();
+	adopted.external_ = std::move(owner);
+	return adopted;
+  }
+
+  /**
+   * Refers to rows x cols items owned by the caller, they are never released
+   * by the matrix and must outlive it. matrix_view is the lighter alternative
+   */
+  static matrix borrow(pointer data, size_type rows, size_type cols,
+					   const allocator_type &allocator = allocator_type()) {
+	return adopt(data, rows, cols, [](pointer) {}, allocator);
   }
 
 public:
   MATRIX_CXX17_CONSTEXPR
   iterator begin() noexcept {
-	return iterator(data_);
+	return layout_iterators::make(data_, rows_, cols_, 0);
   }
 
   MATRIX_CXX17_CONSTEXPR
   const_iterator begin() const noexcept {
-	return const_iterator(data_);
+	return const_layout_iterators::make(data_, rows_, cols_, 0);
   }
 
   MATRIX_CXX17_CONSTEXPR
   reverse_iterator rbegin() noexcept {
-	return reverse_iterator(data_ + rows_ * cols_ - 1);
+	return layout_iterators::make_reverse(data_, rows_, cols_, rows_ * cols_);
   }
 
   MATRIX_CXX17_CONSTEXPR
   const_reverse_iterator rbegin() const noexcept {
-	return const_reverse_iterator(data_ + rows_ * cols_ - 1);
+	return const_layout_iterators::make_reverse(data_, rows_, cols_, rows_ * cols_);
   }
 
   MATRIX_CXX17_CONSTEXPR
@@ -220,22 +397,22 @@ public:
 
   MATRIX_CXX17_CONSTEXPR
   iterator end() noexcept {
-	return iterator(data_ + rows_ * cols_);
+	return layout_iterators::make(data_, rows_, cols_, rows_ * cols_);
   }
 
   MATRIX_CXX17_CONSTEXPR
   const_iterator end() const noexcept {
-	return const_iterator(data_ + rows_ * cols_);
+	return const_layout_iterators::make(data_, rows_, cols_, rows_ * cols_);
   }
 
   MATRIX_CXX17_CONSTEXPR
   reverse_iterator rend() noexcept {
-	return reverse_iterator(data_ - 1);
+	return layout_iterators::make_reverse(data_, rows_, cols_, 0);
   }
 
   MATRIX_CXX17_CONSTEXPR
   const_reverse_iterator rend() const noexcept {
-	return const_reverse_iterator(data_ - 1);
+	return const_layout_iterators::make_reverse(data_, rows_, cols_, 0);
   }
 
   MATRIX_CXX17_CONSTEXPR
@@ -250,11 +427,11 @@ public:
 
 public:
   reference operator()(size_type row, size_type col) {
-	return data_[row * cols_ + col];
+	return data_[Layout::index(row, col, rows_, cols_)];
   }
 
   const_reference operator()(size_type row, size_type col) const {
-	return data_[row * cols_ + col];
+	return data_[Layout::index(row, col, rows_, cols_)];
   }
 
   reference at(size_type row, size_type col) {
@@ -280,11 +457,15 @@ public:
   MATRIX_CXX17_NODISCARD
   size_type size() const noexcept { return rows_ * cols_; }
 
+  pointer data() noexcept { return data_; }
+
+  const_pointer data() const noexcept { return data_; }
+
   void rows(size_type rows) {
 	if (rows_ == rows)
 	  return;
 
-	matrix tmp(rows, cols_);
+	matrix tmp(rows, cols_, value_type{}, allocator_);
 	const size_type min_rows = std::min(rows, rows_);
 
 	for (size_type row = 0; row != min_rows; ++row)
@@ -298,7 +479,7 @@ public:
 	if (cols_ == cols)
 	  return;
 
-	matrix tmp(rows_, cols);
+	matrix tmp(rows_, cols, value_type{}, allocator_);
 	const size_type min_cols = std::min(cols, cols_);
 
 	for (size_type row = 0; row != rows_; ++row)
@@ -311,7 +492,7 @@ public:
 	if (cols_ == cols && rows_ == rows)
 	  return;
 
-	matrix tmp(rows, cols);
+	matrix tmp(rows, cols, value_type{}, allocator_);
 	const size_type min_cols = std::min(cols, cols_);
 	const size_type min_rows = std::min(rows, rows_);
 
@@ -323,8 +504,11 @@ public:
   }
 
   void clear() noexcept {
+	if (external_)
+	  external_.reset();
+	else
+	  deallocate(data_, rows_ * cols_);
 	rows_ = cols_ = size_type{};
-	delete[] data_;
 	data_ = nullptr;
   }
 
@@ -349,14 +533,21 @@ public:
   }
 
 public:
+  /**
+   * The items are visited in the order of the storage
+   */
   template<typename UnaryOperation>
   void transform(UnaryOperation &&op) {
-	std::transform(begin(), end(), begin(), std::forward<UnaryOperation>(op));
+	std::transform(data_, data_ + size(), data_, std::forward<UnaryOperation>(op));
   }
 
-  template<typename BinaryOperation>
-  void transform(const matrix &other, BinaryOperation &&op) {
-	std::transform(begin(), end(), other.begin(), begin(), std::forward<BinaryOperation>(op));
+  /**
+   * Operands of the same layout are zipped in the order of the storage,
+   * the others item by item
+   */
+  template<typename U, typename OtherAllocator, typename OtherLayout, typename BinaryOperation>
+  void transform(const matrix<U, OtherAllocator, OtherLayout> &other, BinaryOperation &&op) {
+	transform(other, std::forward<BinaryOperation>(op), std::is_same<Layout, OtherLayout>());
   }
 
   template<typename Operation>
@@ -370,11 +561,11 @@ public:
   }
 
 #if __cplusplus > 201703L
-  template<typename U> requires(std::convertible_to<U, T>)
-  matrix &mul(const matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator, typename OtherLayout> requires(std::convertible_to<U, T>)
+  matrix &mul(const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 #else
-  template<typename U>
-  matrix &mul(const matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator, typename OtherLayout>
+  matrix &mul(const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 	static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
 	if (cols_ != rhs.rows())
@@ -383,22 +574,19 @@ public:
 	const size_type cols = rhs.cols();
 	const size_type rows = rows_;
 
-	matrix multiplied(rows, cols);
-	for (size_type row = 0; row != rows; ++row)
-	  for (size_type col = 0; col != cols; ++col)
-		for (size_type k = 0; k != cols_; ++k)
-		  multiplied(row, col) += (*this)(row, k) * rhs(k, col);
+	matrix multiplied(rows, cols, value_type{}, allocator_);
+	multiply(rhs, multiplied, detail::is_gemm_compatible<T, U>());
 
 	*this = std::move(multiplied);
 	return *this;
   }
 
 #if __cplusplus > 201703L
-  template<typename U> requires(std::convertible_to<U, T>)
-  matrix &mul_by_element(const matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator, typename OtherLayout> requires(std::convertible_to<U, T>)
+  matrix &mul_by_element(const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 #else
-  template<typename U>
-  matrix &mul_by_element(const matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator, typename OtherLayout>
+  matrix &mul_by_element(const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 	static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
 	if (rows_ != rhs.rows() or cols_ != rhs.cols())
@@ -425,11 +613,11 @@ public:
   }
 
 #if __cplusplus > 201703L
-  template<typename U> requires(std::convertible_to<U, T>)
-  matrix &add(const matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator, typename OtherLayout> requires(std::convertible_to<U, T>)
+  matrix &add(const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 #else
-  template<typename U>
-  matrix &add(const matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator, typename OtherLayout>
+  matrix &add(const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 	static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
 	if (rhs.rows() != rows_ || rhs.cols() != cols_)
@@ -445,11 +633,11 @@ public:
   }
 
 #if __cplusplus > 201703L
-  template<typename U> requires(std::convertible_to<U, T>)
-  matrix &sub(const matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator, typename OtherLayout> requires(std::convertible_to<U, T>)
+  matrix &sub(const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 #else
-  template<typename U>
-  matrix &sub(const matrix<U> &rhs) {
+  template<typename U, typename OtherAllocator, typename OtherLayout>
+  matrix &sub(const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 	static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
 	if (rhs.rows() != rows_ || rhs.cols() != cols_)
@@ -460,7 +648,7 @@ public:
   }
 
   matrix &fill(const value_type &number) {
-	generate([&number]() { return number; });
+	std::fill(data_, data_ + size(), number);
 
 	return *this;
   }
@@ -486,7 +674,7 @@ public:
   }
 
   matrix round() const {
-	matrix<T> rounded(*this);
+	matrix rounded(*this);
 	rounded.transform([](const value_type &item) { return std::round(item); });
 	return rounded;
   }
@@ -497,7 +685,7 @@ public:
   }
 
   matrix floor() const {
-	matrix<T> floored(*this);
+	matrix floored(*this);
 	floored.transform([](const value_type &item) { return std::floor(item); });
 	return floored;
   }
@@ -508,18 +696,17 @@ public:
   }
 
   matrix ceil() const {
-	matrix<T> ceiled(*this);
+	matrix ceiled(*this);
 	ceiled.transform([](const value_type &item) { return std::ceil(item); });
 	return ceiled;
   }
 
   matrix &to_zero() {
-	generate([]() { return value_type{}; });
-	return *this;
+	return fill(value_type{});
   }
 
   matrix zero() const {
-	return matrix<T>(rows_, cols_);
+	return matrix(rows_, cols_, value_type{}, allocator_);
   }
 
   matrix &to_identity() {
@@ -534,7 +721,7 @@ public:
   }
 
   value_type sum() const {
-	return std::accumulate(begin(), end(), value_type{});
+	return std::accumulate(data_, data_ + size(), value_type{});
   }
 
 public:
@@ -549,7 +736,7 @@ public:
 	if (rhs.rows() != rows_)
 	  throw std::logic_error("Can't join left rhs matrix to lhs, because lhs.rows() != rhs.rows()");
 
-	matrix<T> join_matrix(rows_, cols_ + rhs.cols());
+	matrix join_matrix(rows_, cols_ + rhs.cols(), value_type{}, allocator_);
 
 	size_type cols2 = rhs.cols();
 
@@ -583,7 +770,7 @@ public:
 	if (rhs.rows() != rows_)
 	  throw std::logic_error("Can't join right rhs matrix to lhs, because lhs.rows() != rhs.rows()");
 
-	matrix<T> join_matrix(rows_, cols_ + rhs.cols());
+	matrix join_matrix(rows_, cols_ + rhs.cols(), value_type{}, allocator_);
 	size_type cols2 = rhs.cols();
 
 	for (size_type row = 0; row != join_matrix.rows(); ++row)
@@ -610,7 +797,7 @@ public:
 
 	size_type old_rows = rows_;
 	size_type rows2 = rhs.rows();
-	matrix<T> join_matrix(rows_ + rhs.rows(), cols_);
+	matrix join_matrix(rows_ + rhs.rows(), cols_, value_type{}, allocator_);
 
 	for (size_type row = 0; row != join_matrix.rows(); ++row)
 	  for (size_type col = 0; col != join_matrix.cols(); ++col) {
@@ -642,7 +829,7 @@ public:
 	if (rhs.rows() != rows_)
 	  throw std::logic_error("Can't join bottom rhs matrix to lhs, because lhs.cols() != rhs.cols()");
 
-	matrix<T> join_matrix(rows_ + rhs.rows(), cols_);
+	matrix join_matrix(rows_ + rhs.rows(), cols_, value_type{}, allocator_);
 	size_type rows2 = rhs.rows();
 
 	for (size_type row = 0; row != join_matrix.rows(); ++row)
@@ -658,17 +845,13 @@ public:
 
 public:
   matrix transpose() const {
-	matrix transposed(cols_, rows_);
-
-	for (size_type row = 0; row != rows_; ++row)
-	  for (size_type col = 0; col != cols_; ++col)
-		transposed(col, row) = (*this)(row, col);
-
+	matrix transposed(cols_, rows_, uninitialized, allocator_);
+	detail::copy_blocked(*this, transposed, true);
 	return transposed;
   }
 
   matrix minor(size_type row, size_type col) const {
-	matrix minor(rows() - 1, cols() - 1);
+	matrix minor(rows() - 1, cols() - 1, value_type{}, allocator_);
 
 	size_type skip_row = 0, skip_col = 0;
 	for (size_type r = 0; r != minor.rows_; ++r) {
@@ -695,66 +878,58 @@ public:
 	if (rows_ != cols_)
 	  throw std::logic_error("determinant_gaussian can be found only for square matrices");
 
-	double determinant_value = 1;
+	matrix<double> factors(rows_, cols_, *this);
+	std::vector<size_type> pivots(rows_);
 
-	matrix<double> matrix(rows_, cols_, *this);
-	const size_type kN = matrix.rows();
+	if (!detail::lu_factor(rows_, cols_, factors.data(), cols_, pivots.data()))
+	  return 0.0;
 
-	for (size_type i = 0; i != kN; ++i) {
-	  double pivot = matrix(i, i);
-	  size_type pivot_row = i;
-	  for (size_type row = i + 1; row != kN; ++row) {
-		double row_i_item = matrix(row, i);
-		row_i_item = row_i_item < 0 ? -row_i_item : row_i_item;
-		double temp_pivot = pivot < 0 ? -pivot : pivot;
-
-		if (row_i_item > temp_pivot) {
-		  pivot = matrix(row, i);
-		  pivot_row = row;
-		}
-	  }
-
-	  if (pivot == value_type{}) {
-		return value_type{};
-	  }
-
-	  if (pivot_row != i) {
-		matrix.swap_rows(i, pivot_row);
-		determinant_value = -determinant_value;
-	  }
-
-	  determinant_value *= pivot;
-
-	  for (size_type row = i + 1; row != kN; ++row) {
-		for (size_type col = i + 1; col != kN; ++col) {
-		  matrix(row, col) -= matrix(row, i) * matrix(i, col) / pivot;
-		}
-	  }
-	}
-
-	return determinant_value;
+	return detail::lu_determinant(rows_, factors.data(), cols_, pivots.data());
   }
 
+  /**
+   * Cofactor expansion along the first row, O(n!) without allocations.
+   * It is an explicit opt-in for tiny matrices, throws above
+   * detail::cofactor_max_size rows
+   */
   double determinant_laplacian() const {
 	if (rows_ != cols_)
 	  throw std::logic_error("determinant_laplacian can be found only for square matrices");
+	if (rows_ > detail::cofactor_max_size)
+	  throw std::logic_error("determinant_laplacian is O(n!), use determinant_gaussian or determinant_bareiss");
+
+	size_type columns[detail::cofactor_max_size] = {};
+	for (size_type col = 0; col != cols_; ++col)
+	  columns[col] = col;
+
+	return detail::cofactor_determinant(*this, 0, columns, cols_);
+  }
+
+  /**
+   * Exact determinant of an integral matrix by fraction-free Bareiss
+   * elimination in O(n^3). The products are taken in a twice wider integer,
+   * the result is exact while the minors of the matrix fit in T
+   *
+   * @code
+   *
+   * mtlt::matrix<long long> a(3, 3, {2, -3, 1, 2, 0, -1, 1, 4, 5});
+   * long long determinant = a.determinant_bareiss(); // 49
+   *
+   * @endcode
+   */
+#if __cplusplus > 201703L
+  value_type determinant_bareiss() const requires (std::integral<T>) {
+#else
+  value_type determinant_bareiss() const {
+	static_assert(std::is_integral<T>::value, "T must be integral type");
+#endif
+	if (rows_ != cols_)
+	  throw std::logic_error("determinant_bareiss can be found only for square matrices");
 
-	int sign = 1;
-	double determinant_value{};
-
-	if (rows_ == 1 && cols_ == 1)
-	  determinant_value = (*this)(0, 0);
-	else if (rows_ == 2 && cols_ == 2)
-	  determinant_value = ((*this)(0, 0) * (*this)(1, 1)) - ((*this)(1, 0) * (*this)(0, 1));
-	else {
-	  for (size_type col = 0; col != cols_; ++col) {
-		matrix minored = minor(0, col);
-		determinant_value += sign * (*this)(0, col) * minored.determinant_laplacian();
-		sign = -sign;
-	  }
-	}
+	using wide_type = typename detail::bareiss_type<T>::type;
+	std::vector<wide_type> factors(begin(), end());
 
-	return determinant_value;
+	return static_cast<value_type>(detail::bareiss_determinant(rows_, factors.data()));
   }
 
   value_type trace() const {
@@ -771,7 +946,7 @@ public:
 	if (rows_ != cols_)
 	  throw std::logic_error("Complements matrix can be found only for square matrices");
 
-	matrix<T> complements(rows_, cols_);
+	matrix complements(rows_, cols_, value_type{}, allocator_);
 
 	for (size_type row = 0; row != rows_; ++row) {
 	  for (size_type col = 0; col != cols_; ++col) {
@@ -785,27 +960,48 @@ public:
 	return complements;
   }
 
+  /**
+   * The inverse is found by solving A * X = I with the LU factorization,
+   * throws if a pivot is negligible next to the largest item of U,
+   * the same as mtlt::lu::inverse()
+   */
   matrix inverse() const {
-	double determinant = determinant_gaussian();
+	if (rows_ != cols_)
+	  throw std::logic_error("Inverse matrix can be found only for square matrices");
 
-	if (std::fabs(determinant) <= 1e-6)
+	matrix<double> factors(rows_, cols_, *this);
+	std::vector<size_type> pivots(rows_);
+	detail::lu_factor(rows_, cols_, factors.data(), cols_, pivots.data());
+
+	if (detail::lu_negligible_pivot(rows_, factors.data(), cols_))
 	  throw std::logic_error("Can't found inverse matrix because determinant is zero");
 
-	return calc_complements().transpose().mul(1 / determinant);
+	return inverse_from_lu(factors, pivots);
   }
 
+  /**
+   * The caller's determinant is compared with the absolute threshold 1e-6
+   */
   matrix inverse(double determinant) const {
+	if (rows_ != cols_)
+	  throw std::logic_error("Inverse matrix can be found only for square matrices");
+
 	if (std::fabs(determinant) <= 1e-6)
 	  throw std::logic_error("Can't found inverse matrix because determinant is zero");
 
-	return calc_complements().transpose().mul(1 / determinant);
+	matrix<double> factors(rows_, cols_, *this);
+	std::vector<size_type> pivots(rows_);
+	detail::lu_factor(rows_, cols_, factors.data(), cols_, pivots.data());
+
+	return inverse_from_lu(factors, pivots);
   }
 
   void swap_rows(size_type row1, size_type row2) {
 	if (row1 >= rows_ || row2 >= rows_)
 	  throw std::logic_error("row1 or row2 is bigger that this->rows()");
 
-	std::swap_ranges(begin() + row1 * cols_, begin() + row1 * cols_ + cols_, begin() + row2 * cols_);
+	for (size_type col = 0; col != cols_; ++col)
+	  std::swap((*this)(row1, col), (*this)(row2, col));
   }
 
   void swap_cols(size_type col1, size_type col2) {
@@ -817,8 +1013,11 @@ public:
   }
 
 public:
-  template<typename EqualCompare = std::equal_to<value_type>>
-  bool equal_to(const matrix &rhs) const {
+  /**
+   * Compares item by item, so rhs may have other allocator and layout
+   */
+  template<typename EqualCompare = std::equal_to<value_type>, typename OtherAllocator, typename OtherLayout>
+  bool equal_to(const matrix<value_type, OtherAllocator, OtherLayout> &rhs) const {
 	if (rows_ != rhs.rows() || cols_ != rhs.cols())
 	  return false;
 
@@ -835,14 +1034,14 @@ public:
 
 #if __cplusplus > 201703L
   template<typename U> requires (std::convertible_to<U, T>)
-  matrix<U> convert_to() const {
+  matrix<U, default_allocator<U>, Layout> convert_to() const {
 #else
   template<typename U>
-  matrix<U> convert_to() const {
+  matrix<U, default_allocator<U>, Layout> convert_to() const {
 	static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-	matrix<U> convert(rows_, cols_);
-	std::copy(begin(), end(), convert.begin());
+	matrix<U, default_allocator<U>, Layout> convert(rows_, cols_, uninitialized);
+	std::copy(data_, data_ + size(), convert.data());
 	return convert;
   }
 
@@ -877,22 +1076,122 @@ public:
   }
 
 private:
+  template<typename U, typename OtherAllocator, typename OtherLayout>
+  void multiply(const matrix<U, OtherAllocator, OtherLayout> &rhs, matrix &multiplied, std::true_type) const {
+	detail::gemm_layout(rows_, rhs.cols(), cols_, *this, false, rhs, false,
+						multiplied.data_, value_type(1), Layout());
+  }
+
+  template<typename U, typename OtherAllocator, typename OtherLayout>
+  void multiply(const matrix<U, OtherAllocator, OtherLayout> &rhs, matrix &multiplied, std::false_type) const {
+	for (size_type row = 0; row != multiplied.rows_; ++row)
+	  for (size_type col = 0; col != multiplied.cols_; ++col)
+		for (size_type k = 0; k != cols_; ++k)
+		  multiplied(row, col) += (*this)(row, k) * rhs(k, col);
+  }
+
+  template<typename U, typename OtherAllocator, typename BinaryOperation>
+  void transform(const matrix<U, OtherAllocator, Layout> &other, BinaryOperation &&op, std::true_type) {
+	std::transform(data_, data_ + size(), other.data(), data_, std::forward<BinaryOperation>(op));
+  }
+
+  template<typename U, typename OtherAllocator, typename OtherLayout, typename BinaryOperation>
+  void transform(const matrix<U, OtherAllocator, OtherLayout> &other, BinaryOperation &&op, std::false_type) {
+	for (size_type row = 0; row != rows_; ++row)
+	  for (size_type col = 0; col != cols_; ++col)
+		(*this)(row, col) = op((*this)(row, col), other(row, col));
+  }
+
+  matrix inverse_from_lu(const matrix<double> &factors, const std::vector<size_type> &pivots) const {
+	matrix<double> inverted = matrix<double>::identity(rows_, cols_);
+	detail::lu_solve(rows_, factors.data(), cols_, pivots.data(), cols_, inverted.data(), cols_);
+	return matrix(rows_, cols_, inverted, allocator_);
+  }
+
+  /**
+   * Releases the storage of this matrix and takes the storage of other,
+   * which must be released by the allocator of this matrix or be external
+   */
+  void take_storage(matrix &other) noexcept {
+	clear();
+	external_ = std::move(other.external_);
+	rows_ = other.rows_;
+	cols_ = other.cols_;
+	data_ = other.data_;
+
+	other.rows_ = other.cols_ = size_type{};
+	other.data_ = nullptr;
+  }
+
+  /**
+   * Storage of n items constructed from args, the constructed
+   * items are destroyed if one of the constructors throws
+   */
+  template<typename ...Args>
+  pointer allocate(size_type n, const Args &...args) {
+	if (n == 0)
+	  return nullptr;
+
+	pointer storage = allocator_traits::allocate(allocator_, n);
+	size_type constructed = 0;
+
+	try {
+	  for (; constructed != n; ++constructed)
+		allocator_traits::construct(allocator_, storage + constructed, args...);
+	} catch (...) {
+	  destroy(storage, constructed);
+	  allocator_traits::deallocate(allocator_, storage, n);
+	  throw;
+	}
+
+	return storage;
+  }
+
+  pointer allocate_uninitialized(size_type n, std::true_type) {
+	return n == 0 ? nullptr : allocator_traits::allocate(allocator_, n);
+  }
+
+  pointer allocate_uninitialized(size_type n, std::false_type) {
+	return allocate(n);
+  }
+
+  void destroy(pointer storage, size_type n) noexcept {
+	for (size_type i = 0; i != n; ++i)
+	  allocator_traits::destroy(allocator_, storage + i);
+  }
+
+  void deallocate(pointer storage, size_type n) noexcept {
+	if (storage == nullptr)
+	  return;
+
+	destroy(storage, n);
+	allocator_traits::deallocate(allocator_, storage, n);
+  }
+
+private:
+  allocator_type allocator_{};
+  std::shared_ptr<void> external_;
   size_type rows_{}, cols_{};
   pointer data_ = nullptr;
 };
 
-template<typename T>
-std::ostream &operator<<(std::ostream &out, const matrix<T> &rhs) {
+template<typename T, typename Allocator, typename Layout>
+std::ostream &operator<<(std::ostream &out, const matrix<T, Allocator, Layout> &rhs) {
   rhs.print(out);
   return out;
 }
 
+template<typename T, typename Allocator, typename Layout>
+void inline swap(matrix<T, Allocator, Layout> &lhs, matrix<T, Allocator, Layout> &rhs) noexcept {
+  lhs.swap(rhs);
+}
+
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline &operator+=(matrix<T> &lhs, const matrix<U> &rhs) {
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline &operator+=(matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 #else
-template<typename T, typename U>
-matrix<T> inline &operator+=(matrix<T> &lhs, const matrix<U> &rhs) {
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+matrix<T, Allocator, Layout> inline &operator+=(matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.add(rhs);
@@ -900,11 +1199,11 @@ matrix<T> inline &operator+=(matrix<T> &lhs, const matrix<U> &rhs) {
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline &operator-=(matrix<T> &lhs, const matrix<U> &rhs) {
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline &operator-=(matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 #else
-template<typename T, typename U>
-matrix<T> inline &operator-=(matrix<T> &lhs, const matrix<U> &rhs) {
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+matrix<T, Allocator, Layout> inline &operator-=(matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.sub(rhs);
@@ -912,11 +1211,11 @@ matrix<T> inline &operator-=(matrix<T> &lhs, const matrix<U> &rhs) {
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline &operator*=(matrix<T> &lhs, const matrix<U> &rhs) {
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline &operator*=(matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 #else
-template<typename T, typename U>
-matrix<T> inline &operator*=(matrix<T> &lhs, const matrix<U> &rhs) {
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+matrix<T, Allocator, Layout> inline &operator*=(matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.mul(rhs);
@@ -924,11 +1223,11 @@ matrix<T> inline &operator*=(matrix<T> &lhs, const matrix<U> &rhs) {
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline &operator+=(matrix<T> &lhs, const U &value) {
+template<typename T, typename U, typename Allocator, typename Layout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline &operator+=(matrix<T, Allocator, Layout> &lhs, const U &value) {
 #else
-template<typename T, typename U>
-matrix<T> inline &operator+=(matrix<T> &lhs, const U &value) {
+template<typename T, typename U, typename Allocator, typename Layout>
+matrix<T, Allocator, Layout> inline &operator+=(matrix<T, Allocator, Layout> &lhs, const U &value) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.add(value);
@@ -936,11 +1235,11 @@ matrix<T> inline &operator+=(matrix<T> &lhs, const U &value) {
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline &operator-=(matrix<T> &lhs, const U &value) {
+template<typename T, typename U, typename Allocator, typename Layout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline &operator-=(matrix<T, Allocator, Layout> &lhs, const U &value) {
 #else
-template<typename T, typename U>
-matrix<T> inline &operator-=(matrix<T> &lhs, const U &value) {
+template<typename T, typename U, typename Allocator, typename Layout>
+matrix<T, Allocator, Layout> inline &operator-=(matrix<T, Allocator, Layout> &lhs, const U &value) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.sub(value);
@@ -948,11 +1247,11 @@ matrix<T> inline &operator-=(matrix<T> &lhs, const U &value) {
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline &operator*=(matrix<T> &lhs, const U &value) {
+template<typename T, typename U, typename Allocator, typename Layout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline &operator*=(matrix<T, Allocator, Layout> &lhs, const U &value) {
 #else
-template<typename T, typename U>
-matrix<T> inline &operator*=(matrix<T> &lhs, const U &value) {
+template<typename T, typename U, typename Allocator, typename Layout>
+matrix<T, Allocator, Layout> inline &operator*=(matrix<T, Allocator, Layout> &lhs, const U &value) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.mul(value);
@@ -960,11 +1259,11 @@ matrix<T> inline &operator*=(matrix<T> &lhs, const U &value) {
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline &operator/=(matrix<T> &lhs, const U &value) {
+template<typename T, typename U, typename Allocator, typename Layout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline &operator/=(matrix<T, Allocator, Layout> &lhs, const U &value) {
 #else
-template<typename T, typename U>
-matrix<T> inline &operator/=(matrix<T> &lhs, const U &value) {
+template<typename T, typename U, typename Allocator, typename Layout>
+matrix<T, Allocator, Layout> inline &operator/=(matrix<T, Allocator, Layout> &lhs, const U &value) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
   lhs.div(value);
@@ -972,116 +1271,432 @@ matrix<T> inline &operator/=(matrix<T> &lhs, const U &value) {
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline operator+(const matrix<T> &lhs, const matrix<U> &rhs) {
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline operator+(const matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 #else
-template<typename T, typename U>
-matrix<T> inline operator+(const matrix<T> &lhs, const matrix<U> &rhs) {
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+matrix<T, Allocator, Layout> inline operator+(const matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  matrix<T> result(lhs);
+  matrix<T, Allocator, Layout> result(lhs);
   result.add(rhs);
   return result;
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline operator-(const matrix<T> &lhs, const matrix<U> &rhs) {
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline operator-(const matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 #else
-template<typename T, typename U>
-matrix<T> inline operator-(const matrix<T> &lhs, const matrix<U> &rhs) {
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+matrix<T, Allocator, Layout> inline operator-(const matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  matrix<T> result(lhs);
+  matrix<T, Allocator, Layout> result(lhs);
   result.sub(rhs);
   return result;
 }
 
+namespace detail {
+
+/**
+ * Row-major copy of a with the default allocator and the items converted
+ * to T, the working storage of the factorizations and the solvers
+ */
+template<typename T, typename U, typename Allocator, typename Layout>
+matrix<T> row_major_copy(const matrix<U, Allocator, Layout> &a) {
+  matrix<T> copy(a.rows(), a.cols(), uninitialized);
+  copy_blocked(a, copy);
+  return copy;
+}
+
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+void multiply_transposed(const matrix<T, Allocator, Layout> &lhs, bool lhs_transposed,
+						 const matrix<U, OtherAllocator, OtherLayout> &rhs, bool rhs_transposed,
+						 matrix<T, Allocator, Layout> &multiplied, std::true_type) {
+  gemm_layout(multiplied.rows(), multiplied.cols(), lhs_transposed ? lhs.rows() : lhs.cols(),
+			  lhs, lhs_transposed, rhs, rhs_transposed, multiplied.data(), T(1), Layout());
+}
+
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+void multiply_transposed(const matrix<T, Allocator, Layout> &lhs, bool lhs_transposed,
+						 const matrix<U, OtherAllocator, OtherLayout> &rhs, bool rhs_transposed,
+						 matrix<T, Allocator, Layout> &multiplied, std::false_type) {
+  const std::size_t depth = lhs_transposed ? lhs.rows() : lhs.cols();
+
+  for (std::size_t row = 0; row != multiplied.rows(); ++row)
+	for (std::size_t col = 0; col != multiplied.cols(); ++col)
+	  for (std::size_t k = 0; k != depth; ++k)
+		multiplied(row, col) += (lhs_transposed ? lhs(k, row) : lhs(row, k)) *
+			(rhs_transposed ? rhs(col, k) : rhs(k, col));
+}
+
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+matrix<T, Allocator, Layout> mul_transposed(const matrix<T, Allocator, Layout> &lhs, bool lhs_transposed,
+									const matrix<U, OtherAllocator, OtherLayout> &rhs, bool rhs_transposed) {
+  const std::size_t rows = lhs_transposed ? lhs.cols() : lhs.rows();
+  const std::size_t lhs_depth = lhs_transposed ? lhs.rows() : lhs.cols();
+  const std::size_t rhs_depth = rhs_transposed ? rhs.cols() : rhs.rows();
+  const std::size_t cols = rhs_transposed ? rhs.rows() : rhs.cols();
+
+  if (lhs_depth != rhs_depth)
+	throw std::logic_error("Can't multiply two matrices because inner dimensions of operands are different");
+
+  matrix<T, Allocator, Layout> multiplied(rows, cols, T{}, lhs.get_allocator());
+  multiply_transposed(lhs, lhs_transposed, rhs, rhs_transposed, multiplied, is_gemm_compatible<T, U>());
+  return multiplied;
+}
+
+} // namespace detail end
+
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline operator*(const matrix<T> &lhs, const matrix<U> &rhs) {
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline operator*(const matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
 #else
-template<typename T, typename U>
-matrix<T> inline operator*(const matrix<T> &lhs, const matrix<U> &rhs) {
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+matrix<T, Allocator, Layout> inline operator*(const matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  matrix<T> result(lhs);
-  result.mul(rhs);
-  return result;
+  return detail::mul_transposed(lhs, false, rhs, false);
+}
+
+/**
+ * Products with transposed operands, the operands are read in place
+ * and lhs.transpose() or rhs.transpose() is never built
+ *
+ * @code
+ *
+ * mtlt::matrix<double> a(100, 20), b(100, 30), c(40, 30);
+ * mtlt::matrix<double> tn = mtlt::mul_tn(a, b); // a.transpose() * b, 20 x 30
+ * mtlt::matrix<double> nt = mtlt::mul_nt(b, c); // b * c.transpose(), 100 x 40
+ * mtlt::matrix<double> tt = mtlt::mul_tt(b, c); // b.transpose() * c.transpose(), 30 x 40
+ *
+ * @endcode
+ */
+#if __cplusplus > 201703L
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline mul_tn(const matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
+#else
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+matrix<T, Allocator, Layout> inline mul_tn(const matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
+  static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
+#endif
+  return detail::mul_transposed(lhs, true, rhs, false);
+}
+
+#if __cplusplus > 201703L
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline mul_nt(const matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
+#else
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+matrix<T, Allocator, Layout> inline mul_nt(const matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
+  static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
+#endif
+  return detail::mul_transposed(lhs, false, rhs, true);
+}
+
+#if __cplusplus > 201703L
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline mul_tt(const matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
+#else
+template<typename T, typename U, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+matrix<T, Allocator, Layout> inline mul_tt(const matrix<T, Allocator, Layout> &lhs, const matrix<U, OtherAllocator, OtherLayout> &rhs) {
+  static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
+#endif
+  return detail::mul_transposed(lhs, true, rhs, true);
+}
+
+namespace detail {
+
+/**
+ * Reports whether the storage of two matrices shares an item,
+ * borrow() and adopt() may place them in one buffer
+ */
+template<typename T, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+bool storage_overlap(const matrix<T, Allocator, Layout> &lhs, const matrix<T, OtherAllocator, OtherLayout> &rhs) {
+  if (lhs.size() == 0 || rhs.size() == 0)
+	return false;
+
+  const std::less<const T *> less;
+  const T *lhs_data = lhs.data(), *rhs_data = rhs.data();
+  return less(lhs_data, rhs_data + rhs.size()) && less(rhs_data, lhs_data + lhs.size());
+}
+
+template<typename T, typename AllocatorA, typename AllocatorB, typename AllocatorC,
+		 typename LayoutA, typename LayoutB, typename LayoutC>
+void gemm(const T &alpha, const matrix<T, AllocatorA, LayoutA> &a, const matrix<T, AllocatorB, LayoutB> &b,
+		  matrix<T, AllocatorC, LayoutC> &c, std::true_type) {
+  gemm_layout(c.rows(), c.cols(), a.cols(), a, false, b, false, c.data(), alpha, LayoutC());
+}
+
+template<typename T, typename AllocatorA, typename AllocatorB, typename AllocatorC,
+		 typename LayoutA, typename LayoutB, typename LayoutC>
+void gemm(const T &alpha, const matrix<T, AllocatorA, LayoutA> &a, const matrix<T, AllocatorB, LayoutB> &b,
+		  matrix<T, AllocatorC, LayoutC> &c, std::false_type) {
+  for (std::size_t row = 0; row != c.rows(); ++row)
+	for (std::size_t col = 0; col != c.cols(); ++col) {
+	  T sum{};
+	  for (std::size_t k = 0; k != a.cols(); ++k)
+		sum += a(row, k) * b(k, col);
+	  c(row, col) += alpha * sum;
+	}
+}
+
+} // namespace detail end
+
+/**
+ * Computes c = alpha * a * b + beta * c in the storage of c, c must have
+ * a.rows() rows and b.cols() columns and must not share storage with a or b.
+ * With beta == 0 the old items of c are not read. The operands may have
+ * different allocators and layouts: tiled and Z-order operands are copied
+ * to row major storage first, tiled and Z-order c is accumulated through
+ * a row major band of rows
+ *
+ * @code
+ *
+ * mtlt::matrix<double> a(500, 300), b(300, 400), c(500, 400);
+ * mtlt::gemm(1.0, a, b, 1.0, c); // c += a * b
+ * mtlt::gemm(2.0, a, b, 0.0, c); // c = 2 * a * b
+ *
+ * mtlt::matrix<double, mtlt::aligned_allocator<double>, mtlt::column_major> columns(300, 400);
+ * mtlt::gemm(1.0, a, columns, 0.0, c); // The columns of b are contiguous
+ *
+ * @endcode
+ */
+template<typename T, typename AllocatorA, typename AllocatorB, typename AllocatorC,
+		 typename LayoutA, typename LayoutB, typename LayoutC>
+void gemm(const typename matrix<T, AllocatorC, LayoutC>::value_type &alpha,
+		  const matrix<T, AllocatorA, LayoutA> &a, const matrix<T, AllocatorB, LayoutB> &b,
+		  const typename matrix<T, AllocatorC, LayoutC>::value_type &beta, matrix<T, AllocatorC, LayoutC> &c) {
+  if (a.cols() != b.rows())
+	throw std::logic_error("Can't multiply two matrices because a.cols() != b.rows()");
+
+  if (c.rows() != a.rows() || c.cols() != b.cols())
+	throw std::logic_error("Can't accumulate product because c is not a.rows() x b.cols()");
+
+  if (detail::storage_overlap(c, a) || detail::storage_overlap(c, b))
+	throw std::logic_error("Can't accumulate product into storage of one of its operands");
+
+  if (beta == T{})
+	c.fill(T{});
+  else if (beta != T(1))
+	c.mul(beta);
+
+  detail::gemm(alpha, a, b, c, detail::is_gemm_compatible<T, T>());
+}
+
+namespace detail {
+
+template<typename T, typename Allocator>
+void gemv(const T &alpha, const matrix<T, Allocator, row_major> &a, const T *x, T *y, std::true_type) {
+  gemv_accumulate(a.rows(), a.cols(), a.data(), a.cols(), x, y, alpha);
+}
+
+/**
+ * Column major storage is the row major storage of the transpose, a * x = x * a^T
+ */
+template<typename T, typename Allocator>
+void gemv(const T &alpha, const matrix<T, Allocator, column_major> &a, const T *x, T *y, std::true_type) {
+  gevm_accumulate(a.cols(), a.rows(), a.data(), a.rows(), x, y, alpha);
+}
+
+template<typename T, typename Allocator, typename Layout>
+void gemv(const T &alpha, const matrix<T, Allocator, Layout> &a, const T *x, T *y, std::false_type) {
+  for (std::size_t row = 0; row != a.rows(); ++row) {
+	T sum{};
+	for (std::size_t col = 0; col != a.cols(); ++col)
+	  sum += a(row, col) * x[col];
+	y[row] += alpha * sum;
+  }
+}
+
+template<typename T, typename Allocator, typename Layout>
+void gemv(const T &alpha, const matrix<T, Allocator, Layout> &a, const T *x, T *y, std::true_type) {
+  gemv(alpha, a, x, y, std::false_type());
+}
+
+template<typename T, typename Allocator>
+void gevm(const T &alpha, const T *x, const matrix<T, Allocator, row_major> &a, T *y, std::true_type) {
+  gevm_accumulate(a.rows(), a.cols(), a.data(), a.cols(), x, y, alpha);
+}
+
+template<typename T, typename Allocator>
+void gevm(const T &alpha, const T *x, const matrix<T, Allocator, column_major> &a, T *y, std::true_type) {
+  gemv_accumulate(a.cols(), a.rows(), a.data(), a.rows(), x, y, alpha);
+}
+
+template<typename T, typename Allocator, typename Layout>
+void gevm(const T &alpha, const T *x, const matrix<T, Allocator, Layout> &a, T *y, std::false_type) {
+  for (std::size_t row = 0; row != a.rows(); ++row)
+	for (std::size_t col = 0; col != a.cols(); ++col)
+	  y[col] += alpha * x[row] * a(row, col);
+}
+
+template<typename T, typename Allocator, typename Layout>
+void gevm(const T &alpha, const T *x, const matrix<T, Allocator, Layout> &a, T *y, std::true_type) {
+  gevm(alpha, x, a, y, std::false_type());
+}
+
+template<typename T, typename Allocator, typename Layout>
+std::vector<T> mul_vector(const matrix<T, Allocator, Layout> &lhs, const T *rhs, std::size_t size) {
+  if (lhs.cols() != size)
+	throw std::logic_error("Can't multiply matrix by vector because lhs.cols() != rhs.size()");
+
+  std::vector<T> multiplied(lhs.rows());
+  gemv(T(1), lhs, rhs, multiplied.data(), is_gemm_compatible<T, T>());
+  return multiplied;
+}
+
+template<typename T, typename Allocator, typename Layout>
+std::vector<T> mul_vector(const T *lhs, std::size_t size, const matrix<T, Allocator, Layout> &rhs) {
+  if (rhs.rows() != size)
+	throw std::logic_error("Can't multiply vector by matrix because lhs.size() != rhs.rows()");
+
+  std::vector<T> multiplied(rhs.cols());
+  gevm(T(1), lhs, rhs, multiplied.data(), is_gemm_compatible<T, T>());
+  return multiplied;
+}
+
+} // namespace detail end
+
+/**
+ * Computes y = alpha * a * x + beta * y in the storage of y, x has a.cols()
+ * items and y has a.rows() items. With beta == 0 the old items of y are not read
+ *
+ * @code
+ *
+ * mtlt::matrix<float> weights(1024, 4096);
+ * std::vector<float> input(4096), output(1024);
+ * mtlt::gemv(1.0f, weights, input.data(), 0.0f, output.data()); // output = weights * input
+ *
+ * @endcode
+ */
+template<typename T, typename Allocator, typename Layout>
+void gemv(const typename matrix<T, Allocator, Layout>::value_type &alpha, const matrix<T, Allocator, Layout> &a, const T *x,
+		  const typename matrix<T, Allocator, Layout>::value_type &beta, T *y) {
+  const std::size_t rows = a.rows();
+
+  if (beta == T{})
+	std::fill(y, y + rows, T{});
+  else if (beta != T(1))
+	std::transform(y, y + rows, y, [&beta](const T &item) { return item * beta; });
+
+  detail::gemv(alpha, a, x, y, detail::is_gemm_compatible<T, T>());
+}
+
+/**
+ * Matrix by column vector and row vector by matrix products,
+ * they don't build n x 1 matrices and run on the vector kernels
+ *
+ * @code
+ *
+ * mtlt::matrix<double> a(3, 2);
+ * std::vector<double> column {1, 2}, row {1, 2, 3};
+ * std::vector<double> ax = a * column; // 3 items
+ * std::vector<double> xa = row * a; // 2 items
+ *
+ * @endcode
+ */
+template<typename T, typename Allocator, typename Layout>
+std::vector<T> inline operator*(const matrix<T, Allocator, Layout> &lhs, const std::vector<T> &rhs) {
+  return detail::mul_vector(lhs, rhs.data(), rhs.size());
+}
+
+template<typename T, typename Allocator, typename Layout>
+std::vector<T> inline operator*(const std::vector<T> &lhs, const matrix<T, Allocator, Layout> &rhs) {
+  return detail::mul_vector(lhs.data(), lhs.size(), rhs);
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline operator+(const matrix<T> &lhs, const U &rhs) {
+template<typename T, std::size_t Extent, typename Allocator, typename Layout>
+std::vector<std::remove_cv_t<T>> inline operator*(const matrix<std::remove_cv_t<T>, Allocator, Layout> &lhs, std::span<T, Extent> rhs) {
+  return detail::mul_vector<std::remove_cv_t<T>>(lhs, rhs.data(), rhs.size());
+}
+
+template<typename T, std::size_t Extent, typename Allocator, typename Layout>
+std::vector<std::remove_cv_t<T>> inline operator*(std::span<T, Extent> lhs,
+												  const matrix<std::remove_cv_t<T>, Allocator, Layout> &rhs) {
+  return detail::mul_vector<std::remove_cv_t<T>>(lhs.data(), lhs.size(), rhs);
+}
+#endif
+
+#if __cplusplus > 201703L
+template<typename T, typename U, typename Allocator, typename Layout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline operator+(const matrix<T, Allocator, Layout> &lhs, const U &rhs) {
 #else
-template<typename T, typename U>
-matrix<T> inline operator+(const matrix<T> &lhs, const U &rhs) {
+template<typename T, typename U, typename Allocator, typename Layout>
+matrix<T, Allocator, Layout> inline operator+(const matrix<T, Allocator, Layout> &lhs, const U &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  matrix<T> result(lhs);
+  matrix<T, Allocator, Layout> result(lhs);
   result.add(rhs);
   return result;
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline operator-(const matrix<T> &lhs, const U &rhs) {
+template<typename T, typename U, typename Allocator, typename Layout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline operator-(const matrix<T, Allocator, Layout> &lhs, const U &rhs) {
 #else
-template<typename T, typename U>
-matrix<T> inline operator-(const matrix<T> &lhs, const U &rhs) {
+template<typename T, typename U, typename Allocator, typename Layout>
+matrix<T, Allocator, Layout> inline operator-(const matrix<T, Allocator, Layout> &lhs, const U &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  matrix<T> result(lhs);
+  matrix<T, Allocator, Layout> result(lhs);
   result.sub(rhs);
   return result;
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline operator*(const matrix<T> &lhs, const U &rhs) {
+template<typename T, typename U, typename Allocator, typename Layout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline operator*(const matrix<T, Allocator, Layout> &lhs, const U &rhs) {
 #else
-template<typename T, typename U>
-matrix<T> inline operator*(const matrix<T> &lhs, const U &rhs) {
+template<typename T, typename U, typename Allocator, typename Layout>
+matrix<T, Allocator, Layout> inline operator*(const matrix<T, Allocator, Layout> &lhs, const U &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  matrix<T> result(lhs);
+  matrix<T, Allocator, Layout> result(lhs);
   result.mul(rhs);
   return result;
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<U> inline operator*(const U &rhs, const matrix<T> &lhs) {
+template<typename T, typename U, typename Allocator, typename Layout> requires (std::convertible_to<U, T>)
+matrix<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>, Layout>
+inline operator*(const U &rhs, const matrix<T, Allocator, Layout> &lhs) {
 #else
-template<typename T, typename U>
-matrix<U> inline operator*(const U &rhs, const matrix<T> &lhs) {
+template<typename T, typename U, typename Allocator, typename Layout>
+matrix<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>, Layout>
+inline operator*(const U &rhs, const matrix<T, Allocator, Layout> &lhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  matrix<U> result(lhs);
+  using result_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
+
+  matrix<U, result_allocator, Layout> result(lhs.rows(), lhs.cols(), uninitialized,
+											 result_allocator(lhs.get_allocator()));
+  std::copy(lhs.data(), lhs.data() + lhs.size(), result.data());
   result.mul(rhs);
   return result;
 }
 
 #if __cplusplus > 201703L
-template<typename T, typename U> requires (std::convertible_to<U, T>)
-matrix<T> inline operator/(const matrix<T> &lhs, const U &rhs) {
+template<typename T, typename U, typename Allocator, typename Layout> requires (std::convertible_to<U, T>)
+matrix<T, Allocator, Layout> inline operator/(const matrix<T, Allocator, Layout> &lhs, const U &rhs) {
 #else
-template<typename T, typename U>
-matrix<T> inline operator/(const matrix<T> &lhs, const U &rhs) {
+template<typename T, typename U, typename Allocator, typename Layout>
+matrix<T, Allocator, Layout> inline operator/(const matrix<T, Allocator, Layout> &lhs, const U &rhs) {
   static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
 #endif
-  matrix<T> result(lhs);
+  matrix<T, Allocator, Layout> result(lhs);
   result.div(rhs);
   return result;
 }
 
-template<typename T>
-bool inline operator==(const matrix<T> &lhs, const matrix<T> &rhs) {
+template<typename T, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+bool inline operator==(const matrix<T, Allocator, Layout> &lhs, const matrix<T, OtherAllocator, OtherLayout> &rhs) {
   return lhs.equal_to(rhs);
 }
 
-template<typename T>
-bool inline operator!=(const matrix<T> &lhs, const matrix<T> &rhs) {
+template<typename T, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+bool inline operator!=(const matrix<T, Allocator, Layout> &lhs, const matrix<T, OtherAllocator, OtherLayout> &rhs) {
   return !(lhs == rhs);
 }
 
@@ -0,0 +1,173 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        Allocators of the dynamic containers: the storage of fundamental
+ *        types starts on a cache line, so the rows of the gemm panels and
+ *        the vector loads of the kernels never split across two lines
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_ALLOCATOR_H_
+#define MTLT_MATRIX_ALLOCATOR_H_
+
+#include <new>
+#include <limits>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <mtlt/matrix_config.h>
+
+namespace mtlt {
+
+/**
+ * @class aligned_allocator
+ *
+ * Standard allocator whose blocks start on an Alignment boundary,
+ * 64 bytes are one cache line and one AVX-512 register
+ *
+ * @code
+ *
+ * std::vector<float, mtlt::aligned_allocator<float>> buffer(1024); // buffer.data() % 64 == 0
+ * mtlt::matrix<double, mtlt::aligned_allocator<double, 128>> matrix(3, 3); // Two cache lines
+ *
+ * @endcode
+ */
+template<typename T, std::size_t Alignment = 64>
+class aligned_allocator {
+  static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+  static_assert(Alignment >= alignof(T), "Alignment must not be weaker than alignof(T)");
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_move_assignment = std::true_type;
+  using is_always_equal = std::true_type;
+
+  template<typename U>
+  struct rebind {
+	using other = aligned_allocator<U, Alignment>;
+  };
+
+  static constexpr std::size_t alignment = Alignment;
+
+public:
+  aligned_allocator() noexcept = default;
+
+  template<typename U>
+  aligned_allocator(const aligned_allocator<U, Alignment> &) noexcept {}
+
+  T *allocate(size_type n) {
+	if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+	  throw std::bad_alloc();
+
+#ifdef __cpp_aligned_new
+	return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+#else
+	// The address of the block is kept in front of the aligned storage
+	void *block = ::operator new(n * sizeof(T) + Alignment + sizeof(void *));
+	const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block) + sizeof(void *);
+	void *aligned = reinterpret_cast<void *>((address + Alignment - 1) & ~std::uintptr_t(Alignment - 1));
+	static_cast<void **>(aligned)[-1] = block;
+	return static_cast<T *>(aligned);
+#endif
+  }
+
+  void deallocate(T *p, size_type) noexcept {
+#ifdef __cpp_aligned_new
+	::operator delete(p, std::align_val_t(Alignment));
+#else
+	if (p)
+	  ::operator delete(reinterpret_cast<void **>(p)[-1]);
+#endif
+  }
+};
+
+template<typename T, typename U, std::size_t Alignment>
+bool inline operator==(const aligned_allocator<T, Alignment> &, const aligned_allocator<U, Alignment> &) noexcept {
+  return true;
+}
+
+template<typename T, typename U, std::size_t Alignment>
+bool inline operator!=(const aligned_allocator<T, Alignment> &, const aligned_allocator<U, Alignment> &) noexcept {
+  return false;
+}
+
+/**
+ * @struct uninitialized_t
+ *
+ * Tag of the constructors that leave the items of trivial types
+ * uninitialized, the pages of the storage are not touched until the
+ * first write. Items of other types are default constructed
+ *
+ * @code
+ *
+ * mtlt::matrix<double> scratch(100000, 10000, mtlt::uninitialized); // No page is touched
+ * mtlt::gemm(1.0, a, b, 0.0, scratch); // The product writes every item
+ *
+ * @endcode
+ */
+struct uninitialized_t {
+  explicit uninitialized_t() = default;
+};
+
+MATRIX_CXX17_INLINE constexpr uninitialized_t uninitialized{};
+
+namespace detail {
+
+template<typename Allocator, typename = void>
+struct allocator_always_equal : std::is_empty<Allocator> {
+};
+
+/**
+ * std::allocator_traits<Allocator>::is_always_equal of C++17, before it
+ * the allocators without a member is_always_equal are equal when they are empty
+ */
+template<typename Allocator>
+struct allocator_always_equal<Allocator, typename std::conditional<true, void, typename Allocator::is_always_equal>::type>
+	: std::integral_constant<bool, Allocator::is_always_equal::value> {
+};
+
+/**
+ * Move assignment of a container takes the storage of the other one without
+ * copying when the allocator propagates or any two allocators are equal
+ */
+template<typename Allocator>
+struct allocator_move_steals : std::integral_constant<bool,
+	std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+		allocator_always_equal<Allocator>::value> {
+};
+
+} // namespace detail end
+
+/**
+ * @using default_allocator
+ *
+ * The allocator of the containers when none is given: aligned_allocator
+ * for the fundamental types and std::allocator for the others.
+ * Item is the stored type, atomic_matrix<T> stores Atomic<T>
+ */
+template<typename T, typename Item = T>
+using default_allocator = typename std::conditional<std::is_fundamental<T>::value,
+													aligned_allocator<Item>,
+													std::allocator<Item>>::type;
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_ALLOCATOR_H_
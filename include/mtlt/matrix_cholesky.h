@@ -0,0 +1,196 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        The cholesky class keeps the factorization A = L * L^T of a
+ *        symmetric positive definite matrix, it takes half the work of LU,
+ *        needs no pivoting and is the fast path for covariance, Gram and
+ *        normal equation matrices
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_CHOLESKY_H_
+#define MTLT_MATRIX_CHOLESKY_H_
+
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_lu.h>
+#include <mtlt/matrix_config.h>
+#include <mtlt/matrix_decomposition.h>
+
+namespace mtlt {
+
+/**
+ * @class cholesky
+ *
+ * Factorization A = L * L^T of a symmetric positive definite matrix.
+ * Only the lower triangle of A is read, the upper one may hold anything.
+ * The recursion halves A and the trailing block only gets the lower triangle
+ * of L21 * L21^T subtracted, about half the flops of LU
+ *
+ * @code
+ *
+ * mtlt::matrix<double> a(3, 3, {4, 2, 2, 2, 5, 3, 2, 3, 6});
+ * mtlt::cholesky<double> factorization(a); // n^3 / 3 flops once
+ *
+ * mtlt::matrix<double> x = factorization.solve(b); // a * x = b
+ * double log_det = factorization.log_determinant(); // No overflow for large n
+ * mtlt::matrix<double> inverse = factorization.inverse();
+ *
+ * mtlt::cholesky<double> failed(mtlt::matrix<double>(2, 2, {1, 2, 2, 1})); // throws, not positive definite
+ *
+ * @endcode
+ */
+template<typename T = double>
+class cholesky {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+public:
+  cholesky() = default;
+
+  template<typename U, typename Allocator, typename Layout>
+  explicit cholesky(const matrix<U, Allocator, Layout> &a) : factor_(a.rows(), a.cols()) {
+	if (a.rows() != a.cols())
+	  throw std::logic_error("Cholesky factorization can be found only for square matrices");
+
+	for (size_type row = 0; row != size(); ++row)
+	  for (size_type col = 0; col <= row; ++col)
+		factor_(row, col) = static_cast<T>(a(row, col));
+
+	if (!detail::cholesky_factor(size(), factor_.data(), size()))
+	  throw std::logic_error("Cholesky factorization can't be found because the matrix is not positive definite");
+  }
+
+public:
+  MATRIX_CXX17_NODISCARD
+  size_type size() const noexcept { return factor_.rows(); }
+
+  /**
+   * L with zeros above the diagonal
+   */
+  MATRIX_CXX17_NODISCARD
+  const matrix<T> &lower() const noexcept { return factor_; }
+
+  MATRIX_CXX17_NODISCARD
+  matrix<T> upper() const { return factor_.transpose(); }
+
+  MATRIX_CXX17_NODISCARD
+  T determinant() const {
+	T product = T(1);
+	for (size_type i = 0; i != size(); ++i)
+	  product *= factor_(i, i) * factor_(i, i);
+	return product;
+  }
+
+  /**
+   * Logarithm of the determinant, which is always positive here
+   */
+  MATRIX_CXX17_NODISCARD
+  T log_determinant() const {
+	return detail::cholesky_log_determinant(size(), factor_.data(), size());
+  }
+
+  /**
+   * The determinant is positive, the sign is always 1
+   */
+  MATRIX_CXX17_NODISCARD
+  slogdet_result<T> slogdet() const {
+	return slogdet_result<T>{T(1), log_determinant()};
+  }
+
+  /**
+   * Solves A * X = B for every column of b
+   */
+  template<typename U, typename Allocator, typename Layout>
+  MATRIX_CXX17_NODISCARD
+  matrix<T> solve(const matrix<U, Allocator, Layout> &b) const {
+	matrix<T> x = detail::row_major_copy<T>(b);
+	solve_in_place(x);
+	return x;
+  }
+
+  template<typename U>
+  MATRIX_CXX17_NODISCARD
+  std::vector<T> solve(const std::vector<U> &b) const {
+	std::vector<T> x(b.begin(), b.end());
+	solve_in_place(x);
+	return x;
+  }
+
+  /**
+   * Overwrites b with the solution of A * X = B, nothing is allocated
+   */
+  template<typename Allocator>
+  void solve_in_place(matrix<T, Allocator> &b) const {
+	if (b.rows() != size())
+	  throw std::logic_error("Can't solve the system because b.rows() != size()");
+
+	detail::cholesky_solve(size(), factor_.data(), size(), b.cols(), b.data(), b.cols());
+  }
+
+  void solve_in_place(std::vector<T> &b) const {
+	if (b.size() != size())
+	  throw std::logic_error("Can't solve the system because b.size() != size()");
+
+	detail::cholesky_solve(size(), factor_.data(), size(), 1, b.data(), 1);
+  }
+
+  MATRIX_CXX17_NODISCARD
+  matrix<T> inverse() const {
+	matrix<T> inverted = matrix<T>::identity(size(), size());
+	solve_in_place(inverted);
+	return inverted;
+  }
+
+private:
+  matrix<T> factor_;
+};
+
+/**
+ * Solves a * x = b for symmetric positive definite a with the Cholesky
+ * factorization, throws if a is not positive definite
+ *
+ * @code
+ *
+ * mtlt::matrix<double> gram = mtlt::mul_tn(x, x) + mtlt::matrix<double>::identity(n, n) * lambda;
+ * mtlt::matrix<double> weights = mtlt::solve_spd(gram, mtlt::mul_tn(x, y));
+ *
+ * @endcode
+ */
+template<typename T, typename Allocator, typename Layout, typename OtherAllocator, typename OtherLayout>
+MATRIX_CXX17_NODISCARD
+matrix<T> solve_spd(const matrix<T, Allocator, Layout> &a, const matrix<T, OtherAllocator, OtherLayout> &b) {
+  return cholesky<T>(a).solve(b);
+}
+
+template<typename T, typename Allocator, typename Layout>
+MATRIX_CXX17_NODISCARD
+std::vector<T> solve_spd(const matrix<T, Allocator, Layout> &a, const std::vector<T> &b) {
+  return cholesky<T>(a).solve(b);
+}
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_CHOLESKY_H_
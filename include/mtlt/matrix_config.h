@@ -80,4 +80,24 @@ struct matrix_debug_settings {
 #  endif
 #endif
 
+#ifndef MATRIX_UNROLL
+#  if defined(__clang__)
+#    define MATRIX_UNROLL _Pragma("unroll")
+#  elif defined(__GNUC__) && __GNUC__ >= 8
+#    define MATRIX_UNROLL _Pragma("GCC unroll 16")
+#  else
+#    define MATRIX_UNROLL
+#  endif
+#endif
+
+#ifndef MATRIX_IS_CONSTANT_EVALUATED
+#  if __cplusplus < 201703L
+#    define MATRIX_IS_CONSTANT_EVALUATED() false
+#  elif (defined(__GNUC__) && __GNUC__ >= 9) || (defined(__clang__) && __clang_major__ >= 9)
+#    define MATRIX_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#  else
+#    define MATRIX_IS_CONSTANT_EVALUATED() true
+#  endif
+#endif
+
 #endif // MTLT_MATRIX_CONFIG_H_
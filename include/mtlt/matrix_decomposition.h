@@ -0,0 +1,847 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        The decomposition routines factor row major storage in place.
+ *        They are recursive: blocks are split in halves which are combined
+ *        by the multiplication engine, so the bulk of the work runs
+ *        on the blocked and parallel kernels
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_DECOMPOSITION_H_
+#define MTLT_MATRIX_DECOMPOSITION_H_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#include <mtlt/matrix_gemm.h>
+#include <mtlt/matrix_config.h>
+
+namespace mtlt {
+
+namespace detail {
+
+/**
+ * Recursive routines split their blocks in halves down to this width,
+ * the halves are combined by the multiplication engine
+ */
+MATRIX_CXX17_INLINE constexpr std::size_t decomposition_leaf_size = 16;
+
+/**
+ * Computes c(m x nrhs) -= a(m x k) * b(k x nrhs) for the triangular solves,
+ * a single right hand side goes to the matrix vector kernels
+ */
+template<typename T>
+void trsm_update(std::size_t m, std::size_t nrhs, std::size_t k, const gemm_operand<T> &a,
+				 const T *b, std::size_t ldb, T *c, std::size_t ldc) {
+  if (nrhs == 1 && ldb == 1 && ldc == 1 && a.col_stride == 1)
+	gemv_accumulate(m, k, a.data, a.row_stride, b, c, T(-1));
+  else if (nrhs == 1 && ldb == 1 && ldc == 1 && a.row_stride == 1)
+	gevm_accumulate(k, m, a.data, a.col_stride, b, c, T(-1));
+  else
+	gemm_accumulate(m, nrhs, k, a, make_gemm_operand(b, ldb), c, ldc, T(-1));
+}
+
+/**
+ * Solves L * X = B in place of b(n x nrhs), l is lower triangular,
+ * its diagonal is implied to be 1 if unit is true
+ */
+template<typename T>
+void trsm_lower(std::size_t n, std::size_t nrhs, const gemm_operand<T> &l, bool unit, T *b, std::size_t ldb) {
+  if (n <= decomposition_leaf_size) {
+	for (std::size_t i = 0; i != n; ++i) {
+	  T *row = b + i * ldb;
+
+	  for (std::size_t q = 0; q != i; ++q) {
+		const T item = l(i, q);
+		const T *solved = b + q * ldb;
+
+		for (std::size_t col = 0; col != nrhs; ++col)
+		  row[col] -= item * solved[col];
+	  }
+
+	  if (!unit) {
+		const T diagonal = l(i, i);
+		for (std::size_t col = 0; col != nrhs; ++col)
+		  row[col] /= diagonal;
+	  }
+	}
+	return;
+  }
+
+  // [L11 0; L21 L22] * [X1; X2] = [B1; B2]
+  const std::size_t half = n / 2;
+  trsm_lower(half, nrhs, l, unit, b, ldb);
+  trsm_update(n - half, nrhs, half, l.block(half, 0), b, ldb, b + half * ldb, ldb);
+  trsm_lower(n - half, nrhs, l.block(half, half), unit, b + half * ldb, ldb);
+}
+
+/**
+ * Solves U * X = B in place of b(n x nrhs), u is upper triangular
+ */
+template<typename T>
+void trsm_upper(std::size_t n, std::size_t nrhs, const gemm_operand<T> &u, T *b, std::size_t ldb) {
+  if (n <= decomposition_leaf_size) {
+	for (std::size_t i = n; i-- != 0;) {
+	  T *row = b + i * ldb;
+
+	  for (std::size_t q = i + 1; q != n; ++q) {
+		const T item = u(i, q);
+		const T *solved = b + q * ldb;
+
+		for (std::size_t col = 0; col != nrhs; ++col)
+		  row[col] -= item * solved[col];
+	  }
+
+	  const T diagonal = u(i, i);
+	  for (std::size_t col = 0; col != nrhs; ++col)
+		row[col] /= diagonal;
+	}
+	return;
+  }
+
+  // [U11 U12; 0 U22] * [X1; X2] = [B1; B2]
+  const std::size_t half = n / 2;
+  trsm_upper(n - half, nrhs, u.block(half, half), b + half * ldb, ldb);
+  trsm_update(half, nrhs, n - half, u.block(0, half), b + half * ldb, ldb, b, ldb);
+  trsm_upper(half, nrhs, u, b, ldb);
+}
+
+/**
+ * Factors columns [first, last) of a(m x n) for lu_factor, the columns are
+ * split in halves: the left half is factored, the right half is updated
+ * by a triangular solve and a product, and then factored
+ */
+template<typename T>
+bool lu_factor_columns(std::size_t m, std::size_t n, T *a, std::size_t lda, std::size_t *pivots,
+					   std::size_t first, std::size_t last) {
+  if (last - first > decomposition_leaf_size) {
+	const std::size_t middle = first + (last - first) / 2;
+	const bool left = lu_factor_columns(m, n, a, lda, pivots, first, middle);
+
+	trsm_lower(middle - first, last - middle, make_gemm_operand(a + first * lda + first, lda), true,
+			   a + first * lda + middle, lda);
+	gemm_accumulate(m - middle, last - middle, middle - first,
+					make_gemm_operand(a + middle * lda + first, lda), make_gemm_operand(a + first * lda + middle, lda),
+					a + middle * lda + middle, lda, T(-1));
+
+	const bool right = lu_factor_columns(m, n, a, lda, pivots, middle, last);
+	return left && right;
+  }
+
+  bool regular = true;
+
+  for (std::size_t c = first; c != last; ++c) {
+	std::size_t pivot = c;
+	T largest = std::abs(a[c * lda + c]);
+
+	for (std::size_t r = c + 1; r < m; ++r) {
+	  const T item = std::abs(a[r * lda + c]);
+	  if (item > largest) {
+		largest = item;
+		pivot = r;
+	  }
+	}
+
+	// Rows are swapped along their whole length
+	pivots[c] = pivot;
+	if (pivot != c)
+	  std::swap_ranges(a + c * lda, a + c * lda + n, a + pivot * lda);
+
+	const T *diagonal_row = a + c * lda;
+	if (diagonal_row[c] == T{}) {
+	  regular = false;
+	  continue;
+	}
+
+	for (std::size_t r = c + 1; r < m; ++r) {
+	  T *row = a + r * lda;
+	  const T item = row[c] /= diagonal_row[c];
+
+	  if (item != T{})
+		for (std::size_t q = c + 1; q != last; ++q)
+		  row[q] -= item * diagonal_row[q];
+	}
+  }
+
+  return regular;
+}
+
+/**
+ * Factors a(m x n) = P * L * U in place with partial pivoting: the strict
+ * lower part of a keeps L (its unit diagonal is implied), the upper part keeps U.
+ * Row i was swapped with row pivots[i] at step i, pivots has min(m, n) items.
+ * Returns false if some pivot is exactly zero, the factorization is completed anyway
+ */
+template<typename T>
+bool lu_factor(std::size_t m, std::size_t n, T *a, std::size_t lda, std::size_t *pivots) {
+  const std::size_t steps = std::min(m, n);
+  const bool regular = lu_factor_columns(m, n, a, lda, pivots, 0, steps);
+
+  // Columns of a wide matrix which are right of the square part
+  if (steps < n)
+	trsm_lower(steps, n - steps, make_gemm_operand(a, lda), true, a + steps, lda);
+
+  return regular;
+}
+
+/**
+ * True if some pivot of the n x n factors of lu_factor is negligible next to
+ * the largest item of U, |u_ii| <= n * epsilon * max|u_ij|. The inverse of
+ * such a matrix is dominated by rounding, the test doesn't depend on the scale
+ */
+template<typename T>
+bool lu_negligible_pivot(std::size_t n, const T *lu, std::size_t lda) {
+  T largest{}, smallest_pivot = std::numeric_limits<T>::infinity();
+
+  for (std::size_t i = 0; i != n; ++i) {
+	smallest_pivot = std::min(smallest_pivot, T(std::abs(lu[i * lda + i])));
+	for (std::size_t j = i; j != n; ++j)
+	  largest = std::max(largest, T(std::abs(lu[i * lda + j])));
+  }
+
+  return n != 0 && smallest_pivot <= T(n) * std::numeric_limits<T>::epsilon() * largest;
+}
+
+/**
+ * Solves A * X = B in place of b(n x nrhs) with the factors of lu_factor,
+ * all columns of b are solved at once by the blocked triangular solves
+ */
+template<typename T>
+void lu_solve(std::size_t n, const T *lu, std::size_t lda, const std::size_t *pivots,
+			  std::size_t nrhs, T *b, std::size_t ldb) {
+  for (std::size_t i = 0; i != n; ++i)
+	if (pivots[i] != i)
+	  std::swap_ranges(b + i * ldb, b + i * ldb + nrhs, b + pivots[i] * ldb);
+
+  trsm_lower(n, nrhs, make_gemm_operand(lu, lda), true, b, ldb);
+  trsm_upper(n, nrhs, make_gemm_operand(lu, lda), b, ldb);
+}
+
+/**
+ * Determinant of the matrix factored by lu_factor
+ */
+template<typename T>
+T lu_determinant(std::size_t n, const T *lu, std::size_t lda, const std::size_t *pivots) {
+  T determinant = T(1);
+
+  for (std::size_t i = 0; i != n; ++i) {
+	determinant *= lu[i * lda + i];
+	if (pivots[i] != i)
+	  determinant = -determinant;
+  }
+
+  return determinant;
+}
+
+/**
+ * Logarithm of |det| of the LU factors and its sign in one pass over
+ * the diagonal, the product is never formed, so it can't overflow.
+ * A zero pivot gives sign 0 and -inf
+ */
+template<typename T>
+T lu_log_determinant(std::size_t n, const T *lu, std::size_t lda, const std::size_t *pivots, T &sign) {
+  T log_abs{};
+  sign = T(1);
+
+  for (std::size_t i = 0; i != n; ++i) {
+	const T pivot = lu[i * lda + i];
+	if (pivot == T{}) {
+	  sign = T{};
+	  return -std::numeric_limits<T>::infinity();
+	}
+
+	if ((pivot < T{}) != (pivots[i] != i))
+	  sign = -sign;
+	log_abs += std::log(std::fabs(pivot));
+  }
+
+  return log_abs;
+}
+
+/**
+ * Computes b(m x n) = b * inverse(L)^T in place, l(n x n) is lower triangular
+ */
+template<typename T>
+void trsm_right_lower_transposed(std::size_t m, std::size_t n, const T *l, std::size_t ldl, T *b, std::size_t ldb) {
+  if (n <= decomposition_leaf_size) {
+	for (std::size_t r = 0; r != m; ++r) {
+	  T *row = b + r * ldb;
+
+	  for (std::size_t j = 0; j != n; ++j) {
+		const T *l_row = l + j * ldl;
+		T sum = row[j];
+
+		for (std::size_t q = 0; q != j; ++q)
+		  sum -= row[q] * l_row[q];
+		row[j] = sum / l_row[j];
+	  }
+	}
+	return;
+  }
+
+  // [X1 X2] * [L11^T L21^T; 0 L22^T] = [B1 B2]
+  const std::size_t half = n / 2;
+  trsm_right_lower_transposed(m, half, l, ldl, b, ldb);
+  gemm_accumulate(m, n - half, half, make_gemm_operand(b, ldb), make_gemm_operand(l + half * ldl, ldl, true),
+				  b + half, ldb, T(-1));
+  trsm_right_lower_transposed(m, n - half, l + half * ldl + half, ldl, b + half, ldb);
+}
+
+/**
+ * Computes the lower triangle of c(n x n) -= a(n x k) * a^T,
+ * the upper triangle of c is not touched
+ */
+template<typename T>
+void syrk_lower(std::size_t n, std::size_t k, const T *a, std::size_t lda, T *c, std::size_t ldc) {
+  if (n <= decomposition_leaf_size) {
+	for (std::size_t i = 0; i != n; ++i) {
+	  const T *a_i = a + i * lda;
+
+	  for (std::size_t j = 0; j <= i; ++j) {
+		const T *a_j = a + j * lda;
+		T sum{};
+
+		for (std::size_t p = 0; p != k; ++p)
+		  sum += a_i[p] * a_j[p];
+		c[i * ldc + j] -= sum;
+	  }
+	}
+	return;
+  }
+
+  // C11 and C22 are triangles again, C21 is a full block
+  const std::size_t half = n / 2;
+  syrk_lower(half, k, a, lda, c, ldc);
+  gemm_accumulate(n - half, half, k, make_gemm_operand(a + half * lda, lda), make_gemm_operand(a, lda, true),
+				  c + half * ldc, ldc, T(-1));
+  syrk_lower(n - half, k, a + half * lda, lda, c + half * ldc + half, ldc);
+}
+
+/**
+ * Computes the lower triangle of c(n x n) -= v(n x k) * w^T + w * v^T,
+ * the upper triangle of c is not touched
+ */
+template<typename T>
+void syr2k_lower(std::size_t n, std::size_t k, const T *v, std::size_t ldv, const T *w, std::size_t ldw,
+				 T *c, std::size_t ldc) {
+  if (n <= decomposition_leaf_size) {
+	for (std::size_t i = 0; i != n; ++i) {
+	  const T *v_i = v + i * ldv, *w_i = w + i * ldw;
+
+	  for (std::size_t j = 0; j <= i; ++j) {
+		const T *v_j = v + j * ldv, *w_j = w + j * ldw;
+		T sum{};
+
+		for (std::size_t p = 0; p != k; ++p)
+		  sum += v_i[p] * w_j[p] + w_i[p] * v_j[p];
+		c[i * ldc + j] -= sum;
+	  }
+	}
+	return;
+  }
+
+  const std::size_t half = n / 2;
+  syr2k_lower(half, k, v, ldv, w, ldw, c, ldc);
+  gemm_accumulate(n - half, half, k, make_gemm_operand(v + half * ldv, ldv), make_gemm_operand(w, ldw, true),
+				  c + half * ldc, ldc, T(-1));
+  gemm_accumulate(n - half, half, k, make_gemm_operand(w + half * ldw, ldw), make_gemm_operand(v, ldv, true),
+				  c + half * ldc, ldc, T(-1));
+  syr2k_lower(n - half, k, v + half * ldv, ldv, w + half * ldw, ldw, c + half * ldc + half, ldc);
+}
+
+/**
+ * Factors a(n x n) = L * L^T in place of the lower triangle of a,
+ * the upper triangle is neither read nor written.
+ * Returns false if a is not positive definite
+ */
+template<typename T>
+bool cholesky_factor(std::size_t n, T *a, std::size_t lda) {
+  if (n <= decomposition_leaf_size) {
+	for (std::size_t j = 0; j != n; ++j) {
+	  T *row_j = a + j * lda;
+	  T diagonal = row_j[j];
+
+	  for (std::size_t q = 0; q != j; ++q)
+		diagonal -= row_j[q] * row_j[q];
+
+	  // Also fails on NaN
+	  if (!(diagonal > T{}))
+		return false;
+
+	  diagonal = std::sqrt(diagonal);
+	  row_j[j] = diagonal;
+
+	  for (std::size_t i = j + 1; i != n; ++i) {
+		T *row_i = a + i * lda;
+		T sum = row_i[j];
+
+		for (std::size_t q = 0; q != j; ++q)
+		  sum -= row_i[q] * row_j[q];
+		row_i[j] = sum / diagonal;
+	  }
+	}
+	return true;
+  }
+
+  // [L11 0; L21 L22] * [L11^T L21^T; 0 L22^T] = [A11 A21^T; A21 A22]
+  const std::size_t half = n / 2;
+  if (!cholesky_factor(half, a, lda))
+	return false;
+
+  trsm_right_lower_transposed(n - half, half, a, lda, a + half * lda, lda);
+  syrk_lower(n - half, half, a + half * lda, lda, a + half * lda + half, lda);
+  return cholesky_factor(n - half, a + half * lda + half, lda);
+}
+
+/**
+ * Solves A * X = B in place of b(n x nrhs) with the factor of cholesky_factor
+ */
+template<typename T>
+void cholesky_solve(std::size_t n, const T *l, std::size_t ldl, std::size_t nrhs, T *b, std::size_t ldb) {
+  trsm_lower(n, nrhs, make_gemm_operand(l, ldl), false, b, ldb);
+  trsm_upper(n, nrhs, make_gemm_operand(l, ldl, true), b, ldb);
+}
+
+/**
+ * Logarithm of the determinant of the matrix factored by cholesky_factor
+ */
+template<typename T>
+T cholesky_log_determinant(std::size_t n, const T *l, std::size_t ldl) {
+  T sum{};
+  for (std::size_t i = 0; i != n; ++i)
+	sum += std::log(l[i * ldl + i]);
+  return 2 * sum;
+}
+
+/**
+ * Panels of the QR factorization are this wide, the reflectors of a panel
+ * are applied to the rest of the matrix at once in the compact WY form
+ */
+MATRIX_CXX17_INLINE constexpr std::size_t qr_block_size = 64;
+
+/**
+ * Householder reflector H = I - tau * v * v^T with H * [alpha, x] = [beta, 0],
+ * norm is |x|^2. Returns tau, zero tau means H = I, v is [1, x * scale]
+ */
+template<typename T>
+T householder_reflector(T alpha, T norm, T &beta, T &scale) {
+  if (norm == T{})
+	return T{};
+
+  beta = alpha >= T{} ? -std::hypot(alpha, std::sqrt(norm)) : std::hypot(alpha, std::sqrt(norm));
+  scale = T(1) / (alpha - beta);
+  return (beta - alpha) / beta;
+}
+
+/**
+ * Computes c(m x n) = (I - V * op(T) * V^T) * c, op(T) is T^T if transposed.
+ * v(m x k) is unit lower trapezoidal, its diagonal and upper part are not read,
+ * t(k x k) is upper triangular and w is a workspace of k * n items
+ */
+template<typename T>
+void apply_block_reflector(std::size_t m, std::size_t n, std::size_t k, const T *v, std::size_t ldv,
+						   const T *t, std::size_t ldt, bool transposed, T *c, std::size_t ldc, T *w) {
+  if (n == 0 || k == 0)
+	return;
+
+  // W = V^T * C, the top k x k part of V is a triangle
+  for (std::size_t r = 0; r != k; ++r) {
+	std::copy(c + r * ldc, c + r * ldc + n, w + r * n);
+	for (std::size_t i = 0; i != r; ++i) {
+	  const T item = v[r * ldv + i];
+	  for (std::size_t j = 0; j != n; ++j)
+		w[i * n + j] += item * c[r * ldc + j];
+	}
+  }
+
+  if (n == 1 && ldc == 1)
+	gevm_accumulate(m - k, k, v + k * ldv, ldv, c + k, w, T(1));
+  else
+	gemm_accumulate(k, n, m - k, make_gemm_operand(v + k * ldv, ldv, true), make_gemm_operand(c + k * ldc, ldc),
+					w, n);
+
+  // W = op(T) * W in place
+  if (transposed) {
+	for (std::size_t i = k; i-- != 0;) {
+	  for (std::size_t j = 0; j != n; ++j)
+		w[i * n + j] *= t[i * ldt + i];
+	  for (std::size_t q = 0; q != i; ++q) {
+		const T item = t[q * ldt + i];
+		for (std::size_t j = 0; j != n; ++j)
+		  w[i * n + j] += item * w[q * n + j];
+	  }
+	}
+  } else {
+	for (std::size_t i = 0; i != k; ++i) {
+	  for (std::size_t j = 0; j != n; ++j)
+		w[i * n + j] *= t[i * ldt + i];
+	  for (std::size_t q = i + 1; q != k; ++q) {
+		const T item = t[i * ldt + q];
+		for (std::size_t j = 0; j != n; ++j)
+		  w[i * n + j] += item * w[q * n + j];
+	  }
+	}
+  }
+
+  // C -= V * W
+  if (n == 1 && ldc == 1)
+	gemv_accumulate(m - k, k, v + k * ldv, ldv, w, c + k, T(-1));
+  else
+	gemm_accumulate(m - k, n, k, make_gemm_operand(v + k * ldv, ldv), make_gemm_operand(w, n),
+					c + k * ldc, ldc, T(-1));
+
+  for (std::size_t r = 0; r != k; ++r) {
+	for (std::size_t j = 0; j != n; ++j)
+	  c[r * ldc + j] -= w[r * n + j];
+	for (std::size_t i = 0; i != r; ++i) {
+	  const T item = v[r * ldv + i];
+	  for (std::size_t j = 0; j != n; ++j)
+		c[r * ldc + j] -= item * w[i * n + j];
+	}
+  }
+}
+
+/**
+ * Factors the panel a(m x n), m >= n, into reflectors below the diagonal and R
+ * above it, t(n x n) gets the triangular factor of H1 * ... * Hn = I - V * T * V^T.
+ * The left half of the panel is factored first, applied to the right half,
+ * then the right half is factored and both triangular factors are merged
+ */
+template<typename T>
+void qr_factor_panel(std::size_t m, std::size_t n, T *a, std::size_t lda, T *tau, T *t, std::size_t ldt, T *w) {
+  if (n <= decomposition_leaf_size) {
+	// One pass over the tall panel per column: the update by reflector j
+	// also gathers the norm and the dot products of column j + 1, which
+	// is scaled into its reflector on the next pass. Local buffers
+	// can't alias the panel and stay in registers
+	T dot[decomposition_leaf_size], next_dot[decomposition_leaf_size];
+	T norm{};
+	std::fill(dot, dot + n, T{});
+
+	for (std::size_t r = 1; r < m; ++r) {
+	  const T *row = a + r * lda;
+	  norm += row[0] * row[0];
+	  for (std::size_t c = 1; c != n; ++c)
+		dot[c - 1] += row[0] * row[c];
+	}
+
+	for (std::size_t j = 0; j != n; ++j) {
+	  T *row_j = a + j * lda;
+	  const std::size_t rest = n - j - 1;
+
+	  T beta = row_j[j], scale{}, next_norm{};
+	  tau[j] = householder_reflector(row_j[j], norm, beta, scale);
+	  row_j[j] = beta;
+
+	  // a(j:, j+1:) -= v * dot with dot = tau * v^T * a(j:, j+1:)
+	  for (std::size_t c = 0; c != rest; ++c) {
+		dot[c] = tau[j] * (row_j[j + 1 + c] + scale * dot[c]);
+		row_j[j + 1 + c] -= dot[c];
+		next_dot[c] = T{};
+	  }
+
+	  for (std::size_t r = j + 1; r < m; ++r) {
+		T *row = a + r * lda;
+		const T item = row[j] *= scale;
+		for (std::size_t c = 0; c != rest; ++c)
+		  row[j + 1 + c] -= item * dot[c];
+
+		// Row j + 1 holds the diagonal item of the next column
+		if (r != j + 1 && rest != 0) {
+		  next_norm += row[j + 1] * row[j + 1];
+		  for (std::size_t c = 1; c != rest; ++c)
+			next_dot[c - 1] += row[j + 1] * row[j + 1 + c];
+		}
+	  }
+
+	  norm = next_norm;
+	  std::copy(next_dot, next_dot + rest, dot);
+	}
+
+	// The strict upper part of t gets V^T * V in one pass over the rows
+	T gram[decomposition_leaf_size * decomposition_leaf_size];
+	for (std::size_t i = 0; i != n; ++i)
+	  for (std::size_t q = 0; q != i; ++q)
+		gram[q * n + i] = a[i * lda + q];
+
+	for (std::size_t r = n; r < m; ++r) {
+	  const T *row = a + r * lda;
+	  for (std::size_t i = 1; i != n; ++i)
+		for (std::size_t q = 0; q != i; ++q)
+		  gram[q * n + i] += row[q] * row[i];
+	}
+
+	for (std::size_t r = 2; r < std::min(m, n); ++r) {
+	  const T *row = a + r * lda;
+	  for (std::size_t i = 1; i != r; ++i)
+		for (std::size_t q = 0; q != i; ++q)
+		  gram[q * n + i] += row[q] * row[i];
+	}
+
+	for (std::size_t i = 0; i != n; ++i)
+	  for (std::size_t q = 0; q != i; ++q)
+		t[q * ldt + i] = gram[q * n + i];
+
+	// T(0:i, i) = -tau_i * T(0:i, 0:i) * V(:, 0:i)^T * v_i
+	for (std::size_t i = 0; i != n; ++i) {
+	  for (std::size_t q = 0; q != i; ++q)
+		dot[q] = t[q * ldt + i];
+
+	  for (std::size_t q = 0; q != i; ++q) {
+		T sum{};
+		for (std::size_t p = q; p != i; ++p)
+		  sum += t[q * ldt + p] * dot[p];
+		t[q * ldt + i] = -tau[i] * sum;
+	  }
+	  t[i * ldt + i] = tau[i];
+	}
+	return;
+  }
+
+  const std::size_t n1 = n / 2, n2 = n - n1;
+  qr_factor_panel(m, n1, a, lda, tau, t, ldt, w);
+  apply_block_reflector(m, n2, n1, a, lda, t, ldt, true, a + n1, lda, w);
+  qr_factor_panel(m - n1, n2, a + n1 * lda + n1, lda, tau + n1, t + n1 * ldt + n1, ldt, w);
+
+  // T12 = -T11 * V1^T * V2 * T22, the top n2 x n2 part of V2 is a triangle
+  T *x = t + n1;
+  const T *v1 = a + n1 * lda, *v2 = a + n1 * lda + n1;
+  for (std::size_t i = 0; i != n1; ++i)
+	std::fill(x + i * ldt, x + i * ldt + n2, T{});
+
+  for (std::size_t r = 0; r != n2; ++r)
+	for (std::size_t i = 0; i != n1; ++i) {
+	  const T item = v1[r * lda + i];
+	  for (std::size_t c = 0; c != r; ++c)
+		x[i * ldt + c] += item * v2[r * lda + c];
+	  x[i * ldt + r] += item;
+	}
+
+  gemm_accumulate(n1, n2, m - n1 - n2, make_gemm_operand(v1 + n2 * lda, lda, true),
+				  make_gemm_operand(v2 + n2 * lda, lda), x, ldt);
+
+  for (std::size_t i = 0; i != n1; ++i) {
+	for (std::size_t c = 0; c != n2; ++c)
+	  x[i * ldt + c] *= t[i * ldt + i];
+	for (std::size_t q = i + 1; q != n1; ++q) {
+	  const T item = t[i * ldt + q];
+	  for (std::size_t c = 0; c != n2; ++c)
+		x[i * ldt + c] += item * x[q * ldt + c];
+	}
+  }
+
+  const T *t2 = t + n1 * ldt + n1;
+  for (std::size_t i = 0; i != n1; ++i)
+	for (std::size_t c = n2; c-- != 0;) {
+	  T sum{};
+	  for (std::size_t q = 0; q <= c; ++q)
+		sum += x[i * ldt + q] * t2[q * ldt + c];
+	  x[i * ldt + c] = -sum;
+	}
+}
+
+/**
+ * Size of the workspace of qr_factor and qr_apply with nrhs columns
+ */
+inline std::size_t qr_workspace_size(std::size_t n, std::size_t nrhs) {
+  return qr_block_size * std::max(std::max(n, nrhs), qr_block_size);
+}
+
+/**
+ * Factors a(m x n) = Q * R in place: R is above the diagonal and the
+ * Householder vectors of Q below it. Q = H1 * ... * Hk, k = min(m, n),
+ * the triangular factors of the panels are stored side by side in t(qr_block_size x k)
+ */
+template<typename T>
+void qr_factor(std::size_t m, std::size_t n, T *a, std::size_t lda, T *tau, T *t, std::size_t ldt, T *w) {
+  const std::size_t k = std::min(m, n);
+
+  for (std::size_t j = 0; j < k; j += qr_block_size) {
+	const std::size_t jb = std::min(qr_block_size, k - j);
+	T *panel = a + j * lda + j;
+
+	qr_factor_panel(m - j, jb, panel, lda, tau + j, t + j, ldt, w);
+	apply_block_reflector(m - j, n - j - jb, jb, panel, lda, t + j, ldt, true, panel + jb, lda, w);
+  }
+}
+
+/**
+ * Computes t(k x k) of H1 * ... * Hk = I - V * T * V^T for reflectors which were
+ * generated elsewhere, v(m x k) is unit lower trapezoidal and only the upper
+ * triangle of t is written
+ */
+template<typename T>
+void block_reflector_factor(std::size_t m, std::size_t k, const T *v, std::size_t ldv, const T *tau,
+							T *t, std::size_t ldt) {
+  // The strict upper part of t gets V^T * V, the top k x k part of V is a triangle
+  for (std::size_t i = 0; i != k; ++i) {
+	std::fill(t + i * ldt, t + i * ldt + i + 1, T{});
+	for (std::size_t q = 0; q != i; ++q)
+	  t[q * ldt + i] = v[i * ldv + q];
+  }
+
+  for (std::size_t r = 0; r != k; ++r)
+	for (std::size_t i = 0; i != r; ++i)
+	  for (std::size_t q = 0; q != i; ++q)
+		t[q * ldt + i] += v[r * ldv + q] * v[r * ldv + i];
+
+  gemm_accumulate(k, k, m - k, make_gemm_operand(v + k * ldv, ldv, true), make_gemm_operand(v + k * ldv, ldv),
+				  t, ldt);
+
+  std::vector<T> column(k);
+  for (std::size_t i = 0; i != k; ++i) {
+	for (std::size_t q = 0; q != i; ++q)
+	  column[q] = t[q * ldt + i];
+
+	for (std::size_t q = 0; q != i; ++q) {
+	  T sum{};
+	  for (std::size_t p = q; p != i; ++p)
+		sum += t[q * ldt + p] * column[p];
+	  t[q * ldt + i] = -tau[i] * sum;
+	}
+	t[i * ldt + i] = tau[i];
+  }
+}
+
+/**
+ * Fills t(qr_block_size x k) for qr_apply with the panels of k reflectors stored
+ * like the ones of qr_factor
+ */
+template<typename T>
+void block_reflector_factors(std::size_t m, std::size_t k, const T *v, std::size_t ldv, const T *tau,
+							 T *t, std::size_t ldt) {
+  for (std::size_t j = 0; j < k; j += qr_block_size) {
+	const std::size_t jb = std::min(qr_block_size, k - j);
+	block_reflector_factor(m - j, jb, v + j * ldv + j, ldv, tau + j, t + j, ldt);
+  }
+}
+
+/**
+ * Computes c(m x nrhs) = Q^T * c if transposed, Q * c otherwise,
+ * with the factors of qr_factor
+ */
+template<typename T>
+void qr_apply(std::size_t m, std::size_t k, const T *a, std::size_t lda, const T *t, std::size_t ldt,
+			  bool transposed, std::size_t nrhs, T *c, std::size_t ldc, T *w) {
+  const std::size_t panels = (k + qr_block_size - 1) / qr_block_size;
+
+  for (std::size_t panel = 0; panel != panels; ++panel) {
+	const std::size_t j = (transposed ? panel : panels - 1 - panel) * qr_block_size;
+	const std::size_t jb = std::min(qr_block_size, k - j);
+
+	apply_block_reflector(m - j, nrhs, jb, a + j * lda + j, lda, t + j, ldt, transposed, c + j * ldc, ldc, w);
+  }
+}
+
+/**
+ * Cofactor expansion is O(n!), it is allowed for tiny matrices only
+ */
+MATRIX_CXX17_INLINE constexpr std::size_t cofactor_max_size = 10;
+
+/**
+ * Expands the determinant of the rows [row, row + count) and the listed columns
+ * along the first row, the columns of the minors live on the stack
+ */
+template<typename Matrix>
+MATRIX_CXX17_CONSTEXPR double cofactor_determinant(const Matrix &m, std::size_t row,
+												   const std::size_t *columns, std::size_t count) {
+  if (count == 0)
+	return 0.0;
+  if (count == 1)
+	return static_cast<double>(m(row, columns[0]));
+  if (count == 2)
+	return static_cast<double>(m(row, columns[0])) * static_cast<double>(m(row + 1, columns[1])) -
+		static_cast<double>(m(row, columns[1])) * static_cast<double>(m(row + 1, columns[0]));
+
+  std::size_t rest[cofactor_max_size] = {};
+  double determinant = 0.0, sign = 1.0;
+
+  for (std::size_t skip = 0; skip != count; ++skip) {
+	for (std::size_t i = 0, j = 0; i != count; ++i)
+	  if (i != skip)
+		rest[j++] = columns[i];
+
+	determinant += sign * static_cast<double>(m(row, columns[skip])) * cofactor_determinant(m, row + 1, rest, count - 1);
+	sign = -sign;
+  }
+
+  return determinant;
+}
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef __int128 bareiss_int128;
+#else
+typedef long long bareiss_int128;
+#endif
+
+/**
+ * Bareiss keeps minors of the matrix in every item, so their products
+ * are taken in an integer twice as wide as T
+ */
+template<typename T>
+struct bareiss_type {
+  using type = typename std::conditional<(sizeof(T) < sizeof(long long)), long long, bareiss_int128>::type;
+};
+
+/**
+ * Fraction-free elimination of a(n x n) in place, every division is exact.
+ * After the step k the item (i, j) is the minor of the rows 0..k, i
+ * and the columns 0..k, j, the last pivot is the determinant
+ */
+template<typename W>
+MATRIX_CXX17_CONSTEXPR W bareiss_determinant(std::size_t n, W *a) {
+  W sign = 1, previous = 1;
+
+  for (std::size_t k = 0; k != n; ++k) {
+	if (a[k * n + k] == 0) {
+	  std::size_t pivot_row = k + 1;
+	  while (pivot_row != n && a[pivot_row * n + k] == 0)
+		++pivot_row;
+
+	  if (pivot_row == n)
+		return 0;
+
+	  for (std::size_t col = k; col != n; ++col) {
+		const W item = a[k * n + col];
+		a[k * n + col] = a[pivot_row * n + col];
+		a[pivot_row * n + col] = item;
+	  }
+	  sign = -sign;
+	}
+
+	const W pivot = a[k * n + k];
+	for (std::size_t row = k + 1; row != n; ++row) {
+	  const W first = a[row * n + k];
+	  for (std::size_t col = k + 1; col != n; ++col)
+		a[row * n + col] = (a[row * n + col] * pivot - first * a[k * n + col]) / previous;
+	}
+	previous = pivot;
+  }
+
+  return sign * previous;
+}
+
+} // namespace detail end
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_DECOMPOSITION_H_
@@ -0,0 +1,872 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        The symmetric eigenvalue solver reduces the matrix to tridiagonal
+ *        form with blocked Householder reflectors, solves the tridiagonal
+ *        problem by divide and conquer (all eigenpairs) or by bisection and
+ *        inverse iteration (a few of them) and transforms the eigenvectors back
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_EIGEN_H_
+#define MTLT_MATRIX_EIGEN_H_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_config.h>
+#include <mtlt/matrix_decomposition.h>
+
+namespace mtlt {
+
+/**
+ * Eigenvalues in ascending order, column i of vectors is the
+ * unit eigenvector of values[i]
+ */
+template<typename T>
+struct eigh_result {
+  std::vector<T> values;
+  matrix<T> vectors;
+};
+
+namespace detail {
+
+/**
+ * Reduction panels are this wide, tridiagonal problems up to
+ * tridiagonal_leaf_size are solved by the QL iteration
+ */
+MATRIX_CXX17_INLINE constexpr std::size_t tridiagonal_block_size = 32;
+MATRIX_CXX17_INLINE constexpr std::size_t tridiagonal_leaf_size = 32;
+
+/**
+ * Computes y(n) = a(n x n) * x for symmetric a stored in the lower triangle.
+ * Four rows share every load and store of y, the reduction is bound by this pass
+ */
+template<typename T>
+void symv_lower(std::size_t n, const T *a, std::size_t lda, const T *x, T *y) {
+  std::fill(y, y + n, T{});
+
+  std::size_t r = 0;
+  for (; r + 4 <= n; r += 4) {
+	const T *r0 = a + r * lda, *r1 = r0 + lda, *r2 = r1 + lda, *r3 = r2 + lda;
+	const T x0 = x[r], x1 = x[r + 1], x2 = x[r + 2], x3 = x[r + 3];
+	T s0{}, s1{}, s2{}, s3{};
+
+	for (std::size_t c = 0; c != r; ++c) {
+	  const T item = x[c];
+	  s0 += r0[c] * item, s1 += r1[c] * item, s2 += r2[c] * item, s3 += r3[c] * item;
+	  y[c] += r0[c] * x0 + r1[c] * x1 + r2[c] * x2 + r3[c] * x3;
+	}
+
+	y[r] += s0, y[r + 1] += s1, y[r + 2] += s2, y[r + 3] += s3;
+	for (std::size_t i = r; i != r + 4; ++i) {
+	  const T *row = a + i * lda;
+	  T sum{};
+
+	  for (std::size_t c = r; c != i; ++c) {
+		sum += row[c] * x[c];
+		y[c] += row[c] * x[i];
+	  }
+	  y[i] += sum + row[i] * x[i];
+	}
+  }
+
+  for (; r < n; ++r) {
+	const T *row = a + r * lda;
+	T sum{};
+
+	for (std::size_t c = 0; c != r; ++c) {
+	  sum += row[c] * x[c];
+	  y[c] += row[c] * x[r];
+	}
+	y[r] += sum + row[r] * x[r];
+  }
+}
+
+/**
+ * Reduces the first nb columns of the symmetric a(m x m), lower triangle,
+ * and returns the reflectors in a and W(m x nb) for the update of the rest
+ * A -= V * W^T + W * V^T. The unit items of the reflectors are stored
+ */
+template<typename T>
+void tridiagonal_panel(std::size_t m, std::size_t nb, T *a, std::size_t lda, T *d, T *e, T *tau,
+					   T *w, std::size_t ldw, T *scratch) {
+  T *v = scratch, *p = scratch + m, *wv = scratch + 2 * m, *vv = scratch + 2 * m + nb;
+
+  for (std::size_t i = 0; i != nb; ++i) {
+	// A(i:, i) -= V(i:, 0:i) * W(i, 0:i)^T + W(i:, 0:i) * V(i, 0:i)^T
+	for (std::size_t r = i; r != m && i != 0; ++r) {
+	  const T *a_r = a + r * lda, *w_r = w + r * ldw;
+	  T sum{};
+
+	  for (std::size_t q = 0; q != i; ++q)
+		sum += a_r[q] * w[i * ldw + q] + w_r[q] * a[i * lda + q];
+	  a[r * lda + i] -= sum;
+	}
+
+	d[i] = a[i * lda + i];
+	if (i + 1 == m)
+	  break;
+
+	// Reflector of A(i+1:, i)
+	const std::size_t rest = m - i - 1;
+	T norm{};
+	for (std::size_t r = 1; r != rest; ++r)
+	  norm += a[(i + 1 + r) * lda + i] * a[(i + 1 + r) * lda + i];
+
+	T beta = a[(i + 1) * lda + i], scale{};
+	tau[i] = householder_reflector(beta, norm, beta, scale);
+	e[i] = beta;
+
+	v[0] = T(1);
+	for (std::size_t r = 1; r != rest; ++r)
+	  v[r] = a[(i + 1 + r) * lda + i] *= scale;
+	a[(i + 1) * lda + i] = T(1);
+
+	// W(i+1:, i) = tau * (A22 * v - V * (W^T * v) - W * (V^T * v)), A22 is not updated yet
+	symv_lower(rest, a + (i + 1) * lda + i + 1, lda, v, p);
+
+	if (i != 0) {
+	  std::fill(wv, wv + i, T{});
+	  std::fill(vv, vv + i, T{});
+
+	  for (std::size_t r = 0; r != rest; ++r) {
+		const T *a_r = a + (i + 1 + r) * lda, *w_r = w + (i + 1 + r) * ldw;
+		for (std::size_t q = 0; q != i; ++q) {
+		  wv[q] += w_r[q] * v[r];
+		  vv[q] += a_r[q] * v[r];
+		}
+	  }
+
+	  for (std::size_t r = 0; r != rest; ++r) {
+		const T *a_r = a + (i + 1 + r) * lda, *w_r = w + (i + 1 + r) * ldw;
+		T sum{};
+		for (std::size_t q = 0; q != i; ++q)
+		  sum += a_r[q] * wv[q] + w_r[q] * vv[q];
+		p[r] -= sum;
+	  }
+	}
+
+	T dot{};
+	for (std::size_t r = 0; r != rest; ++r)
+	  dot += (p[r] *= tau[i]) * v[r];
+
+	const T alpha = -tau[i] / 2 * dot;
+	for (std::size_t r = 0; r <= i; ++r)
+	  w[r * ldw + i] = T{};
+	for (std::size_t r = 0; r != rest; ++r)
+	  w[(i + 1 + r) * ldw + i] = p[r] + alpha * v[r];
+  }
+}
+
+/**
+ * Reduces the symmetric a(n x n), lower triangle, to Q^T * A * Q = tridiagonal(e, d, e).
+ * The reflectors of Q are left below the diagonal, the one of column i starts at row i + 1
+ */
+template<typename T>
+void tridiagonalize(std::size_t n, T *a, std::size_t lda, T *d, T *e, T *tau) {
+  const std::size_t nb = tridiagonal_block_size;
+  std::vector<T> w(n * 2 * nb), scratch(2 * n + 4 * nb);
+
+  std::size_t j = 0;
+  for (; n - j > 2 * nb; j += nb) {
+	const std::size_t m = n - j;
+	T *block = a + j * lda + j;
+
+	tridiagonal_panel(m, nb, block, lda, d + j, e + j, tau + j, w.data(), nb, scratch.data());
+	syr2k_lower(m - nb, nb, block + nb * lda, lda, w.data() + nb * nb, nb, block + nb * lda + nb, lda);
+  }
+
+  // The last panel is at most 2 * nb wide and needs no update
+  const std::size_t m = n - j;
+  tridiagonal_panel(m, m, a + j * lda + j, lda, d + j, e + j, tau + j, w.data(), m, scratch.data());
+}
+
+/**
+ * Computes z(n x ncols) = Q * z for the Q of tridiagonalize
+ */
+template<typename T>
+void tridiagonal_back_transform(std::size_t n, const T *a, std::size_t lda, const T *tau,
+								std::size_t ncols, T *z, std::size_t ldz) {
+  if (n < 2 || ncols == 0)
+	return;
+
+  // Q = diag(1, Q'), Q' is a product of n - 1 reflectors of order n - 1
+  const std::size_t k = n - 1;
+  std::vector<T> t(qr_block_size * k), workspace(qr_workspace_size(0, ncols));
+
+  block_reflector_factors(k, k, a + lda, lda, tau, t.data(), k);
+  qr_apply(k, k, a + lda, lda, t.data(), k, false, ncols, z + ldz, ldz, workspace.data());
+}
+
+/**
+ * Implicit QL iteration with Wilkinson shifts on the tridiagonal d(n), e(n) with
+ * e[i] between d[i] and d[i + 1], e is destroyed. The rotations are accumulated
+ * in the columns of z(n x n) if it is not null. Returns false if it doesn't converge
+ */
+template<typename T>
+bool tridiagonal_ql(std::size_t n, T *d, T *e, T *z, std::size_t ldz) {
+  const T epsilon = std::numeric_limits<T>::epsilon();
+
+  for (std::size_t l = 0; l < n; ++l) {
+	for (std::size_t iteration = 0;; ++iteration) {
+	  std::size_t m = l;
+	  for (; m + 1 < n; ++m)
+		if (std::fabs(e[m]) <= epsilon * (std::fabs(d[m]) + std::fabs(d[m + 1])))
+		  break;
+
+	  if (m == l)
+		break;
+	  if (iteration == 60)
+		return false;
+
+	  T g = (d[l + 1] - d[l]) / (2 * e[l]);
+	  T r = std::hypot(g, T(1));
+	  g = d[m] - d[l] + e[l] / (g + (g >= T{} ? r : -r));
+
+	  T s = 1, c = 1, p = 0;
+	  bool underflow = false;
+
+	  for (std::size_t i = m; i-- > l;) {
+		T f = s * e[i];
+		const T b = c * e[i];
+		e[i + 1] = r = std::hypot(f, g);
+
+		if (r == T{}) {
+		  d[i + 1] -= p;
+		  e[m] = T{};
+		  underflow = true;
+		  break;
+		}
+
+		s = f / r;
+		c = g / r;
+		g = d[i + 1] - p;
+		r = (d[i] - g) * s + 2 * c * b;
+		d[i + 1] = g + (p = s * r);
+		g = c * r - b;
+
+		for (std::size_t row = 0; z && row != n; ++row) {
+		  f = z[row * ldz + i + 1];
+		  z[row * ldz + i + 1] = s * z[row * ldz + i] + c * f;
+		  z[row * ldz + i] = c * z[row * ldz + i] - s * f;
+		}
+	  }
+
+	  if (underflow)
+		continue;
+
+	  d[l] -= p;
+	  e[l] = g;
+	  e[m] = T{};
+	}
+  }
+
+  return true;
+}
+
+/**
+ * Root i of the secular equation 1 + rho * sum(z_j^2 / (d_j - x)) = 0 for
+ * increasing d(k), rho > 0. The root is searched as an offset from the closer pole
+ * with the rational two pole model safeguarded by bisection, delta gets d_j - root
+ */
+template<typename T>
+T secular_root(std::size_t k, const T *d, const T *z, T rho, std::size_t i, T *delta) {
+  const T epsilon = std::numeric_limits<T>::epsilon();
+
+  if (k == 1) {
+	delta[0] = -rho * z[0] * z[0];
+	return d[0] + rho * z[0] * z[0];
+  }
+
+  std::size_t origin = i;
+  T lower{}, upper{};
+
+  if (i + 1 == k) {
+	T norm{};
+	for (std::size_t j = 0; j != k; ++j)
+	  norm += z[j] * z[j];
+	upper = rho * norm;
+  } else {
+	const T middle = (d[i + 1] - d[i]) / 2;
+	T f = T(1);
+	for (std::size_t j = 0; j != k; ++j)
+	  f += rho * z[j] * z[j] / ((d[j] - d[i]) - middle);
+
+	if (f >= T{}) {
+	  upper = middle;
+	} else {
+	  origin = i + 1;
+	  lower = -middle;
+	}
+  }
+
+  // Poles of the model: i and i + 1 inside the spectrum, i - 1 and i for the last root
+  const std::size_t split = i + 1 == k ? i : i + 1;
+  const std::size_t left = split - 1, right = split == k ? split - 1 : split;
+
+  T tau = (lower + upper) / 2;
+  for (std::size_t iteration = 0; iteration != 100; ++iteration) {
+	T psi{}, phi{}, dpsi{}, dphi{};
+
+	for (std::size_t j = 0; j != k; ++j) {
+	  delta[j] = (d[j] - d[origin]) - tau;
+	  const T t = z[j] / delta[j];
+
+	  if (j < split)
+		psi += z[j] * t, dpsi += t * t;
+	  else
+		phi += z[j] * t, dphi += t * t;
+	}
+
+	const T f = 1 + rho * (psi + phi);
+	if (std::fabs(f) <= 8 * epsilon * (1 + rho * (std::fabs(psi) + std::fabs(phi))))
+	  break;
+
+	if (f < T{})
+	  lower = tau;
+	else
+	  upper = tau;
+
+	if (upper - lower <= 2 * epsilon * std::max(std::fabs(lower), std::fabs(upper)))
+	  break;
+
+	// c + s / (delta_left - eta) + S / (delta_right - eta) = 0 matches f and its derivative
+	const T delta_left = delta[left];
+	const T delta_right = delta[right];
+	const T a = (delta_left + delta_right) * f - delta_left * delta_right * rho * (dpsi + dphi);
+	const T b = delta_left * delta_right * f;
+	const T c = f - delta_left * rho * dpsi - delta_right * rho * dphi;
+
+	T eta = (lower + upper) / 2 - tau;
+	const T discriminant = std::sqrt(std::max(a * a - 4 * b * c, T{}));
+	const T candidates[2] = {
+		c == T{} ? b / a : a <= T{} ? (a - discriminant) / (2 * c) : 2 * b / (a + discriminant),
+		c == T{} ? b / a : a <= T{} ? 2 * b / (a - discriminant) : (a + discriminant) / (2 * c)
+	};
+
+	bool found = false;
+	for (const T candidate : candidates) {
+	  const T next = tau + candidate;
+	  if (std::isfinite(candidate) && next > lower && next < upper && (!found || std::fabs(candidate) < std::fabs(eta))) {
+		eta = candidate;
+		found = true;
+	  }
+	}
+
+	tau += eta;
+  }
+
+  return d[origin] + tau;
+}
+
+/**
+ * Combines the eigenpairs of the halves n1 and n - n1 stored on the diagonal
+ * blocks of z(n x n) into the eigenpairs of diag(T1, T2) + rho * u * u^T,
+ * u = [last row of Q1, sign * first row of Q2]. Eigenpairs are not sorted
+ */
+template<typename T>
+void tridiagonal_merge(std::size_t n, std::size_t n1, T *d, T *z, std::size_t ldz, T rho, T sign) {
+  const T epsilon = std::numeric_limits<T>::epsilon();
+
+  for (std::size_t row = 0; row != n; ++row) {
+	T *z_row = z + row * ldz;
+	if (row < n1)
+	  std::fill(z_row + n1, z_row + n, T{});
+	else
+	  std::fill(z_row, z_row + n1, T{});
+  }
+
+  const T norm = std::sqrt(T(2));
+  std::vector<T> u(n);
+  for (std::size_t j = 0; j != n1; ++j)
+	u[j] = z[(n1 - 1) * ldz + j] / norm;
+  for (std::size_t j = n1; j != n; ++j)
+	u[j] = sign * z[n1 * ldz + j] / norm;
+  rho *= 2;
+
+  std::vector<std::size_t> order(n);
+  std::iota(order.begin(), order.end(), std::size_t{});
+  std::sort(order.begin(), order.end(), [d](std::size_t lhs, std::size_t rhs) { return d[lhs] < d[rhs]; });
+
+  // Columns live in the top rows, the bottom rows or both after a rotation
+  enum : unsigned char { top, mixed, bottom };
+  std::vector<unsigned char> type(n);
+  for (std::size_t j = 0; j != n; ++j)
+	type[j] = j < n1 ? top : bottom;
+
+  T largest{};
+  for (std::size_t j = 0; j != n; ++j)
+	largest = std::max(largest, std::max(std::fabs(d[j]), std::fabs(u[j])));
+  const T tolerance = 8 * epsilon * largest;
+
+  // Deflation: a small item of u or two close poles give an eigenpair right away
+  std::vector<std::size_t> kept, deflated;
+  std::size_t previous = n;
+
+  for (std::size_t index : order) {
+	if (rho * std::fabs(u[index]) <= tolerance) {
+	  deflated.push_back(index);
+	  continue;
+	}
+
+	if (previous == n) {
+	  previous = index;
+	  continue;
+	}
+
+	const T r = std::hypot(u[index], u[previous]);
+	const T c = u[index] / r, s = -u[previous] / r;
+
+	if (std::fabs((d[index] - d[previous]) * c * s) > tolerance) {
+	  kept.push_back(previous);
+	  previous = index;
+	  continue;
+	}
+
+	u[index] = r;
+	u[previous] = T{};
+
+	for (std::size_t row = 0; row != n; ++row) {
+	  const T x = z[row * ldz + previous], y = z[row * ldz + index];
+	  z[row * ldz + previous] = c * x + s * y;
+	  z[row * ldz + index] = c * y - s * x;
+	}
+
+	const T value = d[previous] * c * c + d[index] * s * s;
+	d[index] = d[previous] * s * s + d[index] * c * c;
+	d[previous] = value;
+
+	if (type[previous] != type[index])
+	  type[index] = mixed;
+
+	deflated.push_back(previous);
+	previous = index;
+  }
+
+  if (previous != n)
+	kept.push_back(previous);
+
+  const std::size_t k = kept.size();
+  std::vector<T> poles(k), weights(k), roots(k), delta(k * k);
+
+  for (std::size_t j = 0; j != k; ++j) {
+	poles[j] = d[kept[j]];
+	weights[j] = u[kept[j]];
+  }
+
+  for (std::size_t i = 0; i != k; ++i)
+	roots[i] = secular_root(k, poles.data(), weights.data(), rho, i, delta.data() + i * k);
+
+  // Weights recomputed from the roots make the eigenvectors orthogonal (Gu and Eisenstat)
+  for (std::size_t j = 0; j != k; ++j) {
+	T product = -delta[j * k + j] / rho;
+	for (std::size_t i = 0; i != k; ++i)
+	  if (i != j)
+		product *= -delta[i * k + j] / (poles[i] - poles[j]);
+
+	weights[j] = weights[j] >= T{} ? std::sqrt(std::max(product, T{})) : -std::sqrt(std::max(product, T{}));
+  }
+
+  // Secular rows are grouped as top, mixed, bottom columns, so the products
+  // of the two halves skip the zero blocks of Q
+  std::vector<std::size_t> rows(k);
+  std::iota(rows.begin(), rows.end(), std::size_t{});
+  std::stable_sort(rows.begin(), rows.end(), [&](std::size_t lhs, std::size_t rhs) {
+	return type[kept[lhs]] < type[kept[rhs]];
+  });
+
+  std::size_t tops = 0, bottoms = 0;
+  for (std::size_t j = 0; j != k; ++j) {
+	tops += type[kept[j]] == top;
+	bottoms += type[kept[j]] == bottom;
+  }
+
+  std::vector<T> q(n * k), vectors(k * k), saved(n * deflated.size());
+  for (std::size_t row = 0; row != n; ++row) {
+	for (std::size_t j = 0; j != k; ++j)
+	  q[row * k + j] = z[row * ldz + kept[rows[j]]];
+	for (std::size_t j = 0; j != deflated.size(); ++j)
+	  saved[row * deflated.size() + j] = z[row * ldz + deflated[j]];
+  }
+
+  for (std::size_t i = 0; i != k; ++i) {
+	T sum{};
+	for (std::size_t j = 0; j != k; ++j) {
+	  const T item = weights[rows[j]] / delta[i * k + rows[j]];
+	  vectors[j * k + i] = item;
+	  sum += item * item;
+	}
+
+	const T scale = T(1) / std::sqrt(sum);
+	for (std::size_t j = 0; j != k; ++j)
+	  vectors[j * k + i] *= scale;
+  }
+
+  for (std::size_t row = 0; row != n; ++row)
+	std::fill(z + row * ldz, z + row * ldz + n, T{});
+
+  gemm_accumulate(n1, k, k - bottoms, q.data(), k, vectors.data(), k, z, ldz);
+  gemm_accumulate(n - n1, k, k - tops, q.data() + n1 * k + tops, k, vectors.data() + tops * k, k,
+				  z + n1 * ldz, ldz);
+
+  for (std::size_t row = 0; row != n; ++row)
+	for (std::size_t j = 0; j != deflated.size(); ++j)
+	  z[row * ldz + k + j] = saved[row * deflated.size() + j];
+
+  std::vector<T> values(n);
+  std::copy(roots.begin(), roots.end(), values.begin());
+  for (std::size_t j = 0; j != deflated.size(); ++j)
+	values[k + j] = d[deflated[j]];
+  std::copy(values.begin(), values.end(), d);
+}
+
+/**
+ * Eigenpairs of the tridiagonal d(n), e(n - 1) by divide and conquer (Cuppen),
+ * the eigenvectors are written to the columns of z(n x n), d gets the eigenvalues.
+ * Eigenpairs are not sorted
+ */
+template<typename T>
+void tridiagonal_divide(std::size_t n, T *d, const T *e, T *z, std::size_t ldz) {
+  if (n <= tridiagonal_leaf_size) {
+	for (std::size_t row = 0; row != n; ++row) {
+	  std::fill(z + row * ldz, z + row * ldz + n, T{});
+	  z[row * ldz + row] = T(1);
+	}
+
+	std::vector<T> sub(e, e + n - 1);
+	sub.push_back(T{});
+
+	if (!tridiagonal_ql(n, d, sub.data(), z, ldz))
+	  throw std::logic_error("Can't find eigenvalues because the QL iteration did not converge");
+	return;
+  }
+
+  // T = diag(T1, T2) + rho * u * u^T, u = e_{n1 - 1} + sign * e_{n1}
+  const std::size_t n1 = n / 2;
+  const T rho = std::fabs(e[n1 - 1]);
+  d[n1 - 1] -= rho;
+  d[n1] -= rho;
+
+  tridiagonal_divide(n1, d, e, z, ldz);
+  tridiagonal_divide(n - n1, d + n1, e + n1, z + n1 * ldz + n1, ldz);
+  tridiagonal_merge(n, n1, d, z, ldz, rho, e[n1 - 1] < T{} ? T(-1) : T(1));
+}
+
+/**
+ * Number of eigenvalues of the tridiagonal d(n), e(n - 1) less than x (Sturm sequence)
+ */
+template<typename T>
+std::size_t sturm_count(std::size_t n, const T *d, const T *e, T x, T pivot_min) {
+  std::size_t count = 0;
+  T q = d[0] - x;
+
+  for (std::size_t i = 0;; ++i) {
+	if (std::fabs(q) <= pivot_min)
+	  q = -pivot_min;
+	count += q < T{};
+
+	if (i + 1 == n)
+	  return count;
+	q = d[i + 1] - x - e[i] * e[i] / q;
+  }
+}
+
+/**
+ * Eigenpairs first, ..., n - 1 of the tridiagonal d(n), e(n - 1) in ascending order:
+ * eigenvalues by bisection, eigenvectors by inverse iteration, vectors of close
+ * eigenvalues are orthogonalized. values gets n - first items, z is n x (n - first)
+ */
+template<typename T>
+void tridiagonal_bisect(std::size_t n, const T *d, const T *e, std::size_t first, T *values, T *z, std::size_t ldz) {
+  const T epsilon = std::numeric_limits<T>::epsilon();
+  const std::size_t count = n - first;
+
+  T lower = d[0], upper = d[0], norm{}, largest_e{};
+  for (std::size_t i = 0; i != n; ++i) {
+	const T radius = (i != 0 ? std::fabs(e[i - 1]) : T{}) + (i + 1 != n ? std::fabs(e[i]) : T{});
+	lower = std::min(lower, d[i] - radius);
+	upper = std::max(upper, d[i] + radius);
+	norm = std::max(norm, std::fabs(d[i]) + radius);
+	if (i + 1 != n)
+	  largest_e = std::max(largest_e, e[i] * e[i]);
+  }
+
+  const T pivot_min = std::numeric_limits<T>::min() * std::max(T(1), largest_e);
+  const T width = upper - lower;
+  lower -= 2 * epsilon * width + pivot_min;
+  upper += 2 * epsilon * width + pivot_min;
+
+  for (std::size_t i = 0; i != count; ++i) {
+	T low = lower, high = upper;
+	for (std::size_t iteration = 0; iteration != 200; ++iteration) {
+	  if (high - low <= 2 * epsilon * std::max(std::fabs(low), std::fabs(high)) + pivot_min)
+		break;
+
+	  const T middle = (low + high) / 2;
+	  if (sturm_count(n, d, e, middle, pivot_min) > first + i)
+		high = middle;
+	  else
+		low = middle;
+	}
+	values[i] = (low + high) / 2;
+  }
+
+  // Inverse iteration with (T - lambda * I) factored by partial pivoting
+  const T cluster = norm / 1000;
+  const T zero_pivot = epsilon * std::max(norm, std::numeric_limits<T>::min());
+  std::vector<T> diagonal(n), upper1(n), upper2(n), lower1(n), x(n);
+  std::vector<unsigned char> swapped(n);
+  std::size_t cluster_begin = 0;
+  unsigned seed = 1;
+
+  for (std::size_t i = 0; i != count; ++i) {
+	if (i != 0 && values[i] - values[i - 1] > cluster)
+	  cluster_begin = i;
+
+	// Coincident eigenvalues get a small perturbation to find different vectors
+	T lambda = values[i];
+	if (i != cluster_begin && lambda - values[i - 1] < 10 * epsilon * std::fabs(lambda))
+	  lambda = values[i - 1] + 10 * epsilon * std::fabs(lambda);
+
+	for (std::size_t r = 0; r != n; ++r) {
+	  diagonal[r] = d[r] - lambda;
+	  upper1[r] = r + 1 != n ? e[r] : T{};
+	  lower1[r] = upper1[r];
+	  upper2[r] = T{};
+	}
+
+	for (std::size_t r = 0; r + 1 < n; ++r) {
+	  swapped[r] = std::fabs(diagonal[r]) < std::fabs(lower1[r]);
+
+	  if (!swapped[r]) {
+		if (diagonal[r] == T{})
+		  diagonal[r] = zero_pivot;
+		const T factor = lower1[r] / diagonal[r];
+		lower1[r] = factor;
+		diagonal[r + 1] -= factor * upper1[r];
+	  } else {
+		const T factor = diagonal[r] / lower1[r];
+		diagonal[r] = lower1[r];
+		lower1[r] = factor;
+		const T item = upper1[r];
+		upper1[r] = diagonal[r + 1];
+		diagonal[r + 1] = item - factor * diagonal[r + 1];
+		if (r + 2 < n) {
+		  upper2[r] = upper1[r + 1];
+		  upper1[r + 1] = -factor * upper1[r + 1];
+		}
+	  }
+	}
+	if (diagonal[n - 1] == T{})
+	  diagonal[n - 1] = zero_pivot;
+
+	for (std::size_t r = 0; r != n; ++r) {
+	  seed = seed * 1103515245u + 12345u;
+	  x[r] = static_cast<T>(seed >> 16 & 0x7fff) / 0x7fff - T(0.5);
+	}
+
+	for (std::size_t iteration = 0; iteration != 5; ++iteration) {
+	  for (std::size_t r = 0; r + 1 < n; ++r) {
+		if (!swapped[r]) {
+		  x[r + 1] -= lower1[r] * x[r];
+		} else {
+		  const T item = x[r];
+		  x[r] = x[r + 1];
+		  x[r + 1] = item - lower1[r] * x[r];
+		}
+	  }
+
+	  for (std::size_t r = n; r-- != 0;) {
+		T sum = x[r];
+		if (r + 1 < n)
+		  sum -= upper1[r] * x[r + 1];
+		if (r + 2 < n)
+		  sum -= upper2[r] * x[r + 2];
+		x[r] = sum / diagonal[r];
+	  }
+
+	  for (std::size_t j = cluster_begin; j != i; ++j) {
+		T dot{};
+		for (std::size_t r = 0; r != n; ++r)
+		  dot += z[r * ldz + j] * x[r];
+		for (std::size_t r = 0; r != n; ++r)
+		  x[r] -= dot * z[r * ldz + j];
+	  }
+
+	  T sum{};
+	  for (std::size_t r = 0; r != n; ++r)
+		sum += x[r] * x[r];
+
+	  const T scale = T(1) / std::sqrt(sum);
+	  for (std::size_t r = 0; r != n; ++r)
+		x[r] *= scale;
+	}
+
+	for (std::size_t r = 0; r != n; ++r)
+	  z[r * ldz + i] = x[r];
+  }
+}
+
+template<typename T>
+void sort_eigenpairs(std::size_t n, T *values, T *z, std::size_t ldz) {
+  std::vector<std::size_t> order(n);
+  std::iota(order.begin(), order.end(), std::size_t{});
+  std::sort(order.begin(), order.end(), [values](std::size_t lhs, std::size_t rhs) {
+	return values[lhs] < values[rhs];
+  });
+
+  std::vector<T> sorted(n), row(n);
+  for (std::size_t j = 0; j != n; ++j)
+	sorted[j] = values[order[j]];
+  std::copy(sorted.begin(), sorted.end(), values);
+
+  for (std::size_t r = 0; r != n; ++r) {
+	for (std::size_t j = 0; j != n; ++j)
+	  row[j] = z[r * ldz + order[j]];
+	std::copy(row.begin(), row.end(), z + r * ldz);
+  }
+}
+
+} // namespace detail end
+
+/**
+ * Eigenvalues and eigenvectors of the symmetric matrix a, only the lower
+ * triangle of a is read. The eigenvalues are in ascending order
+ *
+ * @code
+ *
+ * mtlt::matrix<double> covariance = mtlt::mul_tn(x, x);
+ * mtlt::eigh_result<double> eigen = mtlt::eigh(covariance);
+ *
+ * eigen.values; // Ascending
+ * eigen.vectors; // covariance * eigen.vectors == eigen.vectors * diag(eigen.values)
+ *
+ * @endcode
+ */
+#if __cplusplus > 201703L
+template<typename T, typename Allocator, typename Layout> requires (std::floating_point<T>)
+eigh_result<T> eigh(const matrix<T, Allocator, Layout> &a) {
+#else
+template<typename T, typename Allocator, typename Layout>
+eigh_result<T> eigh(const matrix<T, Allocator, Layout> &a) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  if (a.rows() != a.cols())
+	throw std::logic_error("Eigenvalues can be found only for square matrices");
+
+  const std::size_t n = a.rows();
+  matrix<T> reduced(a);
+  std::vector<T> d(n), e(n), tau(n);
+
+  eigh_result<T> result{std::vector<T>(n), matrix<T>(n, n)};
+  if (n == 0)
+	return result;
+
+  detail::tridiagonalize(n, reduced.data(), n, d.data(), e.data(), tau.data());
+  detail::tridiagonal_divide(n, d.data(), e.data(), result.vectors.data(), n);
+  detail::sort_eigenpairs(n, d.data(), result.vectors.data(), n);
+  detail::tridiagonal_back_transform(n, reduced.data(), n, tau.data(), n, result.vectors.data(), n);
+
+  result.values = std::move(d);
+  return result;
+}
+
+/**
+ * The count largest eigenvalues and their eigenvectors in ascending order,
+ * the vectors are a.rows() x count. The tridiagonal problem and the back
+ * transformation cost O(n * count) and O(n^2 * count) instead of O(n^3),
+ * only the reduction to tridiagonal form stays O(n^3)
+ *
+ * @code
+ *
+ * mtlt::eigh_result<double> top = mtlt::eigh(covariance, 20); // Principal components
+ * top.values.back(); // The largest eigenvalue
+ *
+ * @endcode
+ */
+#if __cplusplus > 201703L
+template<typename T, typename Allocator, typename Layout> requires (std::floating_point<T>)
+eigh_result<T> eigh(const matrix<T, Allocator, Layout> &a, std::size_t count) {
+#else
+template<typename T, typename Allocator, typename Layout>
+eigh_result<T> eigh(const matrix<T, Allocator, Layout> &a, std::size_t count) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  if (a.rows() != a.cols())
+	throw std::logic_error("Eigenvalues can be found only for square matrices");
+
+  if (count > a.rows())
+	throw std::logic_error("Can't find eigenvalues because count > a.rows()");
+
+  const std::size_t n = a.rows();
+  matrix<T> reduced(a);
+  std::vector<T> d(n), e(n), tau(n);
+
+  eigh_result<T> result{std::vector<T>(count), matrix<T>(n, count)};
+  if (count == 0)
+	return result;
+
+  detail::tridiagonalize(n, reduced.data(), n, d.data(), e.data(), tau.data());
+  detail::tridiagonal_bisect(n, d.data(), e.data(), n - count, result.values.data(), result.vectors.data(), count);
+  detail::tridiagonal_back_transform(n, reduced.data(), n, tau.data(), count, result.vectors.data(), count);
+
+  return result;
+}
+
+/**
+ * Eigenvalues of the symmetric matrix a in ascending order without the eigenvectors,
+ * only the lower triangle of a is read
+ */
+#if __cplusplus > 201703L
+template<typename T, typename Allocator, typename Layout> requires (std::floating_point<T>)
+std::vector<T> eigvalsh(const matrix<T, Allocator, Layout> &a) {
+#else
+template<typename T, typename Allocator, typename Layout>
+std::vector<T> eigvalsh(const matrix<T, Allocator, Layout> &a) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  if (a.rows() != a.cols())
+	throw std::logic_error("Eigenvalues can be found only for square matrices");
+
+  const std::size_t n = a.rows();
+  matrix<T> reduced(a);
+  std::vector<T> d(n), e(n), tau(n);
+
+  if (n == 0)
+	return d;
+
+  detail::tridiagonalize(n, reduced.data(), n, d.data(), e.data(), tau.data());
+  e[n - 1] = T{};
+
+  if (!detail::tridiagonal_ql<T>(n, d.data(), e.data(), nullptr, 0))
+	throw std::logic_error("Can't find eigenvalues because the QL iteration did not converge");
+
+  std::sort(d.begin(), d.end());
+  return d;
+}
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_EIGEN_H_
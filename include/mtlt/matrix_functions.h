@@ -0,0 +1,299 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        Functions of square matrices: the integer power by repeated
+ *        squaring and the exponential by Pade approximation with scaling
+ *        and squaring. The static_matrix versions are evaluated
+ *        at compile time too
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_FUNCTIONS_H_
+#define MTLT_MATRIX_FUNCTIONS_H_
+
+#include <limits>
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_lu.h>
+#include <mtlt/static_matrix.h>
+#include <mtlt/matrix_config.h>
+
+namespace mtlt {
+
+namespace detail {
+
+template<typename Matrix>
+MATRIX_CXX17_CONSTEXPR typename Matrix::value_type one_norm(const Matrix &a) {
+  using value_type = typename Matrix::value_type;
+  value_type norm{};
+
+  for (std::size_t col = 0; col != a.cols(); ++col) {
+	value_type sum{};
+	for (std::size_t row = 0; row != a.rows(); ++row)
+	  sum += a(row, col) < value_type{} ? -a(row, col) : a(row, col);
+	norm = sum > norm ? sum : norm;
+  }
+
+  return norm;
+}
+
+/**
+ * Solves q * x = p of the Pade approximant
+ */
+template<typename T>
+matrix<T> pade_solve(const matrix<T> &q, const matrix<T> &p) {
+  return lu<T>(q).solve(p);
+}
+
+template<typename T, typename Allocator, typename Layout>
+matrix<T, Allocator, Layout> pade_solve(const matrix<T, Allocator, Layout> &q, const matrix<T, Allocator, Layout> &p) {
+  return matrix<T, Allocator, Layout>(lu<T>(q).solve(p), p.get_allocator());
+}
+
+/**
+ * Gauss-Jordan elimination with partial pivoting, usable in constant expressions.
+ * The denominator of the Pade approximant is well conditioned after scaling
+ */
+template<typename T, std::size_t N>
+MATRIX_CXX17_CONSTEXPR static_matrix<T, N, N> pade_solve(static_matrix<T, N, N> q, static_matrix<T, N, N> p) {
+  for (std::size_t k = 0; k != N; ++k) {
+	std::size_t pivot_row = k;
+	for (std::size_t row = k + 1; row != N; ++row) {
+	  const T candidate = q(row, k) < T{} ? -q(row, k) : q(row, k);
+	  const T pivot = q(pivot_row, k) < T{} ? -q(pivot_row, k) : q(pivot_row, k);
+	  if (candidate > pivot)
+		pivot_row = row;
+	}
+
+	if (pivot_row != k) {
+	  q.swap_rows(k, pivot_row);
+	  p.swap_rows(k, pivot_row);
+	}
+
+	const T pivot = q(k, k);
+	for (std::size_t row = 0; row != N; ++row) {
+	  if (row == k)
+		continue;
+
+	  const T factor = q(row, k) / pivot;
+	  for (std::size_t col = k; col != N; ++col)
+		q(row, col) -= factor * q(k, col);
+	  for (std::size_t col = 0; col != N; ++col)
+		p(row, col) -= factor * p(k, col);
+	}
+  }
+
+  for (std::size_t row = 0; row != N; ++row)
+	for (std::size_t col = 0; col != N; ++col)
+	  p(row, col) /= q(row, row);
+
+  return p;
+}
+
+/**
+ * Scaling and squaring with the [m/m] Pade approximant (Higham, 2005).
+ * The degree m is the smallest one of 3, 5, 7, 9, 13 whose error bound
+ * holds for the 1-norm of a, above the bound of 13 the matrix is scaled
+ * by 2^-s and the approximant is squared s times
+ */
+template<typename Matrix>
+MATRIX_CXX17_CONSTEXPR Matrix expm(const Matrix &a, const Matrix &identity) {
+  using value_type = typename Matrix::value_type;
+
+  const double theta[] = {1.495585217958292e-2, 2.539398330063230e-1, 9.504178996162932e-1,
+						  2.097847961257068e0, 5.371920351148152e0};
+  const double b3[] = {120, 60, 12, 1};
+  const double b5[] = {30240, 15120, 3360, 420, 30, 1};
+  const double b7[] = {17297280, 8648640, 1995840, 277200, 25200, 1512, 56, 1};
+  const double b9[] = {17643225600., 8821612800., 2075673600., 302702400., 30270240.,
+					   2162160., 110880., 3960., 90., 1.};
+  const double b13[] = {64764752532480000., 32382376266240000., 7771770303897600.,
+						1187353796428800., 129060195264000., 10559470521600.,
+						670442572800., 33522128640., 1323241920., 40840800., 960960., 16380., 182., 1.};
+
+  const double norm = static_cast<double>(one_norm(a));
+  if (!(norm <= std::numeric_limits<double>::max()))
+	throw std::logic_error("Matrix exponential can be found only for matrices with a finite norm");
+
+  const double *low_degree[] = {b3, b5, b7, b9};
+
+  for (std::size_t i = 0; i != 4; ++i) {
+	if (norm <= theta[i]) {
+	  const double *b = low_degree[i];
+	  const std::size_t degree = 2 * i + 3;
+
+	  const Matrix a2 = a * a;
+	  Matrix power = identity;
+	  Matrix odd = identity * static_cast<value_type>(b[1]);
+	  Matrix even = identity * static_cast<value_type>(b[0]);
+	  for (std::size_t j = 2; j < degree; j += 2) {
+		power = power * a2;
+		odd = odd + power * static_cast<value_type>(b[j + 1]);
+		even = even + power * static_cast<value_type>(b[j]);
+	  }
+
+	  const Matrix u = a * odd;
+	  return pade_solve(even - u, even + u);
+	}
+  }
+
+  // The norm is finite, so it is halved below the bound in at most ~1030 steps.
+  // A loop instead of std::frexp keeps expm usable in constant expressions
+  std::size_t squarings = 0;
+  value_type scale = value_type(1);
+  for (double scaled = norm; scaled > theta[4]; scaled /= 2) {
+	scale /= 2;
+	++squarings;
+  }
+
+  const Matrix scaled = a * scale;
+  const Matrix a2 = scaled * scaled;
+  const Matrix a4 = a2 * a2;
+  const Matrix a6 = a4 * a2;
+
+  const Matrix u = scaled * (a6 * (a6 * static_cast<value_type>(b13[13]) + a4 * static_cast<value_type>(b13[11]) +
+								 a2 * static_cast<value_type>(b13[9])) +
+							 a6 * static_cast<value_type>(b13[7]) + a4 * static_cast<value_type>(b13[5]) +
+							 a2 * static_cast<value_type>(b13[3]) + identity * static_cast<value_type>(b13[1]));
+  const Matrix v = a6 * (a6 * static_cast<value_type>(b13[12]) + a4 * static_cast<value_type>(b13[10]) +
+						 a2 * static_cast<value_type>(b13[8])) +
+				   a6 * static_cast<value_type>(b13[6]) + a4 * static_cast<value_type>(b13[4]) +
+				   a2 * static_cast<value_type>(b13[2]) + identity * static_cast<value_type>(b13[0]);
+
+  Matrix result = pade_solve(v - u, v + u);
+  for (std::size_t i = 0; i != squarings; ++i)
+	result = result * result;
+
+  return result;
+}
+
+} // namespace detail end
+
+/**
+ * a^k by repeated squaring: O(log k) products on the multiplication engine
+ * instead of k, three buffers are allocated once and reused. The result has
+ * the allocator and the layout of a
+ *
+ * @code
+ *
+ * mtlt::matrix<double> transition(100, 100);
+ * mtlt::matrix<double> after_steps = mtlt::pow(transition, 1000); // 15 products
+ *
+ * mtlt::matrix<long long> adjacency(50, 50);
+ * mtlt::matrix<long long> walks = mtlt::pow(adjacency, 6); // Walks of length 6
+ *
+ * @endcode
+ */
+template<typename T, typename Allocator, typename Layout>
+matrix<T, Allocator, Layout> pow(const matrix<T, Allocator, Layout> &a, std::size_t k) {
+  using matrix_type = matrix<T, Allocator, Layout>;
+
+  if (a.rows() != a.cols())
+	throw std::logic_error("Matrix power can be found only for square matrices");
+
+  const std::size_t n = a.rows();
+  if (k == 0)
+	return matrix_type::identity(n, n, a.get_allocator());
+
+  matrix_type base(a), result(a.get_allocator()), scratch(n, n, uninitialized, a.get_allocator());
+  bool first = true;
+
+  while (true) {
+	if (k & 1) {
+	  if (first) {
+		result = base;
+		first = false;
+	  } else {
+		gemm(T(1), result, base, T{}, scratch);
+		std::swap(result, scratch);
+	  }
+	}
+
+	k >>= 1;
+	if (k == 0)
+	  break;
+
+	gemm(T(1), base, base, T{}, scratch);
+	std::swap(base, scratch);
+  }
+
+  return result;
+}
+
+template<typename T, std::size_t N>
+MATRIX_CXX17_CONSTEXPR
+static_matrix<T, N, N> pow(const static_matrix<T, N, N> &a, std::size_t k) {
+  static_matrix<T, N, N> result = a.identity(), base = a;
+
+  while (k != 0) {
+	if (k & 1)
+	  result = result * base;
+	k >>= 1;
+	if (k != 0)
+	  base = base * base;
+  }
+
+  return result;
+}
+
+/**
+ * Matrix exponential e^a by Pade approximation with scaling and squaring,
+ * at most 6 products and one LU solve plus a squaring per doubling of the norm.
+ * The result of a dynamic matrix has the allocator and the layout of a
+ *
+ * @code
+ *
+ * mtlt::matrix<double> generator(20, 20); // Rates of a continuous time Markov chain
+ * mtlt::matrix<double> transition = mtlt::expm(generator * t);
+ *
+ * constexpr mtlt::static_matrix<double, 2, 2> rotation = mtlt::expm(mtlt::static_matrix<double, 2, 2>({0, -1, 1, 0}));
+ *
+ * @endcode
+ */
+#if __cplusplus > 201703L
+template<typename T, typename Allocator, typename Layout> requires (std::floating_point<T>)
+matrix<T, Allocator, Layout> expm(const matrix<T, Allocator, Layout> &a) {
+#else
+template<typename T, typename Allocator, typename Layout>
+matrix<T, Allocator, Layout> expm(const matrix<T, Allocator, Layout> &a) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  if (a.rows() != a.cols())
+	throw std::logic_error("Matrix exponential can be found only for square matrices");
+
+  return detail::expm(a, matrix<T, Allocator, Layout>::identity(a.rows(), a.cols(), a.get_allocator()));
+}
+
+#if __cplusplus > 201703L
+template<typename T, std::size_t N> requires (std::floating_point<T>)
+MATRIX_CXX17_CONSTEXPR static_matrix<T, N, N> expm(const static_matrix<T, N, N> &a) {
+#else
+template<typename T, std::size_t N>
+MATRIX_CXX17_CONSTEXPR
+static_matrix<T, N, N> expm(const static_matrix<T, N, N> &a) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  return detail::expm(a, a.identity());
+}
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_FUNCTIONS_H_
@@ -0,0 +1,598 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        The matrix multiplication engine packs panels of lhs and rhs
+ *        into cache sized blocks and runs a register blocked micro kernel
+ *        over them, it is used by matrix::mul for fundamental types
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_GEMM_H_
+#define MTLT_MATRIX_GEMM_H_
+
+#include <memory>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#include <mtlt/matrix_config.h>
+#include <mtlt/matrix_kernels.h>
+#include <mtlt/thread_pool.h>
+
+namespace mtlt {
+
+/**
+ * @struct cache_info
+ *
+ * Sizes of the data caches in bytes. The multiplication engine
+ * chooses its block sizes so that the packed micro panels stay in L1,
+ * the packed lhs block stays in L2 and the packed rhs block stays in L3
+ *
+ * @code
+ *
+ * mtlt::cache_info info = mtlt::get_cache_info();
+ * info.l2 = 1024 * 1024;
+ * mtlt::set_cache_info(info); // Not thread safe, call before multiplications
+ *
+ * @endcode
+ */
+struct cache_info {
+  std::size_t l1 = 32 * 1024;
+  std::size_t l2 = 256 * 1024;
+  std::size_t l3 = 8 * 1024 * 1024;
+};
+
+namespace detail {
+
+inline cache_info detect_cache_info() {
+  cache_info info;
+
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+  const long l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+  const long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  const long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+
+  if (l1 > 0)
+	info.l1 = static_cast<std::size_t>(l1);
+  if (l2 > 0)
+	info.l2 = static_cast<std::size_t>(l2);
+  if (l3 > 0)
+	info.l3 = static_cast<std::size_t>(l3);
+#endif
+
+  return info;
+}
+
+inline cache_info &cache_info_storage() {
+  static cache_info info = detect_cache_info();
+  return info;
+}
+
+} // namespace detail end
+
+inline cache_info get_cache_info() {
+  return detail::cache_info_storage();
+}
+
+inline void set_cache_info(const cache_info &info) {
+  detail::cache_info_storage() = info;
+}
+
+/**
+ * @struct plus_times
+ *
+ * Semiring of the ordinary arithmetic, the engine computes products
+ * over it unless another semiring is given (see matrix_semiring.h).
+ * A semiring is a type with static zero(), one(), add(x, y) and mul(x, y),
+ * zero() is the identity of add and one() is the identity of mul
+ */
+template<typename T>
+struct plus_times {
+  using value_type = T;
+
+  static constexpr T zero() { return T{}; }
+  static constexpr T one() { return T(1); }
+  static T add(const T &x, const T &y) { return x + y; }
+  static T mul(const T &x, const T &y) { return x * y; }
+};
+
+namespace detail {
+
+/**
+ * @struct is_gemm_compatible
+ *
+ * Checks that the product of matrix<T> and matrix<U> can be computed
+ * by the blocked engine, otherwise the naive loop is used
+ */
+template<typename T, typename U>
+struct is_gemm_compatible : std::integral_constant<bool,
+												   std::is_same<T, U>::value &&
+													   std::is_arithmetic<T>::value &&
+													   !std::is_same<T, bool>::value> {
+};
+
+/**
+ * Products with m * n * k below this value are computed by the
+ * plain i-k-j loop, packing does not pay off for them
+ */
+MATRIX_CXX17_INLINE constexpr std::size_t gemm_naive_threshold = 32 * 32 * 32;
+
+/**
+ * Products with m * n * k above this value are split into tiles
+ * of the result and computed on the library thread pool
+ */
+MATRIX_CXX17_INLINE constexpr std::size_t gemm_parallel_threshold = 128 * 128 * 128;
+
+/**
+ * Matrix vector products over more than this number of matrix items
+ * are split between the threads of the library pool
+ */
+MATRIX_CXX17_INLINE constexpr std::size_t gemv_parallel_threshold = 512 * 512;
+
+template<typename T>
+class aligned_buffer {
+public:
+  static constexpr std::size_t alignment = 64;
+
+public:
+  T *reserve(std::size_t count) {
+	if (count <= capacity_)
+	  return data_;
+
+	std::size_t space = count * sizeof(T) + alignment;
+	storage_.reset(new unsigned char[space]);
+
+	void *ptr = storage_.get();
+	data_ = static_cast<T *>(std::align(alignment, count * sizeof(T), ptr, space));
+	capacity_ = count;
+
+	return data_;
+  }
+
+private:
+  std::unique_ptr<unsigned char[]> storage_;
+  T *data_ = nullptr;
+  std::size_t capacity_ = 0;
+};
+
+template<typename T>
+struct gemm_workspace {
+  aligned_buffer<T> a, b, c;
+};
+
+template<typename T>
+gemm_workspace<T> &local_gemm_workspace() {
+  static thread_local gemm_workspace<T> workspace;
+  return workspace;
+}
+
+struct gemm_blocking {
+  std::size_t mc;
+  std::size_t kc;
+  std::size_t nc;
+};
+
+template<typename T>
+gemm_blocking make_gemm_blocking(std::size_t mr, std::size_t nr) {
+  const cache_info cache = get_cache_info();
+
+  // Micro panel of b is reused by every micro panel of a,
+  // so it takes most of L1 and micro panels of a stream through the rest
+  std::size_t kc = cache.l1 * 3 / 4 / (nr * sizeof(T));
+  kc = std::min<std::size_t>(std::max<std::size_t>(kc, 64), 512) / 8 * 8;
+
+  // Packed block of a takes half of L2
+  std::size_t mc = cache.l2 / 2 / (kc * sizeof(T));
+  mc = std::max<std::size_t>(std::min<std::size_t>(mc, 1024) / mr, 1) * mr;
+
+  // Packed block of b takes half of L3
+  std::size_t nc = cache.l3 / 2 / (kc * sizeof(T));
+  nc = std::max<std::size_t>(std::min<std::size_t>(nc, 4096) / nr, 1) * nr;
+
+  return {mc, kc, nc};
+}
+
+/**
+ * @struct gemm_operand
+ *
+ * Operand of the engine, the item (row, col) is data[row * row_stride + col * col_stride].
+ * Transposed row major storage is the same storage with swapped strides,
+ * so the packing routines read it in place
+ */
+template<typename T>
+struct gemm_operand {
+  const T *data;
+  std::size_t row_stride;
+  std::size_t col_stride;
+
+  const T &operator()(std::size_t row, std::size_t col) const {
+	return data[row * row_stride + col * col_stride];
+  }
+
+  gemm_operand block(std::size_t row, std::size_t col) const {
+	return {data + row * row_stride + col * col_stride, row_stride, col_stride};
+  }
+};
+
+/**
+ * Describes row major storage with leading dimension ld, or its transpose
+ */
+template<typename T>
+gemm_operand<T> make_gemm_operand(const T *data, std::size_t ld, bool transposed = false) {
+  if (transposed)
+	return {data, 1, ld};
+  return {data, ld, 1};
+}
+
+template<typename T, typename Semiring>
+void gemm_pack_a(std::size_t mc, std::size_t kc, const gemm_operand<T> &a, const T &alpha, std::size_t mr, T *packed,
+				 const Semiring &) {
+  const bool scaled = alpha != Semiring::one();
+
+  for (std::size_t ir = 0; ir < mc; ir += mr) {
+	const std::size_t rows = std::min(mr, mc - ir);
+
+	for (std::size_t p = 0; p != kc; ++p) {
+	  const T *col = &a(ir, p);
+	  if (scaled) {
+		for (std::size_t i = 0; i != rows; ++i)
+		  *packed++ = Semiring::mul(alpha, col[i * a.row_stride]);
+	  } else {
+		for (std::size_t i = 0; i != rows; ++i)
+		  *packed++ = col[i * a.row_stride];
+	  }
+	  for (std::size_t i = rows; i != mr; ++i)
+		*packed++ = T{};
+	}
+  }
+}
+
+template<typename T>
+void gemm_pack_b(std::size_t kc, std::size_t nc, const gemm_operand<T> &b, std::size_t nr, T *packed) {
+  for (std::size_t jr = 0; jr < nc; jr += nr) {
+	const std::size_t cols = std::min(nr, nc - jr);
+
+	for (std::size_t p = 0; p != kc; ++p) {
+	  const T *row = &b(p, jr);
+	  if (b.col_stride == 1) {
+		for (std::size_t j = 0; j != cols; ++j)
+		  *packed++ = row[j];
+	  } else {
+		for (std::size_t j = 0; j != cols; ++j)
+		  *packed++ = row[j * b.col_stride];
+	  }
+	  for (std::size_t j = cols; j != nr; ++j)
+		*packed++ = T{};
+	}
+  }
+}
+
+/**
+ * Packing of operands which compute their items (e.g. widen and shift
+ * quantized values), the items are converted to T while they are packed
+ */
+template<typename T, typename Operand, typename Semiring>
+void gemm_pack_a(std::size_t mc, std::size_t kc, const Operand &a, const T &alpha, std::size_t mr, T *packed,
+				 const Semiring &) {
+  for (std::size_t ir = 0; ir < mc; ir += mr) {
+	const std::size_t rows = std::min(mr, mc - ir);
+
+	for (std::size_t p = 0; p != kc; ++p) {
+	  for (std::size_t i = 0; i != rows; ++i)
+		*packed++ = Semiring::mul(alpha, static_cast<T>(a(ir + i, p)));
+	  for (std::size_t i = rows; i != mr; ++i)
+		*packed++ = T{};
+	}
+  }
+}
+
+template<typename T, typename Operand>
+void gemm_pack_b(std::size_t kc, std::size_t nc, const Operand &b, std::size_t nr, T *packed) {
+  for (std::size_t jr = 0; jr < nc; jr += nr) {
+	const std::size_t cols = std::min(nr, nc - jr);
+
+	for (std::size_t p = 0; p != kc; ++p) {
+	  for (std::size_t j = 0; j != cols; ++j)
+		*packed++ = static_cast<T>(b(p, jr + j));
+	  for (std::size_t j = cols; j != nr; ++j)
+		*packed++ = T{};
+	}
+  }
+}
+
+template<typename T, typename Semiring>
+void gemm_macro_kernel(const gemm_kernel<T> &kernel, std::size_t mc, std::size_t nc, std::size_t kc,
+					   const T *packed_a, const T *packed_b, T *c, std::size_t ldc, T *edge, const Semiring &) {
+  const std::size_t mr = kernel.mr, nr = kernel.nr;
+
+  for (std::size_t jr = 0; jr < nc; jr += nr) {
+	const std::size_t cols = std::min(nr, nc - jr);
+
+	for (std::size_t ir = 0; ir < mc; ir += mr) {
+	  const std::size_t rows = std::min(mr, mc - ir);
+	  const T *a = packed_a + ir * kc;
+	  const T *b = packed_b + jr * kc;
+	  T *tile = c + ir * ldc + jr;
+
+	  if (rows == mr && cols == nr) {
+		kernel.function(kc, a, b, tile, ldc);
+		continue;
+	  }
+
+	  std::fill(edge, edge + mr * nr, Semiring::zero());
+	  kernel.function(kc, a, b, edge, nr);
+
+	  for (std::size_t i = 0; i != rows; ++i)
+		for (std::size_t j = 0; j != cols; ++j)
+		  tile[i * ldc + j] = Semiring::add(tile[i * ldc + j], edge[i * nr + j]);
+	}
+  }
+}
+
+template<typename T, typename OperandA, typename OperandB, typename Semiring>
+void gemm_naive(std::size_t m, std::size_t n, std::size_t k,
+				const OperandA &a, const OperandB &b, T *c, std::size_t ldc, const T &alpha, const Semiring &) {
+  for (std::size_t i = 0; i != m; ++i) {
+	T *c_row = c + i * ldc;
+
+	for (std::size_t p = 0; p != k; ++p) {
+	  const T a_item = Semiring::mul(alpha, static_cast<T>(a(i, p)));
+	  for (std::size_t j = 0; j != n; ++j)
+		c_row[j] = Semiring::add(c_row[j], Semiring::mul(a_item, static_cast<T>(b(p, j))));
+	}
+  }
+}
+
+template<typename T>
+void gemm_naive(std::size_t m, std::size_t n, std::size_t k,
+				const gemm_operand<T> &a, const gemm_operand<T> &b, T *c, std::size_t ldc, const T &alpha,
+				const plus_times<T> &) {
+  for (std::size_t i = 0; i != m; ++i) {
+	T *c_row = c + i * ldc;
+
+	for (std::size_t p = 0; p != k; ++p) {
+	  const T a_item = alpha * a(i, p);
+	  const T *b_row = &b(p, 0);
+
+	  if (b.col_stride == 1) {
+		for (std::size_t j = 0; j != n; ++j)
+		  c_row[j] += a_item * b_row[j];
+	  } else {
+		for (std::size_t j = 0; j != n; ++j)
+		  c_row[j] += a_item * b_row[j * b.col_stride];
+	  }
+	}
+  }
+}
+
+/**
+ * Micro kernel of a semiring, the ordinary arithmetic has its own kernels
+ */
+template<typename T, typename Semiring>
+const gemm_kernel<T> &select_gemm_kernel(const Semiring &) {
+  return select_semiring_kernel<T, Semiring>();
+}
+
+template<typename T>
+const gemm_kernel<T> &select_gemm_kernel(const plus_times<T> &) {
+  return select_gemm_kernel<T>();
+}
+
+template<typename T, typename OperandA, typename OperandB, typename Semiring>
+void gemm_blocked(std::size_t m, std::size_t n, std::size_t k,
+				  const OperandA &a, const OperandB &b, T *c, std::size_t ldc, const T &alpha,
+				  const Semiring &semiring) {
+  const gemm_kernel<T> &kernel = select_gemm_kernel<T>(semiring);
+  const gemm_blocking blocking = make_gemm_blocking<T>(kernel.mr, kernel.nr);
+  const std::size_t mr = kernel.mr, nr = kernel.nr;
+
+  const std::size_t max_mc = (std::min(m, blocking.mc) + mr - 1) / mr * mr;
+  const std::size_t max_nc = (std::min(n, blocking.nc) + nr - 1) / nr * nr;
+  const std::size_t max_kc = std::min(k, blocking.kc);
+
+  gemm_workspace<T> &workspace = local_gemm_workspace<T>();
+  T *packed_a = workspace.a.reserve(max_mc * max_kc);
+  T *packed_b = workspace.b.reserve(max_nc * max_kc);
+  T *edge = workspace.c.reserve(mr * nr);
+
+  for (std::size_t jc = 0; jc < n; jc += blocking.nc) {
+	const std::size_t nc = std::min(blocking.nc, n - jc);
+
+	for (std::size_t pc = 0; pc < k; pc += blocking.kc) {
+	  const std::size_t kc = std::min(blocking.kc, k - pc);
+	  gemm_pack_b(kc, nc, b.block(pc, jc), nr, packed_b);
+
+	  for (std::size_t ic = 0; ic < m; ic += blocking.mc) {
+		const std::size_t mc = std::min(blocking.mc, m - ic);
+		gemm_pack_a(mc, kc, a.block(ic, pc), alpha, mr, packed_a, semiring);
+		gemm_macro_kernel(kernel, mc, nc, kc, packed_a, packed_b, c + ic * ldc + jc, ldc, edge, semiring);
+	  }
+	}
+  }
+}
+
+template<typename T, typename OperandA, typename OperandB, typename Semiring>
+void gemm_parallel(std::size_t m, std::size_t n, std::size_t k,
+				   const OperandA &a, const OperandB &b, T *c, std::size_t ldc, const T &alpha,
+				   const Semiring &semiring, std::size_t threads) {
+  const gemm_kernel<T> &kernel = select_gemm_kernel<T>(semiring);
+  const gemm_blocking blocking = make_gemm_blocking<T>(kernel.mr, kernel.nr);
+
+  // Tiles of c are independent, there are several tiles per thread
+  // so that threads which finish early steal the rest of the work
+  std::size_t tile_m = std::min(blocking.mc, m), tile_n = std::min(blocking.nc, n);
+  const std::size_t min_tile_m = 4 * kernel.mr, min_tile_n = 8 * kernel.nr;
+
+  for (;;) {
+	const std::size_t tiles = ((m + tile_m - 1) / tile_m) * ((n + tile_n - 1) / tile_n);
+	if (tiles >= 4 * threads)
+	  break;
+
+	if (tile_n >= tile_m && tile_n >= 2 * min_tile_n)
+	  tile_n = (tile_n / 2 + kernel.nr - 1) / kernel.nr * kernel.nr;
+	else if (tile_m >= 2 * min_tile_m)
+	  tile_m = (tile_m / 2 + kernel.mr - 1) / kernel.mr * kernel.mr;
+	else
+	  break;
+  }
+
+  const std::size_t tiles_m = (m + tile_m - 1) / tile_m;
+  const std::size_t tiles_n = (n + tile_n - 1) / tile_n;
+
+  parallel_for(tiles_m * tiles_n, [=](std::size_t tile) {
+	const std::size_t row = tile / tiles_n * tile_m;
+	const std::size_t col = tile % tiles_n * tile_n;
+
+	gemm_blocked(std::min(tile_m, m - row), std::min(tile_n, n - col), k,
+				 a.block(row, 0), b.block(0, col),
+				 c + row * ldc + col, ldc, alpha, semiring);
+  });
+}
+
+/**
+ * Computes c(m x n) += alpha * a(m x k) * b(k x n), a and b may be strided
+ * (e.g. transposed) or computed operands with items convertible to T,
+ * c is row major with leading dimension ldc.
+ * Alpha is applied while a is packed, so it costs no extra pass.
+ * With a semiring the sum and the product are Semiring::add and Semiring::mul
+ */
+template<typename T, typename OperandA, typename OperandB, typename Semiring = plus_times<T>>
+void gemm_accumulate(std::size_t m, std::size_t n, std::size_t k,
+					 const OperandA &a, const OperandB &b, T *c, std::size_t ldc,
+					 const T &alpha = Semiring::one(), const Semiring &semiring = Semiring()) {
+  if (m == 0 || n == 0 || k == 0)
+	return;
+
+  const std::size_t work = m * n * k;
+
+  if (work <= gemm_naive_threshold) {
+	gemm_naive(m, n, k, a, b, c, ldc, alpha, semiring);
+	return;
+  }
+
+  const std::size_t threads = work > gemm_parallel_threshold ? get_num_threads() : 1;
+  if (threads > 1)
+	gemm_parallel(m, n, k, a, b, c, ldc, alpha, semiring, threads);
+  else
+	gemm_blocked(m, n, k, a, b, c, ldc, alpha, semiring);
+}
+
+/**
+ * Computes c(m x n) += a(m x k) * b(k x n) for row major operands
+ * with leading dimensions lda, ldb and ldc
+ */
+template<typename T>
+void gemm_accumulate(std::size_t m, std::size_t n, std::size_t k,
+					 const T *a, std::size_t lda, const T *b, std::size_t ldb, T *c, std::size_t ldc) {
+  gemm_accumulate(m, n, k, make_gemm_operand(a, lda), make_gemm_operand(b, ldb), c, ldc);
+}
+
+template<typename T>
+void gemv_rows(std::size_t m, std::size_t n, const T *a, std::size_t lda,
+			   const T *x, const T &alpha, T *y, const gemv_kernel<T> &kernel) {
+  std::size_t i = 0;
+  for (; i + kernel.mr <= m; i += kernel.mr)
+	kernel.gemv(n, a + i * lda, lda, x, alpha, y + i);
+
+  for (; i != m; ++i) {
+	T sum{};
+	for (std::size_t j = 0; j != n; ++j)
+	  sum += a[i * lda + j] * x[j];
+	y[i] += alpha * sum;
+  }
+}
+
+template<typename T>
+void gevm_rows(std::size_t m, std::size_t n, const T *a, std::size_t lda,
+			   const T *x, const T &alpha, T *y, const gemv_kernel<T> &kernel) {
+  std::size_t i = 0;
+  for (; i + kernel.mr <= m; i += kernel.mr)
+	kernel.gevm(n, a + i * lda, lda, x + i, alpha, y);
+
+  for (; i != m; ++i) {
+	const T item = alpha * x[i];
+	for (std::size_t j = 0; j != n; ++j)
+	  y[j] += item * a[i * lda + j];
+  }
+}
+
+/**
+ * Computes y(m) += alpha * a(m x n) * x(n), tall matrices are split
+ * by rows between the threads, every thread writes its own part of y
+ */
+template<typename T>
+void gemv_accumulate(std::size_t m, std::size_t n, const T *a, std::size_t lda,
+					 const T *x, T *y, const T &alpha = T(1)) {
+  if (m == 0 || n == 0)
+	return;
+
+  const gemv_kernel<T> &kernel = select_gemv_kernel<T>();
+  const std::size_t threads = m * n > gemv_parallel_threshold ? get_num_threads() : 1;
+
+  if (threads == 1 || m < 2 * kernel.mr) {
+	gemv_rows(m, n, a, lda, x, alpha, y, kernel);
+	return;
+  }
+
+  const std::size_t chunks = std::min(4 * threads, m / kernel.mr);
+  const std::size_t chunk = (m / chunks + kernel.mr - 1) / kernel.mr * kernel.mr;
+
+  parallel_for((m + chunk - 1) / chunk, [=, &kernel](std::size_t task) {
+	const std::size_t row = task * chunk;
+	gemv_rows(std::min(chunk, m - row), n, a + row * lda, lda, x, alpha, y + row, kernel);
+  });
+}
+
+/**
+ * Computes y(n) += alpha * x(m) * a(m x n), wide matrices are split
+ * by columns between the threads, every thread writes its own part of y
+ */
+template<typename T>
+void gevm_accumulate(std::size_t m, std::size_t n, const T *a, std::size_t lda,
+					 const T *x, T *y, const T &alpha = T(1)) {
+  if (m == 0 || n == 0)
+	return;
+
+  const gemv_kernel<T> &kernel = select_gemv_kernel<T>();
+  const std::size_t threads = m * n > gemv_parallel_threshold ? get_num_threads() : 1;
+
+  // Columns are split in multiples of a cache line
+  const std::size_t line = std::max<std::size_t>(64 / sizeof(T), 1);
+
+  if (threads == 1 || n < 2 * line) {
+	gevm_rows(m, n, a, lda, x, alpha, y, kernel);
+	return;
+  }
+
+  const std::size_t chunks = std::min(4 * threads, n / line);
+  const std::size_t chunk = (n / chunks + line - 1) / line * line;
+
+  parallel_for((n + chunk - 1) / chunk, [=, &kernel](std::size_t task) {
+	const std::size_t col = task * chunk;
+	gevm_rows(m, std::min(chunk, n - col), a + col, lda, x, alpha, y + col, kernel);
+  });
+}
+
+} // namespace detail end
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_GEMM_H_
@@ -0,0 +1,1023 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        The matrix kernels header contains micro kernels of the
+ *        multiplication engine. Vector kernels for float, double and int32
+ *        are written for SSE2, AVX2 and AVX-512 and the best one is picked
+ *        at runtime from CPUID, so one binary runs well on every x86 host
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_KERNELS_H_
+#define MTLT_MATRIX_KERNELS_H_
+
+#include <atomic>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#include <mtlt/matrix_config.h>
+
+#if !defined(MATRIX_DISABLE_SIMD) && (defined(__GNUC__) || defined(__clang__)) && \
+	(defined(__x86_64__) || defined(__i386__))
+#  define MATRIX_X86_KERNELS 1
+#  include <immintrin.h>
+#  define MATRIX_TARGET_SSE2 __attribute__((target("sse2")))
+#  define MATRIX_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#  define MATRIX_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+namespace mtlt {
+
+/**
+ * @enum simd_level
+ *
+ * Instruction sets the multiplication kernels are written for.
+ * The level is detected once from CPUID, it can be lowered with
+ * set_simd_level, e.g. to compare results between hosts
+ *
+ * @code
+ *
+ * mtlt::set_simd_level(mtlt::simd_level::avx2); // AVX-512 kernels are not used anymore
+ * mtlt::set_simd_level(mtlt::detected_simd_level()); // Back to the best kernels
+ *
+ * @endcode
+ */
+enum class simd_level : int {
+  generic = 0,
+  sse2 = 1,
+  avx2 = 2,
+  avx512 = 3
+};
+
+namespace detail {
+
+inline simd_level detect_simd_level() {
+#if defined(MATRIX_X86_KERNELS)
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx512f"))
+	return simd_level::avx512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+	return simd_level::avx2;
+  if (__builtin_cpu_supports("sse2"))
+	return simd_level::sse2;
+#endif
+
+  return simd_level::generic;
+}
+
+inline std::atomic<simd_level> &simd_level_storage() {
+  static std::atomic<simd_level> level(detect_simd_level());
+  return level;
+}
+
+} // namespace detail end
+
+inline simd_level detected_simd_level() {
+  static const simd_level level = detail::detect_simd_level();
+  return level;
+}
+
+inline simd_level get_simd_level() {
+  return detail::simd_level_storage().load(std::memory_order_relaxed);
+}
+
+/**
+ * Sets level of kernels used by multiplications,
+ * levels above detected_simd_level() are clamped to it
+ */
+inline void set_simd_level(simd_level level) {
+  if (static_cast<int>(level) > static_cast<int>(detected_simd_level()))
+	level = detected_simd_level();
+
+  detail::simd_level_storage().store(level, std::memory_order_relaxed);
+}
+
+namespace detail {
+
+/**
+ * @struct gemm_kernel
+ *
+ * Micro kernel computes c(mr x nr) += a(mr x kc) * b(kc x nr),
+ * where a is packed by columns of mr items and b is packed by rows of nr items
+ */
+template<typename T>
+struct gemm_kernel {
+  using function_type = void (*)(std::size_t kc, const T *a, const T *b, T *c, std::size_t ldc);
+
+  std::size_t mr;
+  std::size_t nr;
+  function_type function;
+};
+
+template<typename T, std::size_t MR, std::size_t NR>
+void gemm_generic_kernel(std::size_t kc, const T *a, const T *b, T *c, std::size_t ldc) {
+  T acc[MR * NR]{};
+
+  for (std::size_t p = 0; p != kc; ++p, a += MR, b += NR)
+	for (std::size_t i = 0; i != MR; ++i)
+	  for (std::size_t j = 0; j != NR; ++j)
+		acc[i * NR + j] += a[i] * b[j];
+
+  for (std::size_t i = 0; i != MR; ++i)
+	for (std::size_t j = 0; j != NR; ++j)
+	  c[i * ldc + j] += acc[i * NR + j];
+}
+
+template<typename T>
+gemm_kernel<T> generic_gemm_kernel() {
+  return sizeof(T) <= 4 ? gemm_kernel<T>{4, 8, &gemm_generic_kernel<T, 4, 8>}
+						: gemm_kernel<T>{4, 4, &gemm_generic_kernel<T, 4, 4>};
+}
+
+/**
+ * Micro kernel over a semiring: the sums and the products of
+ * c(mr x nr) += a(mr x kc) * b(kc x nr) are Semiring::add and Semiring::mul
+ */
+template<typename T, typename Semiring, std::size_t MR, std::size_t NR>
+void semiring_generic_kernel(std::size_t kc, const T *a, const T *b, T *c, std::size_t ldc) {
+  T acc[MR * NR];
+  std::fill(acc, acc + MR * NR, Semiring::zero());
+
+  for (std::size_t p = 0; p != kc; ++p, a += MR, b += NR)
+	for (std::size_t i = 0; i != MR; ++i)
+	  for (std::size_t j = 0; j != NR; ++j)
+		acc[i * NR + j] = Semiring::add(acc[i * NR + j], Semiring::mul(a[i], b[j]));
+
+  for (std::size_t i = 0; i != MR; ++i)
+	for (std::size_t j = 0; j != NR; ++j)
+	  c[i * ldc + j] = Semiring::add(c[i * ldc + j], acc[i * NR + j]);
+}
+
+template<typename T, typename Semiring>
+gemm_kernel<T> generic_semiring_kernel() {
+  return sizeof(T) <= 4 ? gemm_kernel<T>{4, 8, &semiring_generic_kernel<T, Semiring, 4, 8>}
+						: gemm_kernel<T>{4, 4, &semiring_generic_kernel<T, Semiring, 4, 4>};
+}
+
+/**
+ * Semirings which have vector kernels: min_plus is (min, +), max_plus is (max, +) and max_min is (max, min)
+ */
+enum class semiring_op {
+  min_plus,
+  max_plus,
+  max_min
+};
+
+/**
+ * Infinities of T used as identities of min and max,
+ * types without infinity use their largest and lowest values
+ */
+template<typename T>
+constexpr T positive_infinity() {
+  return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+}
+
+template<typename T>
+constexpr T negative_infinity() {
+  return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+}
+
+/**
+ * @struct simd_semiring
+ *
+ * Specializations tell which vector kernel a semiring uses
+ * by a static member op of type semiring_op
+ */
+template<typename Semiring>
+struct simd_semiring : std::false_type {};
+
+/**
+ * @struct gemv_kernel
+ *
+ * Matrix vector kernels work on mr rows of a row major a at once, so every
+ * load of x (or of y) is shared by mr rows:
+ * gemv computes y(mr) += alpha * a(mr x n) * x(n),
+ * gevm computes y(n) += alpha * x(mr) * a(mr x n)
+ */
+template<typename T>
+struct gemv_kernel {
+  using function_type = void (*)(std::size_t n, const T *a, std::size_t lda, const T *x, const T &alpha, T *y);
+
+  std::size_t mr;
+  function_type gemv;
+  function_type gevm;
+};
+
+template<typename T, std::size_t MR>
+void gemv_generic_kernel(std::size_t n, const T *a, std::size_t lda, const T *x, const T &alpha, T *y) {
+  T acc[MR]{};
+
+  for (std::size_t j = 0; j != n; ++j)
+	for (std::size_t i = 0; i != MR; ++i)
+	  acc[i] += a[i * lda + j] * x[j];
+
+  for (std::size_t i = 0; i != MR; ++i)
+	y[i] += alpha * acc[i];
+}
+
+template<typename T, std::size_t MR>
+void gevm_generic_kernel(std::size_t n, const T *a, std::size_t lda, const T *x, const T &alpha, T *y) {
+  T scaled[MR];
+  for (std::size_t i = 0; i != MR; ++i)
+	scaled[i] = alpha * x[i];
+
+  for (std::size_t j = 0; j != n; ++j) {
+	T sum = y[j];
+	for (std::size_t i = 0; i != MR; ++i)
+	  sum += scaled[i] * a[i * lda + j];
+	y[j] = sum;
+  }
+}
+
+template<typename T>
+gemv_kernel<T> generic_gemv_kernel() {
+  return {4, &gemv_generic_kernel<T, 4>, &gevm_generic_kernel<T, 4>};
+}
+
+/**
+ * Batched kernels multiply batch_group_size pairs of small matrices at once.
+ * Operands are interleaved: item e of matrix g is stored at [e * batch_group_size + g],
+ * so every vector instruction works on the same item of different matrices
+ */
+MATRIX_CXX17_INLINE constexpr std::size_t batch_group_size = 16;
+
+template<typename T>
+struct batch_kernel {
+  using function_type = void (*)(const T *a, const T *b, T *c);
+};
+
+template<typename T, std::size_t R, std::size_t K, std::size_t C>
+void batch_generic_kernel(const T *a, const T *b, T *c) {
+  constexpr std::size_t group = batch_group_size;
+
+  for (std::size_t i = 0; i != R; ++i)
+	for (std::size_t j = 0; j != C; ++j) {
+	  T acc[group]{};
+
+	  for (std::size_t k = 0; k != K; ++k) {
+		const T *lhs = a + (i * K + k) * group;
+		const T *rhs = b + (k * C + j) * group;
+		for (std::size_t g = 0; g != group; ++g)
+		  acc[g] += lhs[g] * rhs[g];
+	  }
+
+	  std::copy(acc, acc + group, c + (i * C + j) * group);
+	}
+}
+
+/**
+ * Moves items of batch_group_size matrices to the interleaved layout and back:
+ * interleaved[e * batch_group_size + g] = matrices[g][e] for e in [0, items)
+ */
+template<typename T>
+void batch_interleave(const T *const *matrices, std::size_t items, T *interleaved) {
+  for (std::size_t g = 0; g != batch_group_size; ++g)
+	for (std::size_t e = 0; e != items; ++e)
+	  interleaved[e * batch_group_size + g] = matrices[g][e];
+}
+
+template<typename T>
+void batch_deinterleave(const T *interleaved, std::size_t items, T *const *matrices) {
+  for (std::size_t g = 0; g != batch_group_size; ++g)
+	for (std::size_t e = 0; e != items; ++e)
+	  matrices[g][e] = interleaved[e * batch_group_size + g];
+}
+
+#if defined(MATRIX_X86_KERNELS)
+
+/**
+ * Vector operations used by the kernels, madd(a, b, acc) returns acc + a * b
+ */
+template<typename T>
+struct sse2_ops;
+
+template<>
+struct sse2_ops<double> {
+  using reg = __m128d;
+  static constexpr std::size_t width = 2;
+
+  MATRIX_TARGET_SSE2 static reg zero() { return _mm_setzero_pd(); }
+  MATRIX_TARGET_SSE2 static reg load(const double *p) { return _mm_loadu_pd(p); }
+  MATRIX_TARGET_SSE2 static reg broadcast(const double *p) { return _mm_set1_pd(*p); }
+  MATRIX_TARGET_SSE2 static reg add(reg x, reg y) { return _mm_add_pd(x, y); }
+  MATRIX_TARGET_SSE2 static reg min(reg x, reg y) { return _mm_min_pd(x, y); }
+  MATRIX_TARGET_SSE2 static reg max(reg x, reg y) { return _mm_max_pd(x, y); }
+  MATRIX_TARGET_SSE2 static reg absorbing_add(reg x, reg y, reg) { return add(x, y); }
+  MATRIX_TARGET_SSE2 static reg madd(reg a, reg b, reg acc) { return _mm_add_pd(acc, _mm_mul_pd(a, b)); }
+  MATRIX_TARGET_SSE2 static void store(double *p, reg x) { _mm_storeu_pd(p, x); }
+};
+
+template<>
+struct sse2_ops<float> {
+  using reg = __m128;
+  static constexpr std::size_t width = 4;
+
+  MATRIX_TARGET_SSE2 static reg zero() { return _mm_setzero_ps(); }
+  MATRIX_TARGET_SSE2 static reg load(const float *p) { return _mm_loadu_ps(p); }
+  MATRIX_TARGET_SSE2 static reg broadcast(const float *p) { return _mm_set1_ps(*p); }
+  MATRIX_TARGET_SSE2 static reg add(reg x, reg y) { return _mm_add_ps(x, y); }
+  MATRIX_TARGET_SSE2 static reg min(reg x, reg y) { return _mm_min_ps(x, y); }
+  MATRIX_TARGET_SSE2 static reg max(reg x, reg y) { return _mm_max_ps(x, y); }
+  MATRIX_TARGET_SSE2 static reg absorbing_add(reg x, reg y, reg) { return add(x, y); }
+  MATRIX_TARGET_SSE2 static reg madd(reg a, reg b, reg acc) { return _mm_add_ps(acc, _mm_mul_ps(a, b)); }
+  MATRIX_TARGET_SSE2 static void store(float *p, reg x) { _mm_storeu_ps(p, x); }
+};
+
+template<>
+struct sse2_ops<std::int32_t> {
+  using reg = __m128i;
+  static constexpr std::size_t width = 4;
+
+  MATRIX_TARGET_SSE2 static reg zero() { return _mm_setzero_si128(); }
+  MATRIX_TARGET_SSE2 static reg load(const std::int32_t *p) {
+	return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  }
+  MATRIX_TARGET_SSE2 static reg broadcast(const std::int32_t *p) { return _mm_set1_epi32(*p); }
+  MATRIX_TARGET_SSE2 static reg add(reg x, reg y) { return _mm_add_epi32(x, y); }
+  MATRIX_TARGET_SSE2 static reg min(reg x, reg y) {
+	const __m128i greater = _mm_cmpgt_epi32(x, y);
+	return _mm_or_si128(_mm_and_si128(greater, y), _mm_andnot_si128(greater, x));
+  }
+  MATRIX_TARGET_SSE2 static reg max(reg x, reg y) {
+	const __m128i greater = _mm_cmpgt_epi32(x, y);
+	return _mm_or_si128(_mm_and_si128(greater, x), _mm_andnot_si128(greater, y));
+  }
+  MATRIX_TARGET_SSE2 static reg absorbing_add(reg x, reg y, reg limit) {
+	const __m128i absorbed = _mm_or_si128(_mm_cmpeq_epi32(x, limit), _mm_cmpeq_epi32(y, limit));
+	return _mm_or_si128(_mm_and_si128(absorbed, limit), _mm_andnot_si128(absorbed, _mm_add_epi32(x, y)));
+  }
+  MATRIX_TARGET_SSE2 static reg madd(reg a, reg b, reg acc) {
+	// SSE2 has no 32 bit low multiplication, it is assembled from two 32x32->64 products
+	const __m128i even = _mm_mul_epu32(a, b);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+	const __m128i product = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+											   _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	return _mm_add_epi32(acc, product);
+  }
+  MATRIX_TARGET_SSE2 static void store(std::int32_t *p, reg x) {
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(p), x);
+  }
+};
+
+template<typename T>
+struct avx2_ops;
+
+template<>
+struct avx2_ops<double> {
+  using reg = __m256d;
+  static constexpr std::size_t width = 4;
+
+  MATRIX_TARGET_AVX2 static reg zero() { return _mm256_setzero_pd(); }
+  MATRIX_TARGET_AVX2 static reg load(const double *p) { return _mm256_loadu_pd(p); }
+  MATRIX_TARGET_AVX2 static reg broadcast(const double *p) { return _mm256_broadcast_sd(p); }
+  MATRIX_TARGET_AVX2 static reg add(reg x, reg y) { return _mm256_add_pd(x, y); }
+  MATRIX_TARGET_AVX2 static reg min(reg x, reg y) { return _mm256_min_pd(x, y); }
+  MATRIX_TARGET_AVX2 static reg max(reg x, reg y) { return _mm256_max_pd(x, y); }
+  MATRIX_TARGET_AVX2 static reg absorbing_add(reg x, reg y, reg) { return add(x, y); }
+  MATRIX_TARGET_AVX2 static reg madd(reg a, reg b, reg acc) { return _mm256_fmadd_pd(a, b, acc); }
+  MATRIX_TARGET_AVX2 static void store(double *p, reg x) { _mm256_storeu_pd(p, x); }
+};
+
+template<>
+struct avx2_ops<float> {
+  using reg = __m256;
+  static constexpr std::size_t width = 8;
+
+  MATRIX_TARGET_AVX2 static reg zero() { return _mm256_setzero_ps(); }
+  MATRIX_TARGET_AVX2 static reg load(const float *p) { return _mm256_loadu_ps(p); }
+  MATRIX_TARGET_AVX2 static reg broadcast(const float *p) { return _mm256_broadcast_ss(p); }
+  MATRIX_TARGET_AVX2 static reg add(reg x, reg y) { return _mm256_add_ps(x, y); }
+  MATRIX_TARGET_AVX2 static reg min(reg x, reg y) { return _mm256_min_ps(x, y); }
+  MATRIX_TARGET_AVX2 static reg max(reg x, reg y) { return _mm256_max_ps(x, y); }
+  MATRIX_TARGET_AVX2 static reg absorbing_add(reg x, reg y, reg) { return add(x, y); }
+  MATRIX_TARGET_AVX2 static reg madd(reg a, reg b, reg acc) { return _mm256_fmadd_ps(a, b, acc); }
+  MATRIX_TARGET_AVX2 static void store(float *p, reg x) { _mm256_storeu_ps(p, x); }
+};
+
+template<>
+struct avx2_ops<std::int32_t> {
+  using reg = __m256i;
+  static constexpr std::size_t width = 8;
+
+  MATRIX_TARGET_AVX2 static reg zero() { return _mm256_setzero_si256(); }
+  MATRIX_TARGET_AVX2 static reg load(const std::int32_t *p) {
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+  MATRIX_TARGET_AVX2 static reg broadcast(const std::int32_t *p) { return _mm256_set1_epi32(*p); }
+  MATRIX_TARGET_AVX2 static reg add(reg x, reg y) { return _mm256_add_epi32(x, y); }
+  MATRIX_TARGET_AVX2 static reg min(reg x, reg y) { return _mm256_min_epi32(x, y); }
+  MATRIX_TARGET_AVX2 static reg max(reg x, reg y) { return _mm256_max_epi32(x, y); }
+  MATRIX_TARGET_AVX2 static reg absorbing_add(reg x, reg y, reg limit) {
+	const __m256i absorbed = _mm256_or_si256(_mm256_cmpeq_epi32(x, limit), _mm256_cmpeq_epi32(y, limit));
+	return _mm256_blendv_epi8(_mm256_add_epi32(x, y), limit, absorbed);
+  }
+  MATRIX_TARGET_AVX2 static reg madd(reg a, reg b, reg acc) {
+	return _mm256_add_epi32(acc, _mm256_mullo_epi32(a, b));
+  }
+  MATRIX_TARGET_AVX2 static void store(std::int32_t *p, reg x) {
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(p), x);
+  }
+};
+
+/*
+ * min and max are the full mask forms, the plain intrinsics of GCC 12
+ * start from an undefined register and trigger -Wuninitialized
+ */
+template<typename T>
+struct avx512_ops;
+
+template<>
+struct avx512_ops<double> {
+  using reg = __m512d;
+  static constexpr std::size_t width = 8;
+
+  MATRIX_TARGET_AVX512 static reg zero() { return _mm512_setzero_pd(); }
+  MATRIX_TARGET_AVX512 static reg load(const double *p) { return _mm512_loadu_pd(p); }
+  MATRIX_TARGET_AVX512 static reg broadcast(const double *p) { return _mm512_set1_pd(*p); }
+  MATRIX_TARGET_AVX512 static reg add(reg x, reg y) { return _mm512_add_pd(x, y); }
+  MATRIX_TARGET_AVX512 static reg min(reg x, reg y) { return _mm512_maskz_min_pd(0xFF, x, y); }
+  MATRIX_TARGET_AVX512 static reg max(reg x, reg y) { return _mm512_maskz_max_pd(0xFF, x, y); }
+  MATRIX_TARGET_AVX512 static reg absorbing_add(reg x, reg y, reg) { return add(x, y); }
+  MATRIX_TARGET_AVX512 static reg madd(reg a, reg b, reg acc) { return _mm512_fmadd_pd(a, b, acc); }
+  MATRIX_TARGET_AVX512 static void store(double *p, reg x) { _mm512_storeu_pd(p, x); }
+};
+
+template<>
+struct avx512_ops<float> {
+  using reg = __m512;
+  static constexpr std::size_t width = 16;
+
+  MATRIX_TARGET_AVX512 static reg zero() { return _mm512_setzero_ps(); }
+  MATRIX_TARGET_AVX512 static reg load(const float *p) { return _mm512_loadu_ps(p); }
+  MATRIX_TARGET_AVX512 static reg broadcast(const float *p) { return _mm512_set1_ps(*p); }
+  MATRIX_TARGET_AVX512 static reg add(reg x, reg y) { return _mm512_add_ps(x, y); }
+  MATRIX_TARGET_AVX512 static reg min(reg x, reg y) { return _mm512_maskz_min_ps(0xFFFF, x, y); }
+  MATRIX_TARGET_AVX512 static reg max(reg x, reg y) { return _mm512_maskz_max_ps(0xFFFF, x, y); }
+  MATRIX_TARGET_AVX512 static reg absorbing_add(reg x, reg y, reg) { return add(x, y); }
+  MATRIX_TARGET_AVX512 static reg madd(reg a, reg b, reg acc) { return _mm512_fmadd_ps(a, b, acc); }
+  MATRIX_TARGET_AVX512 static void store(float *p, reg x) { _mm512_storeu_ps(p, x); }
+};
+
+template<>
+struct avx512_ops<std::int32_t> {
+  using reg = __m512i;
+  static constexpr std::size_t width = 16;
+
+  MATRIX_TARGET_AVX512 static reg zero() { return _mm512_setzero_si512(); }
+  MATRIX_TARGET_AVX512 static reg load(const std::int32_t *p) { return _mm512_loadu_si512(p); }
+  MATRIX_TARGET_AVX512 static reg broadcast(const std::int32_t *p) { return _mm512_set1_epi32(*p); }
+  MATRIX_TARGET_AVX512 static reg add(reg x, reg y) { return _mm512_add_epi32(x, y); }
+  MATRIX_TARGET_AVX512 static reg min(reg x, reg y) { return _mm512_maskz_min_epi32(0xFFFF, x, y); }
+  MATRIX_TARGET_AVX512 static reg max(reg x, reg y) { return _mm512_maskz_max_epi32(0xFFFF, x, y); }
+  MATRIX_TARGET_AVX512 static reg absorbing_add(reg x, reg y, reg limit) {
+	const __mmask16 absorbed = _mm512_cmpeq_epi32_mask(x, limit) | _mm512_cmpeq_epi32_mask(y, limit);
+	return _mm512_mask_blend_epi32(absorbed, _mm512_add_epi32(x, y), limit);
+  }
+  MATRIX_TARGET_AVX512 static reg madd(reg a, reg b, reg acc) {
+	return _mm512_add_epi32(acc, _mm512_mullo_epi32(a, b));
+  }
+  MATRIX_TARGET_AVX512 static void store(std::int32_t *p, reg x) { _mm512_storeu_si512(p, x); }
+};
+
+/*
+ * The kernel bodies are the same for every instruction set,
+ * they differ only by the target attribute which can't be a template parameter
+ */
+#define MATRIX_DEFINE_SIMD_GEMM_KERNEL(NAME, OPS, TARGET) \
+template<typename T, std::size_t MR, std::size_t NV> \
+TARGET void NAME(std::size_t kc, const T *a, const T *b, T *c, std::size_t ldc) { \
+  using ops = OPS<T>; \
+  using reg = typename ops::reg; \
+  constexpr std::size_t width = ops::width; \
+\
+  reg acc[MR][NV]; \
+  MATRIX_UNROLL \
+  for (std::size_t i = 0; i != MR; ++i) \
+	MATRIX_UNROLL \
+	for (std::size_t v = 0; v != NV; ++v) \
+	  acc[i][v] = ops::zero(); \
+\
+  for (std::size_t p = 0; p != kc; ++p, a += MR, b += NV * width) { \
+	reg row[NV]; \
+	MATRIX_UNROLL \
+	for (std::size_t v = 0; v != NV; ++v) \
+	  row[v] = ops::load(b + v * width); \
+\
+	MATRIX_UNROLL \
+	for (std::size_t i = 0; i != MR; ++i) { \
+	  const reg item = ops::broadcast(a + i); \
+	  MATRIX_UNROLL \
+	  for (std::size_t v = 0; v != NV; ++v) \
+		acc[i][v] = ops::madd(item, row[v], acc[i][v]); \
+	} \
+  } \
+\
+  MATRIX_UNROLL \
+  for (std::size_t i = 0; i != MR; ++i) \
+	MATRIX_UNROLL \
+	for (std::size_t v = 0; v != NV; ++v) { \
+	  T *tile = c + i * ldc + v * width; \
+	  ops::store(tile, ops::add(ops::load(tile), acc[i][v])); \
+	} \
+}
+
+MATRIX_DEFINE_SIMD_GEMM_KERNEL(sse2_gemm_kernel, sse2_ops, MATRIX_TARGET_SSE2)
+MATRIX_DEFINE_SIMD_GEMM_KERNEL(avx2_gemm_kernel, avx2_ops, MATRIX_TARGET_AVX2)
+MATRIX_DEFINE_SIMD_GEMM_KERNEL(avx512_gemm_kernel, avx512_ops, MATRIX_TARGET_AVX512)
+
+#undef MATRIX_DEFINE_SIMD_GEMM_KERNEL
+
+/*
+ * Kernels of semirings built from min, max and +, the accumulators start
+ * from +inf for min and from -inf for max. The infinity is absorbing for +:
+ * integral sums with an infinite term are infinite instead of overflowing
+ */
+#define MATRIX_DEFINE_SIMD_SEMIRING_KERNEL(NAME, OPS, TARGET) \
+template<typename T, semiring_op Op, std::size_t MR, std::size_t NV> \
+TARGET void NAME(std::size_t kc, const T *a, const T *b, T *c, std::size_t ldc) { \
+  using ops = OPS<T>; \
+  using reg = typename ops::reg; \
+  constexpr std::size_t width = ops::width; \
+  constexpr bool minimum = Op == semiring_op::min_plus; \
+  const T infinity = minimum ? positive_infinity<T>() : negative_infinity<T>(); \
+  const reg limit = ops::broadcast(&infinity); \
+\
+  reg acc[MR][NV]; \
+  MATRIX_UNROLL \
+  for (std::size_t i = 0; i != MR; ++i) \
+	MATRIX_UNROLL \
+	for (std::size_t v = 0; v != NV; ++v) \
+	  acc[i][v] = limit; \
+\
+  for (std::size_t p = 0; p != kc; ++p, a += MR, b += NV * width) { \
+	reg row[NV]; \
+	MATRIX_UNROLL \
+	for (std::size_t v = 0; v != NV; ++v) \
+	  row[v] = ops::load(b + v * width); \
+\
+	MATRIX_UNROLL \
+	for (std::size_t i = 0; i != MR; ++i) { \
+	  const reg item = ops::broadcast(a + i); \
+	  MATRIX_UNROLL \
+	  for (std::size_t v = 0; v != NV; ++v) \
+		acc[i][v] = Op == semiring_op::max_min ? ops::max(acc[i][v], ops::min(item, row[v])) \
+			: minimum ? ops::min(acc[i][v], ops::absorbing_add(item, row[v], limit)) \
+					  : ops::max(acc[i][v], ops::absorbing_add(item, row[v], limit)); \
+	} \
+  } \
+\
+  MATRIX_UNROLL \
+  for (std::size_t i = 0; i != MR; ++i) \
+	MATRIX_UNROLL \
+	for (std::size_t v = 0; v != NV; ++v) { \
+	  T *tile = c + i * ldc + v * width; \
+	  ops::store(tile, minimum ? ops::min(ops::load(tile), acc[i][v]) : ops::max(ops::load(tile), acc[i][v])); \
+	} \
+}
+
+MATRIX_DEFINE_SIMD_SEMIRING_KERNEL(sse2_semiring_kernel, sse2_ops, MATRIX_TARGET_SSE2)
+MATRIX_DEFINE_SIMD_SEMIRING_KERNEL(avx2_semiring_kernel, avx2_ops, MATRIX_TARGET_AVX2)
+MATRIX_DEFINE_SIMD_SEMIRING_KERNEL(avx512_semiring_kernel, avx512_ops, MATRIX_TARGET_AVX512)
+
+#undef MATRIX_DEFINE_SIMD_SEMIRING_KERNEL
+
+/*
+ * Matrix vector kernels: gemv keeps one accumulator per row and reduces
+ * its lanes at the end, gevm keeps alpha * x broadcasted in registers
+ * and streams y through them
+ */
+#define MATRIX_DEFINE_SIMD_GEMV_KERNELS(GEMV, GEVM, OPS, TARGET) \
+template<typename T, std::size_t MR> \
+TARGET void GEMV(std::size_t n, const T *a, std::size_t lda, const T *x, const T &alpha, T *y) { \
+  using ops = OPS<T>; \
+  using reg = typename ops::reg; \
+  constexpr std::size_t width = ops::width; \
+\
+  reg acc[MR]; \
+  MATRIX_UNROLL \
+  for (std::size_t i = 0; i != MR; ++i) \
+	acc[i] = ops::zero(); \
+\
+  std::size_t j = 0; \
+  for (; j + width <= n; j += width) { \
+	const reg items = ops::load(x + j); \
+	MATRIX_UNROLL \
+	for (std::size_t i = 0; i != MR; ++i) \
+	  acc[i] = ops::madd(ops::load(a + i * lda + j), items, acc[i]); \
+  } \
+\
+  for (std::size_t i = 0; i != MR; ++i) { \
+	T lanes[width]; \
+	ops::store(lanes, acc[i]); \
+\
+	T sum{}; \
+	for (std::size_t lane = 0; lane != width; ++lane) \
+	  sum += lanes[lane]; \
+	for (std::size_t tail = j; tail != n; ++tail) \
+	  sum += a[i * lda + tail] * x[tail]; \
+\
+	y[i] += alpha * sum; \
+  } \
+} \
+\
+template<typename T, std::size_t MR> \
+TARGET void GEVM(std::size_t n, const T *a, std::size_t lda, const T *x, const T &alpha, T *y) { \
+  using ops = OPS<T>; \
+  using reg = typename ops::reg; \
+  constexpr std::size_t width = ops::width; \
+\
+  T scaled[MR]; \
+  reg items[MR]; \
+  MATRIX_UNROLL \
+  for (std::size_t i = 0; i != MR; ++i) { \
+	scaled[i] = alpha * x[i]; \
+	items[i] = ops::broadcast(scaled + i); \
+  } \
+\
+  std::size_t j = 0; \
+  for (; j + width <= n; j += width) { \
+	reg acc = ops::load(y + j); \
+	MATRIX_UNROLL \
+	for (std::size_t i = 0; i != MR; ++i) \
+	  acc = ops::madd(items[i], ops::load(a + i * lda + j), acc); \
+	ops::store(y + j, acc); \
+  } \
+\
+  for (; j != n; ++j) { \
+	T sum = y[j]; \
+	for (std::size_t i = 0; i != MR; ++i) \
+	  sum += scaled[i] * a[i * lda + j]; \
+	y[j] = sum; \
+  } \
+}
+
+MATRIX_DEFINE_SIMD_GEMV_KERNELS(sse2_gemv_kernel, sse2_gevm_kernel, sse2_ops, MATRIX_TARGET_SSE2)
+MATRIX_DEFINE_SIMD_GEMV_KERNELS(avx2_gemv_kernel, avx2_gevm_kernel, avx2_ops, MATRIX_TARGET_AVX2)
+MATRIX_DEFINE_SIMD_GEMV_KERNELS(avx512_gemv_kernel, avx512_gevm_kernel, avx512_ops, MATRIX_TARGET_AVX512)
+
+#undef MATRIX_DEFINE_SIMD_GEMV_KERNELS
+
+#define MATRIX_DEFINE_SIMD_BATCH_KERNEL(NAME, OPS, TARGET) \
+template<typename T, std::size_t R, std::size_t K, std::size_t C> \
+TARGET void NAME(const T *a, const T *b, T *c) { \
+  using ops = OPS<T>; \
+  using reg = typename ops::reg; \
+  constexpr std::size_t width = ops::width; \
+  constexpr std::size_t group = batch_group_size; \
+  constexpr std::size_t vectors = group / width; \
+\
+  for (std::size_t i = 0; i != R; ++i) \
+	for (std::size_t j = 0; j != C; ++j) { \
+	  reg acc[vectors]; \
+	  MATRIX_UNROLL \
+	  for (std::size_t v = 0; v != vectors; ++v) \
+		acc[v] = ops::zero(); \
+\
+	  for (std::size_t k = 0; k != K; ++k) { \
+		const T *lhs = a + (i * K + k) * group; \
+		const T *rhs = b + (k * C + j) * group; \
+		MATRIX_UNROLL \
+		for (std::size_t v = 0; v != vectors; ++v) \
+		  acc[v] = ops::madd(ops::load(lhs + v * width), ops::load(rhs + v * width), acc[v]); \
+	  } \
+\
+	  MATRIX_UNROLL \
+	  for (std::size_t v = 0; v != vectors; ++v) \
+		ops::store(c + (i * C + j) * group + v * width, acc[v]); \
+	} \
+}
+
+MATRIX_DEFINE_SIMD_BATCH_KERNEL(sse2_batch_kernel, sse2_ops, MATRIX_TARGET_SSE2)
+MATRIX_DEFINE_SIMD_BATCH_KERNEL(avx2_batch_kernel, avx2_ops, MATRIX_TARGET_AVX2)
+MATRIX_DEFINE_SIMD_BATCH_KERNEL(avx512_batch_kernel, avx512_ops, MATRIX_TARGET_AVX512)
+
+#undef MATRIX_DEFINE_SIMD_BATCH_KERNEL
+
+/*
+ * Interleaving is a transposition of 16 x items blocks, it is done by 4 x 4 tiles
+ * of float and int32 (2 x 2 tiles of double) in SSE2 registers, the scalar
+ * version stores every item separately and costs more than the products
+ */
+MATRIX_TARGET_SSE2 inline __m128 batch_load4(const float *p) { return _mm_loadu_ps(p); }
+MATRIX_TARGET_SSE2 inline void batch_store4(float *p, __m128 x) { _mm_storeu_ps(p, x); }
+
+// int32 items are moved through float registers, the shuffles don't change bits
+MATRIX_TARGET_SSE2 inline __m128 batch_load4(const std::int32_t *p) {
+  return _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+}
+MATRIX_TARGET_SSE2 inline void batch_store4(std::int32_t *p, __m128 x) {
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm_castps_si128(x));
+}
+
+template<typename T>
+MATRIX_TARGET_SSE2 void batch_interleave4(const T *const *matrices, std::size_t items, T *interleaved) {
+  for (std::size_t g = 0; g != batch_group_size; g += 4) {
+	std::size_t e = 0;
+	for (; e + 4 <= items; e += 4) {
+	  __m128 r0 = batch_load4(matrices[g] + e), r1 = batch_load4(matrices[g + 1] + e);
+	  __m128 r2 = batch_load4(matrices[g + 2] + e), r3 = batch_load4(matrices[g + 3] + e);
+	  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	  batch_store4(interleaved + e * batch_group_size + g, r0);
+	  batch_store4(interleaved + (e + 1) * batch_group_size + g, r1);
+	  batch_store4(interleaved + (e + 2) * batch_group_size + g, r2);
+	  batch_store4(interleaved + (e + 3) * batch_group_size + g, r3);
+	}
+
+	for (; e < items; ++e)
+	  for (std::size_t lane = 0; lane != 4; ++lane)
+		interleaved[e * batch_group_size + g + lane] = matrices[g + lane][e];
+  }
+}
+
+template<typename T>
+MATRIX_TARGET_SSE2 void batch_deinterleave4(const T *interleaved, std::size_t items, T *const *matrices) {
+  for (std::size_t g = 0; g != batch_group_size; g += 4) {
+	std::size_t e = 0;
+	for (; e + 4 <= items; e += 4) {
+	  __m128 r0 = batch_load4(interleaved + e * batch_group_size + g);
+	  __m128 r1 = batch_load4(interleaved + (e + 1) * batch_group_size + g);
+	  __m128 r2 = batch_load4(interleaved + (e + 2) * batch_group_size + g);
+	  __m128 r3 = batch_load4(interleaved + (e + 3) * batch_group_size + g);
+	  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	  batch_store4(matrices[g] + e, r0);
+	  batch_store4(matrices[g + 1] + e, r1);
+	  batch_store4(matrices[g + 2] + e, r2);
+	  batch_store4(matrices[g + 3] + e, r3);
+	}
+
+	for (; e < items; ++e)
+	  for (std::size_t lane = 0; lane != 4; ++lane)
+		matrices[g + lane][e] = interleaved[e * batch_group_size + g + lane];
+  }
+}
+
+inline void batch_interleave(const float *const *matrices, std::size_t items, float *interleaved) {
+  batch_interleave4(matrices, items, interleaved);
+}
+
+inline void batch_deinterleave(const float *interleaved, std::size_t items, float *const *matrices) {
+  batch_deinterleave4(interleaved, items, matrices);
+}
+
+inline void batch_interleave(const std::int32_t *const *matrices, std::size_t items, std::int32_t *interleaved) {
+  batch_interleave4(matrices, items, interleaved);
+}
+
+inline void batch_deinterleave(const std::int32_t *interleaved, std::size_t items, std::int32_t *const *matrices) {
+  batch_deinterleave4(interleaved, items, matrices);
+}
+
+MATRIX_TARGET_SSE2 inline void batch_interleave(const double *const *matrices, std::size_t items, double *interleaved) {
+  for (std::size_t g = 0; g != batch_group_size; g += 2) {
+	std::size_t e = 0;
+	for (; e + 2 <= items; e += 2) {
+	  const __m128d r0 = _mm_loadu_pd(matrices[g] + e), r1 = _mm_loadu_pd(matrices[g + 1] + e);
+	  _mm_storeu_pd(interleaved + e * batch_group_size + g, _mm_unpacklo_pd(r0, r1));
+	  _mm_storeu_pd(interleaved + (e + 1) * batch_group_size + g, _mm_unpackhi_pd(r0, r1));
+	}
+
+	for (; e < items; ++e)
+	  for (std::size_t lane = 0; lane != 2; ++lane)
+		interleaved[e * batch_group_size + g + lane] = matrices[g + lane][e];
+  }
+}
+
+MATRIX_TARGET_SSE2 inline void batch_deinterleave(const double *interleaved, std::size_t items, double *const *matrices) {
+  for (std::size_t g = 0; g != batch_group_size; g += 2) {
+	std::size_t e = 0;
+	for (; e + 2 <= items; e += 2) {
+	  const __m128d r0 = _mm_loadu_pd(interleaved + e * batch_group_size + g);
+	  const __m128d r1 = _mm_loadu_pd(interleaved + (e + 1) * batch_group_size + g);
+	  _mm_storeu_pd(matrices[g] + e, _mm_unpacklo_pd(r0, r1));
+	  _mm_storeu_pd(matrices[g + 1] + e, _mm_unpackhi_pd(r0, r1));
+	}
+
+	for (; e < items; ++e)
+	  for (std::size_t lane = 0; lane != 2; ++lane)
+		matrices[g + lane][e] = interleaved[e * batch_group_size + g + lane];
+  }
+}
+
+/**
+ * Register blocking of vector kernels: sse2 4 x 2 vectors,
+ * avx2 6 x 2 vectors (12 of 16 ymm accumulate),
+ * avx512 14 x 2 vectors (28 of 32 zmm accumulate)
+ */
+template<typename T>
+gemm_kernel<T> simd_gemm_kernel(simd_level level) {
+  switch (level) {
+	case simd_level::avx512:
+	  return {14, 2 * avx512_ops<T>::width, &avx512_gemm_kernel<T, 14, 2>};
+	case simd_level::avx2:
+	  return {6, 2 * avx2_ops<T>::width, &avx2_gemm_kernel<T, 6, 2>};
+	case simd_level::sse2:
+	  return {4, 2 * sse2_ops<T>::width, &sse2_gemm_kernel<T, 4, 2>};
+	default:
+	  return generic_gemm_kernel<T>();
+  }
+}
+
+/**
+ * Semiring kernels have the register blocking of simd_gemm_kernel
+ */
+template<typename T, typename Semiring>
+gemm_kernel<T> simd_semiring_kernel(simd_level level) {
+  constexpr semiring_op op = simd_semiring<Semiring>::op;
+
+  switch (level) {
+	case simd_level::avx512:
+	  return {14, 2 * avx512_ops<T>::width, &avx512_semiring_kernel<T, op, 14, 2>};
+	case simd_level::avx2:
+	  return {6, 2 * avx2_ops<T>::width, &avx2_semiring_kernel<T, op, 6, 2>};
+	case simd_level::sse2:
+	  return {4, 2 * sse2_ops<T>::width, &sse2_semiring_kernel<T, op, 4, 2>};
+	default:
+	  return generic_semiring_kernel<T, Semiring>();
+  }
+}
+
+template<typename T>
+gemv_kernel<T> simd_gemv_kernel(simd_level level) {
+  switch (level) {
+	case simd_level::avx512:
+	  return {4, &avx512_gemv_kernel<T, 4>, &avx512_gevm_kernel<T, 4>};
+	case simd_level::avx2:
+	  return {4, &avx2_gemv_kernel<T, 4>, &avx2_gevm_kernel<T, 4>};
+	case simd_level::sse2:
+	  return {4, &sse2_gemv_kernel<T, 4>, &sse2_gevm_kernel<T, 4>};
+	default:
+	  return generic_gemv_kernel<T>();
+  }
+}
+
+template<typename T, std::size_t R, std::size_t K, std::size_t C>
+typename batch_kernel<T>::function_type simd_batch_kernel(simd_level level) {
+  switch (level) {
+	case simd_level::avx512:
+	  return &avx512_batch_kernel<T, R, K, C>;
+	case simd_level::avx2:
+	  return &avx2_batch_kernel<T, R, K, C>;
+	case simd_level::sse2:
+	  return &sse2_batch_kernel<T, R, K, C>;
+	default:
+	  return &batch_generic_kernel<T, R, K, C>;
+  }
+}
+
+template<typename T>
+struct has_simd_gemm_kernel : std::integral_constant<bool,
+													 std::is_same<T, float>::value ||
+														 std::is_same<T, double>::value ||
+														 std::is_same<T, std::int32_t>::value> {
+};
+
+template<typename T, typename Semiring>
+struct has_simd_semiring_kernel : std::integral_constant<bool,
+														 has_simd_gemm_kernel<T>::value &&
+															 simd_semiring<Semiring>::value> {
+};
+
+#else
+
+template<typename T>
+struct has_simd_gemm_kernel : std::false_type {};
+
+template<typename T, typename Semiring>
+struct has_simd_semiring_kernel : std::false_type {};
+
+#endif // MATRIX_X86_KERNELS
+
+template<typename T>
+gemm_kernel<T> make_gemm_kernel(simd_level, std::false_type) {
+  return generic_gemm_kernel<T>();
+}
+
+template<typename T, typename Semiring>
+gemm_kernel<T> make_semiring_kernel(simd_level, std::false_type) {
+  return generic_semiring_kernel<T, Semiring>();
+}
+
+template<typename T>
+gemv_kernel<T> make_gemv_kernel(simd_level, std::false_type) {
+  return generic_gemv_kernel<T>();
+}
+
+template<typename T, std::size_t R, std::size_t K, std::size_t C>
+typename batch_kernel<T>::function_type make_batch_kernel(simd_level, std::false_type) {
+  return &batch_generic_kernel<T, R, K, C>;
+}
+
+#if defined(MATRIX_X86_KERNELS)
+template<typename T>
+gemm_kernel<T> make_gemm_kernel(simd_level level, std::true_type) {
+  return simd_gemm_kernel<T>(level);
+}
+
+template<typename T, typename Semiring>
+gemm_kernel<T> make_semiring_kernel(simd_level level, std::true_type) {
+  return simd_semiring_kernel<T, Semiring>(level);
+}
+
+template<typename T>
+gemv_kernel<T> make_gemv_kernel(simd_level level, std::true_type) {
+  return simd_gemv_kernel<T>(level);
+}
+
+template<typename T, std::size_t R, std::size_t K, std::size_t C>
+typename batch_kernel<T>::function_type make_batch_kernel(simd_level level, std::true_type) {
+  return simd_batch_kernel<T, R, K, C>(level);
+}
+#endif // MATRIX_X86_KERNELS
+
+template<typename T>
+struct gemm_kernel_table {
+  gemm_kernel<T> kernels[4];
+
+  gemm_kernel_table() {
+	for (int level = 0; level != 4; ++level)
+	  kernels[level] = make_gemm_kernel<T>(static_cast<simd_level>(level), has_simd_gemm_kernel<T>());
+  }
+};
+
+/**
+ * Kernels are built once for every level, the current
+ * level is read on every call so set_simd_level takes effect immediately
+ */
+template<typename T>
+const gemm_kernel<T> &select_gemm_kernel() {
+  static const gemm_kernel_table<T> table;
+  return table.kernels[static_cast<int>(get_simd_level())];
+}
+
+template<typename T, typename Semiring>
+struct semiring_kernel_table {
+  gemm_kernel<T> kernels[4];
+
+  semiring_kernel_table() {
+	for (int level = 0; level != 4; ++level)
+	  kernels[level] = make_semiring_kernel<T, Semiring>(static_cast<simd_level>(level),
+														 has_simd_semiring_kernel<T, Semiring>());
+  }
+};
+
+template<typename T, typename Semiring>
+const gemm_kernel<T> &select_semiring_kernel() {
+  static const semiring_kernel_table<T, Semiring> table;
+  return table.kernels[static_cast<int>(get_simd_level())];
+}
+
+template<typename T>
+struct gemv_kernel_table {
+  gemv_kernel<T> kernels[4];
+
+  gemv_kernel_table() {
+	for (int level = 0; level != 4; ++level)
+	  kernels[level] = make_gemv_kernel<T>(static_cast<simd_level>(level), has_simd_gemm_kernel<T>());
+  }
+};
+
+template<typename T>
+const gemv_kernel<T> &select_gemv_kernel() {
+  static const gemv_kernel_table<T> table;
+  return table.kernels[static_cast<int>(get_simd_level())];
+}
+
+template<typename T, std::size_t R, std::size_t K, std::size_t C>
+struct batch_kernel_table {
+  typename batch_kernel<T>::function_type kernels[4];
+
+  batch_kernel_table() {
+	for (int level = 0; level != 4; ++level)
+	  kernels[level] = make_batch_kernel<T, R, K, C>(static_cast<simd_level>(level), has_simd_gemm_kernel<T>());
+  }
+};
+
+template<typename T, std::size_t R, std::size_t K, std::size_t C>
+typename batch_kernel<T>::function_type select_batch_kernel() {
+  static const batch_kernel_table<T, R, K, C> table;
+  return table.kernels[static_cast<int>(get_simd_level())];
+}
+
+} // namespace detail end
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_KERNELS_H_
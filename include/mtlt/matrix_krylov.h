@@ -0,0 +1,750 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        Iterative Krylov solvers for systems too large to factorize:
+ *        conjugate gradient, BiCGSTAB and restarted GMRES. The operator is
+ *        a matrix or any callable computing y = A * x, preconditioners are
+ *        callables too, the vectors live in a reusable workspace
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_KRYLOV_H_
+#define MTLT_MATRIX_KRYLOV_H_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_config.h>
+
+namespace mtlt {
+
+/**
+ * Stopping rules of the Krylov solvers. The iterations stop when
+ * ||b - a * x|| <= tolerance * ||b|| or after max_iterations products
+ * with the preconditioned operator. restart is the size of the GMRES basis
+ */
+template<typename T>
+struct krylov_options {
+  krylov_options()
+	  : tolerance(std::sqrt(std::numeric_limits<T>::epsilon())), max_iterations(1000), restart(30) {}
+
+  T tolerance;
+  std::size_t max_iterations;
+  std::size_t restart;
+};
+
+/**
+ * Convergence statistics: history holds the relative residual
+ * before the first iteration and after every next one
+ */
+template<typename T>
+struct krylov_stats {
+  std::size_t iterations = 0;
+  T residual = T{};
+  bool converged = false;
+  std::vector<T> history;
+};
+
+/**
+ * @class krylov_workspace
+ *
+ * Storage of the solver vectors. It grows on the first solve, the next
+ * solves of the same size with the same workspace don't allocate
+ *
+ * @code
+ *
+ * mtlt::krylov_workspace<double> workspace;
+ * for (auto &b : right_hand_sides)
+ *   mtlt::cg(a, b, x, options, preconditioner, workspace);
+ *
+ * @endcode
+ */
+template<typename T = double>
+class krylov_workspace {
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+public:
+  krylov_workspace() = default;
+
+  explicit krylov_workspace(size_type size) : buffer_(size) {}
+
+public:
+  MATRIX_CXX17_NODISCARD
+  size_type size() const noexcept { return buffer_.size(); }
+
+  T *reserve(size_type size) {
+	if (buffer_.size() < size)
+	  buffer_.resize(size);
+	return buffer_.data();
+  }
+
+private:
+  std::vector<T> buffer_;
+};
+
+/**
+ * @class jacobi_preconditioner
+ *
+ * z = D^-1 * r with the diagonal D of the operator
+ *
+ * @code
+ *
+ * mtlt::jacobi_preconditioner<double> preconditioner(a);
+ * mtlt::cg(a, b, x, mtlt::krylov_options<double>(), preconditioner);
+ *
+ * @endcode
+ */
+template<typename T = double>
+class jacobi_preconditioner {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+public:
+  jacobi_preconditioner() = default;
+
+  template<typename Allocator, typename Layout>
+  explicit jacobi_preconditioner(const matrix<T, Allocator, Layout> &a) : inverse_(a.rows()) {
+	if (a.rows() != a.cols())
+	  throw std::logic_error("Jacobi preconditioner can be built only for square matrices");
+
+	for (size_type i = 0; i != size(); ++i)
+	  inverse_[i] = a(i, i);
+	invert();
+  }
+
+  explicit jacobi_preconditioner(std::vector<T> diagonal) : inverse_(std::move(diagonal)) {
+	invert();
+  }
+
+public:
+  MATRIX_CXX17_NODISCARD
+  size_type size() const noexcept { return inverse_.size(); }
+
+  void operator()(const T *r, T *z) const {
+	for (size_type i = 0; i != size(); ++i)
+	  z[i] = r[i] * inverse_[i];
+  }
+
+private:
+  void invert() {
+	for (T &item : inverse_) {
+	  if (item == T{})
+		throw std::logic_error("Jacobi preconditioner can't be built because of zero on the diagonal");
+	  item = T(1) / item;
+	}
+  }
+
+  std::vector<T> inverse_;
+};
+
+/**
+ * @class incomplete_cholesky
+ *
+ * IC(0) preconditioner z = (L * L^T)^-1 * r, L keeps the nonzero pattern
+ * of the lower triangle of a symmetric positive definite matrix and is stored
+ * by rows in compressed form, so applying it costs two sweeps over the nonzeros
+ *
+ * @code
+ *
+ * mtlt::incomplete_cholesky<double> preconditioner(a); // throws on a non-positive pivot
+ * mtlt::cg(a, b, x, mtlt::krylov_options<double>(), preconditioner);
+ *
+ * @endcode
+ */
+template<typename T = double>
+class incomplete_cholesky {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+public:
+  incomplete_cholesky() = default;
+
+  template<typename Allocator, typename Layout>
+  explicit incomplete_cholesky(const matrix<T, Allocator, Layout> &a) : row_start_(a.rows() + 1), diagonal_(a.rows()) {
+	if (a.rows() != a.cols())
+	  throw std::logic_error("Incomplete Cholesky factorization can be found only for square matrices");
+
+	for (size_type row = 0; row != size(); ++row) {
+	  row_start_[row] = columns_.size();
+	  for (size_type col = 0; col != row; ++col) {
+		if (a(row, col) != T{}) {
+		  columns_.push_back(col);
+		  values_.push_back(a(row, col));
+		}
+	  }
+	}
+	row_start_[size()] = columns_.size();
+
+	for (size_type row = 0; row != size(); ++row) {
+	  T square = a(row, row);
+
+	  for (size_type p = row_start_[row]; p != row_start_[row + 1]; ++p) {
+		const size_type col = columns_[p];
+
+		// Dot product of the rows row and col over their common pattern left of col
+		T sum = values_[p];
+		size_type q = row_start_[col], r = row_start_[row];
+		while (q != row_start_[col + 1] && r != p) {
+		  if (columns_[q] == columns_[r])
+			sum -= values_[q++] * values_[r++];
+		  else if (columns_[q] < columns_[r])
+			++q;
+		  else
+			++r;
+		}
+
+		values_[p] = sum / diagonal_[col];
+		square -= values_[p] * values_[p];
+	  }
+
+	  if (!(square > T{}))
+		throw std::logic_error("Incomplete Cholesky factorization can't be found because of a non-positive pivot");
+	  diagonal_[row] = std::sqrt(square);
+	}
+  }
+
+public:
+  MATRIX_CXX17_NODISCARD
+  size_type size() const noexcept { return diagonal_.size(); }
+
+  /**
+   * Nonzeros of L below the diagonal
+   */
+  MATRIX_CXX17_NODISCARD
+  size_type non_zeros() const noexcept { return values_.size(); }
+
+  void operator()(const T *r, T *z) const {
+	std::copy(r, r + size(), z);
+
+	for (size_type row = 0; row != size(); ++row) {
+	  T sum = z[row];
+	  for (size_type p = row_start_[row]; p != row_start_[row + 1]; ++p)
+		sum -= values_[p] * z[columns_[p]];
+	  z[row] = sum / diagonal_[row];
+	}
+
+	// Rows of L are the columns of L^T, the solved item is scattered up
+	for (size_type row = size(); row-- != 0;) {
+	  z[row] /= diagonal_[row];
+	  for (size_type p = row_start_[row]; p != row_start_[row + 1]; ++p)
+		z[columns_[p]] -= values_[p] * z[row];
+	}
+  }
+
+private:
+  std::vector<size_type> row_start_;
+  std::vector<size_type> columns_;
+  std::vector<T> values_;
+  std::vector<T> diagonal_;
+};
+
+namespace detail {
+
+template<typename T>
+T krylov_dot(std::size_t n, const T *x, const T *y) {
+  T sum{};
+  for (std::size_t i = 0; i != n; ++i)
+	sum += x[i] * y[i];
+  return sum;
+}
+
+template<typename T>
+T krylov_norm(std::size_t n, const T *x) {
+  return std::sqrt(krylov_dot(n, x, x));
+}
+
+template<typename T, typename Allocator, typename Layout>
+void check_operator(const matrix<T, Allocator, Layout> &a, std::size_t n) {
+  if (a.rows() != n || a.cols() != n)
+	throw std::logic_error("Can't run the iterative solver because a is not b.size() x b.size()");
+}
+
+template<typename T, typename Operator>
+void check_operator(const Operator &, std::size_t) {}
+
+template<typename T, typename Allocator, typename Layout>
+void apply_operator(const matrix<T, Allocator, Layout> &a, const T *x, T *y) {
+  mtlt::gemv(T(1), a, x, T{}, y);
+}
+
+template<typename T, typename Operator>
+void apply_operator(const Operator &a, const T *x, T *y) {
+  a(x, y);
+}
+
+template<typename T>
+struct identity_preconditioner {
+  std::size_t n;
+
+  void operator()(const T *r, T *z) const {
+	std::copy(r, r + n, z);
+  }
+};
+
+/**
+ * Checks the sizes, starts x from zero when it is empty and
+ * writes r = b - a * x, returns ||b||
+ */
+template<typename T, typename Operator>
+T krylov_start(const Operator &a, const std::vector<T> &b, std::vector<T> &x, const krylov_options<T> &options,
+			   krylov_stats<T> &stats, T *r) {
+  const std::size_t n = b.size();
+  check_operator<T>(a, n);
+
+  if (x.empty())
+	x.assign(n, T{});
+  if (x.size() != n)
+	throw std::logic_error("Can't run the iterative solver because x.size() != b.size()");
+
+  stats.history.reserve(options.max_iterations + 1);
+
+  apply_operator(a, x.data(), r);
+  for (std::size_t i = 0; i != n; ++i)
+	r[i] = b[i] - r[i];
+
+  return krylov_norm(n, b.data());
+}
+
+/**
+ * Records the relative residual, returns true when it is small enough
+ */
+template<typename T>
+bool krylov_converged(T residual, const krylov_options<T> &options, krylov_stats<T> &stats) {
+  stats.residual = residual;
+  stats.history.push_back(residual);
+  stats.converged = residual <= options.tolerance;
+  return stats.converged;
+}
+
+template<typename T, typename Operator, typename Preconditioner>
+krylov_stats<T> cg(const Operator &a, const std::vector<T> &b, std::vector<T> &x, const krylov_options<T> &options,
+				   const Preconditioner &m, krylov_workspace<T> &workspace) {
+  const std::size_t n = b.size();
+  T *r = workspace.reserve(4 * n);
+  T *z = r + n, *p = z + n, *q = p + n;
+
+  krylov_stats<T> stats;
+  const T norm = krylov_start(a, b, x, options, stats, r);
+  if (norm == T{}) {
+	std::fill(x.begin(), x.end(), T{});
+	krylov_converged(T{}, options, stats);
+	return stats;
+  }
+
+  if (krylov_converged(krylov_norm(n, r) / norm, options, stats))
+	return stats;
+
+  m(r, z);
+  std::copy(z, z + n, p);
+  T rz = krylov_dot(n, r, z);
+
+  while (stats.iterations != options.max_iterations) {
+	apply_operator(a, p, q);
+	const T curvature = krylov_dot(n, p, q);
+	if (!(curvature > T{}))
+	  break;
+
+	const T alpha = rz / curvature;
+	for (std::size_t i = 0; i != n; ++i) {
+	  x[i] += alpha * p[i];
+	  r[i] -= alpha * q[i];
+	}
+	++stats.iterations;
+
+	if (krylov_converged(krylov_norm(n, r) / norm, options, stats))
+	  break;
+
+	m(r, z);
+	const T next_rz = krylov_dot(n, r, z);
+	const T beta = next_rz / rz;
+	for (std::size_t i = 0; i != n; ++i)
+	  p[i] = z[i] + beta * p[i];
+	rz = next_rz;
+  }
+
+  return stats;
+}
+
+template<typename T, typename Operator, typename Preconditioner>
+krylov_stats<T> bicgstab(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+						 const krylov_options<T> &options, const Preconditioner &m, krylov_workspace<T> &workspace) {
+  const std::size_t n = b.size();
+  T *r = workspace.reserve(7 * n);
+  T *shadow = r + n, *p = shadow + n, *v = p + n, *p_hat = v + n, *s_hat = p_hat + n, *t = s_hat + n;
+
+  krylov_stats<T> stats;
+  const T norm = krylov_start(a, b, x, options, stats, r);
+  if (norm == T{}) {
+	std::fill(x.begin(), x.end(), T{});
+	krylov_converged(T{}, options, stats);
+	return stats;
+  }
+
+  if (krylov_converged(krylov_norm(n, r) / norm, options, stats))
+	return stats;
+
+  std::copy(r, r + n, shadow);
+  std::fill(p, p + n, T{});
+  std::fill(v, v + n, T{});
+  T rho = T(1), alpha = T(1), omega = T(1);
+
+  while (stats.iterations != options.max_iterations) {
+	const T next_rho = krylov_dot(n, shadow, r);
+	if (next_rho == T{} || omega == T{})
+	  break;
+
+	const T beta = (next_rho / rho) * (alpha / omega);
+	for (std::size_t i = 0; i != n; ++i)
+	  p[i] = r[i] + beta * (p[i] - omega * v[i]);
+	rho = next_rho;
+
+	m(p, p_hat);
+	apply_operator(a, p_hat, v);
+	const T projection = krylov_dot(n, shadow, v);
+	if (projection == T{})
+	  break;
+
+	// The half step s = r - alpha * v reuses the storage of r
+	alpha = rho / projection;
+	for (std::size_t i = 0; i != n; ++i)
+	  r[i] -= alpha * v[i];
+	++stats.iterations;
+
+	const T half_residual = krylov_norm(n, r) / norm;
+	if (half_residual <= options.tolerance) {
+	  for (std::size_t i = 0; i != n; ++i)
+		x[i] += alpha * p_hat[i];
+	  krylov_converged(half_residual, options, stats);
+	  break;
+	}
+
+	m(r, s_hat);
+	apply_operator(a, s_hat, t);
+	const T tt = krylov_dot(n, t, t);
+	omega = tt == T{} ? T{} : krylov_dot(n, t, r) / tt;
+
+	for (std::size_t i = 0; i != n; ++i) {
+	  x[i] += alpha * p_hat[i] + omega * s_hat[i];
+	  r[i] -= omega * t[i];
+	}
+
+	if (krylov_converged(krylov_norm(n, r) / norm, options, stats))
+	  break;
+  }
+
+  return stats;
+}
+
+/**
+ * Restarted GMRES with right preconditioning, so the Givens residual
+ * is the residual of the original system
+ */
+template<typename T, typename Operator, typename Preconditioner>
+krylov_stats<T> gmres(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+					  const krylov_options<T> &options, const Preconditioner &m, krylov_workspace<T> &workspace) {
+  if (options.restart == 0)
+	throw std::logic_error("Can't run GMRES because restart is zero");
+
+  const std::size_t n = b.size(), basis = options.restart;
+  T *v = workspace.reserve((basis + 3) * n + (basis + 5) * basis + 1);
+  T *z = v + (basis + 1) * n, *update = z + n;
+  T *h = update + n, *cosines = h + (basis + 1) * basis, *sines = cosines + basis;
+  T *g = sines + basis, *y = g + basis + 1;
+
+  krylov_stats<T> stats;
+  const T norm = krylov_start(a, b, x, options, stats, v);
+  if (norm == T{}) {
+	std::fill(x.begin(), x.end(), T{});
+	krylov_converged(T{}, options, stats);
+	return stats;
+  }
+
+  T beta = krylov_norm(n, v);
+  if (krylov_converged(beta / norm, options, stats))
+	return stats;
+
+  while (stats.iterations != options.max_iterations) {
+	for (std::size_t i = 0; i != n; ++i)
+	  v[i] /= beta;
+	std::fill(g, g + basis + 1, T{});
+	g[0] = beta;
+
+	std::size_t columns = 0;
+	while (columns != basis && stats.iterations != options.max_iterations) {
+	  const std::size_t j = columns;
+	  T *w = v + (j + 1) * n;
+	  m(v + j * n, z);
+	  apply_operator(a, z, w);
+
+	  // Modified Gram-Schmidt, h is stored by columns with basis + 1 rows
+	  T *column = h + j * (basis + 1);
+	  for (std::size_t i = 0; i <= j; ++i) {
+		const T *v_i = v + i * n;
+		column[i] = krylov_dot(n, w, v_i);
+		for (std::size_t p = 0; p != n; ++p)
+		  w[p] -= column[i] * v_i[p];
+	  }
+	  column[j + 1] = krylov_norm(n, w);
+
+	  for (std::size_t i = 0; i != j; ++i) {
+		const T upper = column[i], lower = column[i + 1];
+		column[i] = cosines[i] * upper + sines[i] * lower;
+		column[i + 1] = -sines[i] * upper + cosines[i] * lower;
+	  }
+
+	  const T radius = std::hypot(column[j], column[j + 1]);
+	  cosines[j] = radius == T{} ? T(1) : column[j] / radius;
+	  sines[j] = radius == T{} ? T{} : column[j + 1] / radius;
+	  const T subdiagonal = column[j + 1];
+	  column[j] = radius;
+	  column[j + 1] = T{};
+	  g[j + 1] = -sines[j] * g[j];
+	  g[j] = cosines[j] * g[j];
+
+	  ++columns;
+	  ++stats.iterations;
+
+	  if (krylov_converged(std::fabs(g[j + 1]) / norm, options, stats) || subdiagonal == T{})
+		break;
+
+	  for (std::size_t p = 0; p != n; ++p)
+		w[p] /= subdiagonal;
+	}
+
+	// x += M^-1 * V * y with the triangular H * y = g
+	for (std::size_t i = columns; i-- != 0;) {
+	  T sum = g[i];
+	  for (std::size_t k = i + 1; k != columns; ++k)
+		sum -= h[k * (basis + 1) + i] * y[k];
+	  y[i] = sum / h[i * (basis + 1) + i];
+	}
+
+	std::fill(update, update + n, T{});
+	for (std::size_t i = 0; i != columns; ++i)
+	  for (std::size_t p = 0; p != n; ++p)
+		update[p] += y[i] * v[i * n + p];
+	m(update, z);
+	for (std::size_t p = 0; p != n; ++p)
+	  x[p] += z[p];
+
+	if (stats.converged)
+	  break;
+
+	// The restart begins from the true residual
+	apply_operator(a, x.data(), v);
+	for (std::size_t i = 0; i != n; ++i)
+	  v[i] = b[i] - v[i];
+	beta = krylov_norm(n, v);
+	stats.residual = beta / norm;
+	if (stats.residual <= options.tolerance) {
+	  stats.converged = true;
+	  break;
+	}
+  }
+
+  return stats;
+}
+
+} // namespace detail end
+
+/**
+ * Preconditioned conjugate gradient for symmetric positive definite operators.
+ * The operator is a square matrix or a callable op(const T *x, T *y) computing
+ * y = A * x, for example a sparse product. The preconditioner is a callable
+ * m(const T *r, T *z) computing z = M^-1 * r with a symmetric positive definite M.
+ * x is the initial guess and the result, an empty x starts from zero
+ *
+ * @code
+ *
+ * std::vector<double> x;
+ * mtlt::krylov_stats<double> stats = mtlt::cg(a, b, x);
+ *
+ * auto laplacian = [n](const double *in, double *out) { ... }; // Never stored as a matrix
+ * mtlt::krylov_options<double> options;
+ * options.tolerance = 1e-10;
+ * stats = mtlt::cg(laplacian, b, x, options, mtlt::jacobi_preconditioner<double>(diagonal));
+ *
+ * stats.converged; stats.iterations; stats.history; // Relative residuals
+ *
+ * @endcode
+ */
+#if __cplusplus > 201703L
+template<typename T, typename Operator, typename Preconditioner> requires (std::floating_point<T>)
+krylov_stats<T> cg(const Operator &a, const std::vector<T> &b, std::vector<T> &x, const krylov_options<T> &options,
+				   const Preconditioner &m, krylov_workspace<T> &workspace) {
+#else
+template<typename T, typename Operator, typename Preconditioner>
+krylov_stats<T> cg(const Operator &a, const std::vector<T> &b, std::vector<T> &x, const krylov_options<T> &options,
+				   const Preconditioner &m, krylov_workspace<T> &workspace) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  return detail::cg(a, b, x, options, m, workspace);
+}
+
+#if __cplusplus > 201703L
+template<typename T, typename Operator, typename Preconditioner> requires (std::floating_point<T>)
+krylov_stats<T> cg(const Operator &a, const std::vector<T> &b, std::vector<T> &x, const krylov_options<T> &options,
+				   const Preconditioner &m) {
+#else
+template<typename T, typename Operator, typename Preconditioner>
+krylov_stats<T> cg(const Operator &a, const std::vector<T> &b, std::vector<T> &x, const krylov_options<T> &options,
+				   const Preconditioner &m) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  krylov_workspace<T> workspace;
+  return detail::cg(a, b, x, options, m, workspace);
+}
+
+#if __cplusplus > 201703L
+template<typename T, typename Operator> requires (std::floating_point<T>)
+krylov_stats<T> cg(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+				   const krylov_options<T> &options = krylov_options<T>()) {
+#else
+template<typename T, typename Operator>
+krylov_stats<T> cg(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+				   const krylov_options<T> &options = krylov_options<T>()) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  krylov_workspace<T> workspace;
+  return detail::cg(a, b, x, options, detail::identity_preconditioner<T>{b.size()}, workspace);
+}
+
+/**
+ * BiCGSTAB for general nonsymmetric operators with right preconditioning,
+ * the operator and the preconditioner are passed as for mtlt::cg.
+ * Two products with the operator per iteration, a breakdown stops the
+ * iterations with converged == false
+ *
+ * @code
+ *
+ * mtlt::krylov_workspace<double> workspace;
+ * mtlt::krylov_stats<double> stats = mtlt::bicgstab(a, b, x, options, mtlt::jacobi_preconditioner<double>(a), workspace);
+ *
+ * @endcode
+ */
+#if __cplusplus > 201703L
+template<typename T, typename Operator, typename Preconditioner> requires (std::floating_point<T>)
+krylov_stats<T> bicgstab(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+						 const krylov_options<T> &options, const Preconditioner &m, krylov_workspace<T> &workspace) {
+#else
+template<typename T, typename Operator, typename Preconditioner>
+krylov_stats<T> bicgstab(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+						 const krylov_options<T> &options, const Preconditioner &m, krylov_workspace<T> &workspace) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  return detail::bicgstab(a, b, x, options, m, workspace);
+}
+
+#if __cplusplus > 201703L
+template<typename T, typename Operator, typename Preconditioner> requires (std::floating_point<T>)
+krylov_stats<T> bicgstab(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+						 const krylov_options<T> &options, const Preconditioner &m) {
+#else
+template<typename T, typename Operator, typename Preconditioner>
+krylov_stats<T> bicgstab(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+						 const krylov_options<T> &options, const Preconditioner &m) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  krylov_workspace<T> workspace;
+  return detail::bicgstab(a, b, x, options, m, workspace);
+}
+
+#if __cplusplus > 201703L
+template<typename T, typename Operator> requires (std::floating_point<T>)
+krylov_stats<T> bicgstab(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+						 const krylov_options<T> &options = krylov_options<T>()) {
+#else
+template<typename T, typename Operator>
+krylov_stats<T> bicgstab(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+						 const krylov_options<T> &options = krylov_options<T>()) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  krylov_workspace<T> workspace;
+  return detail::bicgstab(a, b, x, options, detail::identity_preconditioner<T>{b.size()}, workspace);
+}
+
+/**
+ * GMRES(options.restart) for general operators with right preconditioning,
+ * the operator and the preconditioner are passed as for mtlt::cg.
+ * The residual never grows, the workspace keeps restart + 3 vectors
+ *
+ * @code
+ *
+ * mtlt::krylov_options<double> options;
+ * options.restart = 50;
+ * mtlt::krylov_stats<double> stats = mtlt::gmres(a, b, x, options, mtlt::incomplete_cholesky<double>(a));
+ *
+ * @endcode
+ */
+#if __cplusplus > 201703L
+template<typename T, typename Operator, typename Preconditioner> requires (std::floating_point<T>)
+krylov_stats<T> gmres(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+					  const krylov_options<T> &options, const Preconditioner &m, krylov_workspace<T> &workspace) {
+#else
+template<typename T, typename Operator, typename Preconditioner>
+krylov_stats<T> gmres(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+					  const krylov_options<T> &options, const Preconditioner &m, krylov_workspace<T> &workspace) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  return detail::gmres(a, b, x, options, m, workspace);
+}
+
+#if __cplusplus > 201703L
+template<typename T, typename Operator, typename Preconditioner> requires (std::floating_point<T>)
+krylov_stats<T> gmres(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+					  const krylov_options<T> &options, const Preconditioner &m) {
+#else
+template<typename T, typename Operator, typename Preconditioner>
+krylov_stats<T> gmres(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+					  const krylov_options<T> &options, const Preconditioner &m) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  krylov_workspace<T> workspace;
+  return detail::gmres(a, b, x, options, m, workspace);
+}
+
+#if __cplusplus > 201703L
+template<typename T, typename Operator> requires (std::floating_point<T>)
+krylov_stats<T> gmres(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+					  const krylov_options<T> &options = krylov_options<T>()) {
+#else
+template<typename T, typename Operator>
+krylov_stats<T> gmres(const Operator &a, const std::vector<T> &b, std::vector<T> &x,
+					  const krylov_options<T> &options = krylov_options<T>()) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  krylov_workspace<T> workspace;
+  return detail::gmres(a, b, x, options, detail::identity_preconditioner<T>{b.size()}, workspace);
+}
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_KRYLOV_H_
@@ -0,0 +1,605 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        Storage layouts of the matrix container: the item (row, col) of
+ *        a rows x cols matrix is stored at Layout::index(row, col, rows, cols).
+ *        Row and column major storage is read in place by the multiplication
+ *        engine, the tiled and Z-order storage is copied to row major first
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_LAYOUT_H_
+#define MTLT_MATRIX_LAYOUT_H_
+
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+#include <mtlt/matrix_gemm.h>
+#include <mtlt/matrix_config.h>
+#include <mtlt/matrix_normal_iterator.h>
+#include <mtlt/matrix_reverse_iterator.h>
+
+namespace mtlt {
+
+/**
+ * @struct row_major
+ *
+ * The rows are stored one after another, the layout of matrix
+ * when none is given and the only one of matrix_view and the solvers
+ */
+struct row_major {
+  static std::size_t index(std::size_t row, std::size_t col, std::size_t, std::size_t cols) noexcept {
+	return row * cols + col;
+  }
+};
+
+/**
+ * @struct column_major
+ *
+ * The columns are stored one after another: swap_cols and the
+ * columns of the right operand of a product are contiguous
+ *
+ * @code
+ *
+ * mtlt::matrix<double, mtlt::aligned_allocator<double>, mtlt::column_major> features(100000, 64);
+ * features.swap_cols(3, 7); // Two contiguous ranges
+ *
+ * @endcode
+ */
+struct column_major {
+  static std::size_t index(std::size_t row, std::size_t col, std::size_t rows, std::size_t) noexcept {
+	return col * rows + row;
+  }
+};
+
+/**
+ * @struct tiled
+ *
+ * Blocked layout: the Tile x Tile blocks are stored one after another
+ * in row major order and the items of a block are row major too, so a
+ * block is one contiguous piece of memory whatever the direction of the walk.
+ * The blocks of the last row and column are cut to the matrix, there is no padding
+ *
+ * @code
+ *
+ * mtlt::matrix<float, mtlt::aligned_allocator<float>, mtlt::tiled<16>> image(4096, 4096);
+ * image(100, 200) = 1.0f; // Block (6, 12), item (4, 8) of the block
+ *
+ * @endcode
+ */
+template<std::size_t Tile = 32>
+struct tiled {
+  static_assert(Tile != 0, "Tile must not be zero");
+
+  static std::size_t index(std::size_t row, std::size_t col, std::size_t rows, std::size_t cols) noexcept {
+	const std::size_t top = row / Tile * Tile, left = col / Tile * Tile;
+	const std::size_t height = std::min(Tile, rows - top), width = std::min(Tile, cols - left);
+	return top * cols + left * height + (row - top) * width + (col - left);
+  }
+};
+
+/**
+ * @struct morton
+ *
+ * Z-order layout: the matrix is split into quadrants recursively and the
+ * quadrants are stored in the order top left, top right, bottom left,
+ * bottom right, so items which are close in both directions are close
+ * in memory on every scale. The parts of the quadrants outside of the
+ * matrix are skipped, there is no padding. Inside of a quadrant which
+ * lies in the matrix the index is the interleaving of the bits of row and col
+ */
+struct morton {
+  static std::size_t index(std::size_t row, std::size_t col, std::size_t rows, std::size_t cols) noexcept {
+	std::size_t half = 1;
+	while (half < rows || half < cols)
+	  half <<= 1;
+
+	std::size_t offset = 0, top = 0, left = 0;
+	for (half >>= 1; half != 0; half >>= 1) {
+	  if (top + 2 * half <= rows && left + 2 * half <= cols)
+		return offset + static_cast<std::size_t>(spread(row - top) << 1 | spread(col - left));
+
+	  const bool bottom = row >= top + half, right = col >= left + half;
+
+	  const std::size_t upper = std::min(half, rows - top);
+	  const std::size_t lower = rows > top + half ? std::min(half, rows - top - half) : 0;
+	  const std::size_t west = std::min(half, cols - left);
+	  const std::size_t east = cols > left + half ? std::min(half, cols - left - half) : 0;
+
+	  if (bottom)
+		offset += upper * (west + east);
+	  if (right)
+		offset += (bottom ? lower : upper) * west;
+
+	  top += bottom ? half : 0;
+	  left += right ? half : 0;
+	}
+
+	return offset;
+  }
+
+  /**
+   * Calls function(row, col, index) for the items of the rows [first, last)
+   * in the order of the storage, O(1) per item instead of O(log n) of index()
+   */
+  template<typename Function>
+  static void for_each_index(std::size_t rows, std::size_t cols, std::size_t first, std::size_t last,
+							 Function &&function) {
+	std::size_t size = 1;
+	while (size < rows || size < cols)
+	  size <<= 1;
+
+	std::size_t offset = 0;
+	visit(0, 0, size, rows, cols, first, last, offset, function);
+  }
+
+private:
+  template<typename Function>
+  static void visit(std::size_t top, std::size_t left, std::size_t size, std::size_t rows, std::size_t cols,
+					std::size_t first, std::size_t last, std::size_t &offset, Function &function) {
+	if (top >= rows || left >= cols)
+	  return;
+
+	const std::size_t height = std::min(size, rows - top), width = std::min(size, cols - left);
+	if (top >= last || top + height <= first) {
+	  offset += height * width;
+	  return;
+	}
+
+	// A whole square in the rows is stored in plain Z-order
+	if (height == size && width == size && top >= first && top + size <= last) {
+	  for (std::size_t item = 0; item != size * size; ++item)
+		function(top + compact(item >> 1), left + compact(item), offset + item);
+	  offset += size * size;
+	  return;
+	}
+
+	const std::size_t half = size / 2;
+	visit(top, left, half, rows, cols, first, last, offset, function);
+	visit(top, left + half, half, rows, cols, first, last, offset, function);
+	visit(top + half, left, half, rows, cols, first, last, offset, function);
+	visit(top + half, left + half, half, rows, cols, first, last, offset, function);
+  }
+
+  static std::size_t compact(std::uint64_t bits) noexcept {
+	bits &= 0x5555555555555555;
+	bits = (bits | bits >> 1) & 0x3333333333333333;
+	bits = (bits | bits >> 2) & 0x0F0F0F0F0F0F0F0F;
+	bits = (bits | bits >> 4) & 0x00FF00FF00FF00FF;
+	bits = (bits | bits >> 8) & 0x0000FFFF0000FFFF;
+	bits = (bits | bits >> 16) & 0x00000000FFFFFFFF;
+	return static_cast<std::size_t>(bits);
+  }
+
+  static std::uint64_t spread(std::uint64_t bits) noexcept {
+	bits &= 0xFFFFFFFF;
+	bits = (bits | bits << 16) & 0x0000FFFF0000FFFF;
+	bits = (bits | bits << 8) & 0x00FF00FF00FF00FF;
+	bits = (bits | bits << 4) & 0x0F0F0F0F0F0F0F0F;
+	bits = (bits | bits << 2) & 0x3333333333333333;
+	bits = (bits | bits << 1) & 0x5555555555555555;
+	return bits;
+  }
+};
+
+/**
+ * @class matrix_layout_iterator
+ *
+ * Random access iterator over the items of a matrix of Layout in row major
+ * order, so the STL algorithms see the same sequence for every layout
+ */
+template<typename Pointer, typename Layout>
+class matrix_layout_iterator {
+public:
+  using iterator_type = Pointer;
+  using iterator_category = std::random_access_iterator_tag;
+  using reference = decltype(*std::declval<Pointer>());
+  using value_type = typename std::remove_cv<typename std::remove_reference<reference>::type>::type;
+  using pointer = Pointer;
+  using difference_type = std::ptrdiff_t;
+
+public:
+  matrix_layout_iterator() noexcept = default;
+
+  matrix_layout_iterator(Pointer data, std::size_t rows, std::size_t cols, std::size_t index) noexcept
+	  : data_(data), rows_(rows), cols_(cols), index_(index) {}
+
+public:
+  reference operator*() const noexcept {
+	return data_[Layout::index(index_ / cols_, index_ % cols_, rows_, cols_)];
+  }
+
+  pointer operator->() const noexcept {
+	return data_ + Layout::index(index_ / cols_, index_ % cols_, rows_, cols_);
+  }
+
+  reference operator[](difference_type n) const noexcept {
+	return *(*this + n);
+  }
+
+  matrix_layout_iterator &operator++() noexcept {
+	++index_;
+	return *this;
+  }
+
+  matrix_layout_iterator operator++(int) noexcept {
+	matrix_layout_iterator it(*this);
+	++index_;
+	return it;
+  }
+
+  matrix_layout_iterator &operator--() noexcept {
+	--index_;
+	return *this;
+  }
+
+  matrix_layout_iterator operator--(int) noexcept {
+	matrix_layout_iterator it(*this);
+	--index_;
+	return it;
+  }
+
+  matrix_layout_iterator &operator+=(difference_type n) noexcept {
+	index_ += n;
+	return *this;
+  }
+
+  matrix_layout_iterator operator+(difference_type n) const noexcept {
+	return matrix_layout_iterator(data_, rows_, cols_, index_ + n);
+  }
+
+  matrix_layout_iterator &operator-=(difference_type n) noexcept {
+	index_ -= n;
+	return *this;
+  }
+
+  matrix_layout_iterator operator-(difference_type n) const noexcept {
+	return matrix_layout_iterator(data_, rows_, cols_, index_ - n);
+  }
+
+  difference_type operator-(const matrix_layout_iterator &other) const noexcept {
+	return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+  }
+
+  std::size_t Index() const noexcept {
+	return index_;
+  }
+
+private:
+  Pointer data_{};
+  std::size_t rows_ = 0, cols_ = 0, index_ = 0;
+};
+
+template<typename Pointer, typename Layout>
+matrix_layout_iterator<Pointer, Layout> inline operator+(std::ptrdiff_t n, const matrix_layout_iterator<Pointer, Layout> &it) {
+  return it + n;
+}
+
+template<typename Pointer, typename Layout>
+MATRIX_CXX17_NODISCARD
+inline bool operator==(const matrix_layout_iterator<Pointer, Layout> &lhs, const matrix_layout_iterator<Pointer, Layout> &rhs) {
+  return lhs.Index() == rhs.Index();
+}
+
+template<typename Pointer, typename Layout>
+MATRIX_CXX17_NODISCARD
+inline bool operator!=(const matrix_layout_iterator<Pointer, Layout> &lhs, const matrix_layout_iterator<Pointer, Layout> &rhs) {
+  return lhs.Index() != rhs.Index();
+}
+
+template<typename Pointer, typename Layout>
+MATRIX_CXX17_NODISCARD
+inline bool operator<(const matrix_layout_iterator<Pointer, Layout> &lhs, const matrix_layout_iterator<Pointer, Layout> &rhs) {
+  return lhs.Index() < rhs.Index();
+}
+
+template<typename Pointer, typename Layout>
+MATRIX_CXX17_NODISCARD
+inline bool operator>(const matrix_layout_iterator<Pointer, Layout> &lhs, const matrix_layout_iterator<Pointer, Layout> &rhs) {
+  return lhs.Index() > rhs.Index();
+}
+
+template<typename Pointer, typename Layout>
+MATRIX_CXX17_NODISCARD
+inline bool operator<=(const matrix_layout_iterator<Pointer, Layout> &lhs, const matrix_layout_iterator<Pointer, Layout> &rhs) {
+  return lhs.Index() <= rhs.Index();
+}
+
+template<typename Pointer, typename Layout>
+MATRIX_CXX17_NODISCARD
+inline bool operator>=(const matrix_layout_iterator<Pointer, Layout> &lhs, const matrix_layout_iterator<Pointer, Layout> &rhs) {
+  return lhs.Index() >= rhs.Index();
+}
+
+namespace detail {
+
+/**
+ * Iterators of a matrix of Layout, the row major storage
+ * keeps the pointer iterators of the container
+ */
+template<typename Pointer, typename Layout>
+struct layout_iterators {
+  using iterator = matrix_layout_iterator<Pointer, Layout>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+
+  static iterator make(Pointer data, std::size_t rows, std::size_t cols, std::size_t index) noexcept {
+	return iterator(data, rows, cols, index);
+  }
+
+  static reverse_iterator make_reverse(Pointer data, std::size_t rows, std::size_t cols, std::size_t index) noexcept {
+	return reverse_iterator(make(data, rows, cols, index));
+  }
+};
+
+template<typename Pointer>
+struct layout_iterators<Pointer, row_major> {
+  using iterator = matrix_normal_iterator<Pointer>;
+  using reverse_iterator = matrix_reverse_iterator<iterator>;
+
+  static MATRIX_CXX17_CONSTEXPR iterator make(Pointer data, std::size_t, std::size_t, std::size_t index) noexcept {
+	return iterator(data + index);
+  }
+
+  static MATRIX_CXX17_CONSTEXPR
+  reverse_iterator make_reverse(Pointer data, std::size_t, std::size_t, std::size_t index) noexcept {
+	return reverse_iterator(data + index - 1);
+  }
+};
+
+/**
+ * Side of the square blocks of the layout conversions and transposes
+ */
+MATRIX_CXX17_INLINE constexpr std::size_t layout_copy_block = 32;
+
+/**
+ * destination(row, col) = source(row, col), or source(col, row) when transposed.
+ * The items are copied in square blocks, so the strided side of the copy
+ * touches a few cache lines per block instead of one line per item
+ */
+template<typename Source, typename Destination>
+void copy_blocked(const Source &source, Destination &destination, bool transposed = false) {
+  const std::size_t rows = destination.rows(), cols = destination.cols();
+
+  for (std::size_t top = 0; top < rows; top += layout_copy_block) {
+	const std::size_t bottom = std::min(rows, top + layout_copy_block);
+
+	for (std::size_t left = 0; left < cols; left += layout_copy_block) {
+	  const std::size_t right = std::min(cols, left + layout_copy_block);
+
+	  if (transposed) {
+		for (std::size_t col = left; col != right; ++col)
+		  for (std::size_t row = top; row != bottom; ++row)
+			destination(row, col) = source(col, row);
+	  } else {
+		for (std::size_t row = top; row != bottom; ++row)
+		  for (std::size_t col = left; col != right; ++col)
+			destination(row, col) = source(row, col);
+	  }
+	}
+  }
+}
+
+/**
+ * Calls function(row, col, index) for the items of the rows [first, last)
+ * of a rows x cols matrix of Layout, index is Layout::index(row, col, rows, cols)
+ */
+template<typename Layout, typename Function>
+void for_each_layout_index(std::size_t rows, std::size_t cols, std::size_t first, std::size_t last,
+						   Function &&function, Layout) {
+  for (std::size_t left = 0; left < cols; left += layout_copy_block) {
+	const std::size_t right = std::min(cols, left + layout_copy_block);
+
+	for (std::size_t row = first; row != last; ++row)
+	  for (std::size_t col = left; col != right; ++col)
+		function(row, col, Layout::index(row, col, rows, cols));
+  }
+}
+
+/**
+ * Tiled storage is walked block by block, the items of a block are contiguous
+ */
+template<typename Function, std::size_t Tile>
+void for_each_layout_index(std::size_t rows, std::size_t cols, std::size_t first, std::size_t last,
+						   Function &&function, tiled<Tile>) {
+  for (std::size_t top = first / Tile * Tile; top < last; top += Tile) {
+	const std::size_t height = std::min(Tile, rows - top);
+	const std::size_t begin = std::max(first, top), end = std::min(last, top + height);
+
+	for (std::size_t left = 0; left < cols; left += Tile) {
+	  const std::size_t width = std::min(Tile, cols - left);
+	  const std::size_t block = top * cols + left * height;
+
+	  for (std::size_t row = begin; row != end; ++row)
+		for (std::size_t col = 0; col != width; ++col)
+		  function(row, left + col, block + (row - top) * width + col);
+	}
+  }
+}
+
+/**
+ * Z-order storage is walked in its own order
+ */
+template<typename Function>
+void for_each_layout_index(std::size_t rows, std::size_t cols, std::size_t first, std::size_t last,
+						   Function &&function, morton) {
+  morton::for_each_index(rows, cols, first, last, std::forward<Function>(function));
+}
+
+/**
+ * Column major storage is the row major storage of the transpose
+ */
+template<typename T>
+gemm_operand<T> make_layout_operand(const T *data, std::size_t, std::size_t cols, bool transposed, row_major) {
+  return make_gemm_operand(data, cols, transposed);
+}
+
+template<typename T>
+gemm_operand<T> make_layout_operand(const T *data, std::size_t rows, std::size_t, bool transposed, column_major) {
+  return make_gemm_operand(data, rows, !transposed);
+}
+
+/**
+ * Strided operand of the engine over a matrix. The engine reads row and
+ * column major storage in place, the other layouts are copied to row major
+ * storage once, so the panels are packed from it at the speed of row major
+ */
+template<typename Matrix, typename Layout = typename Matrix::layout_type>
+class engine_operand {
+public:
+  using value_type = typename Matrix::value_type;
+
+public:
+  engine_operand(const Matrix &m, bool transposed) : items_(new value_type[m.rows() * m.cols()]) {
+	const std::size_t cols = m.cols();
+	value_type *items = items_.get();
+	const value_type *data = m.data();
+
+	for_each_layout_index(m.rows(), cols, 0, m.rows(), [=](std::size_t row, std::size_t col, std::size_t index) {
+	  items[row * cols + col] = data[index];
+	}, Layout());
+	operand_ = make_gemm_operand<value_type>(items_.get(), m.cols(), transposed);
+  }
+
+  const gemm_operand<value_type> &get() const noexcept { return operand_; }
+
+private:
+  // Not std::vector, which has no data() for bool
+  std::unique_ptr<value_type[]> items_;
+  gemm_operand<value_type> operand_;
+};
+
+template<typename Matrix>
+class engine_operand<Matrix, row_major> {
+public:
+  using value_type = typename Matrix::value_type;
+
+public:
+  engine_operand(const Matrix &m, bool transposed)
+	  : operand_(make_layout_operand(m.data(), m.rows(), m.cols(), transposed, row_major())) {}
+
+  const gemm_operand<value_type> &get() const noexcept { return operand_; }
+
+private:
+  gemm_operand<value_type> operand_;
+};
+
+template<typename Matrix>
+class engine_operand<Matrix, column_major> {
+public:
+  using value_type = typename Matrix::value_type;
+
+public:
+  engine_operand(const Matrix &m, bool transposed)
+	  : operand_(make_layout_operand(m.data(), m.rows(), m.cols(), transposed, column_major())) {}
+
+  const gemm_operand<value_type> &get() const noexcept { return operand_; }
+
+private:
+  gemm_operand<value_type> operand_;
+};
+
+/**
+ * Computes c(m x n) += alpha * a * b into the storage c of Layout, a and b are
+ * matrices of any layout, the transposed ones are read as a^T and b^T
+ */
+template<typename T, typename Lhs, typename Rhs>
+void gemm_layout(std::size_t m, std::size_t n, std::size_t k,
+				 const Lhs &a, bool a_transposed, const Rhs &b, bool b_transposed,
+				 T *c, const T &alpha, row_major) {
+  const engine_operand<Lhs> lhs(a, a_transposed);
+  const engine_operand<Rhs> rhs(b, b_transposed);
+  gemm_accumulate(m, n, k, lhs.get(), rhs.get(), c, n, alpha);
+}
+
+/**
+ * Column major c is the row major storage of c^T = b^T * a^T
+ */
+template<typename T, typename Lhs, typename Rhs>
+void gemm_layout(std::size_t m, std::size_t n, std::size_t k,
+				 const Lhs &a, bool a_transposed, const Rhs &b, bool b_transposed,
+				 T *c, const T &alpha, column_major) {
+  const engine_operand<Rhs> rhs(b, !b_transposed);
+  const engine_operand<Lhs> lhs(a, !a_transposed);
+  gemm_accumulate(n, m, k, rhs.get(), lhs.get(), c, m, alpha);
+}
+
+/**
+ * Rows of c of the other layouts which are computed at once
+ * in a row major buffer, a multiple of the usual tile sizes
+ */
+MATRIX_CXX17_INLINE constexpr std::size_t layout_band_rows = 256;
+
+/**
+ * Adds the rows [top, top + height) of a m x n product kept row major in band to c of Layout
+ */
+template<typename T, typename Layout>
+void add_layout_band(std::size_t m, std::size_t n, std::size_t top, std::size_t height,
+					 const T *band, T *c, Layout) {
+  for_each_layout_index(m, n, top, top + height, [=](std::size_t row, std::size_t col, std::size_t index) {
+	c[index] += band[(row - top) * n + col];
+  }, Layout());
+}
+
+template<typename Layout>
+constexpr std::size_t layout_band_size(Layout) {
+  return layout_band_rows;
+}
+
+/**
+ * Bands of tiled c are whole rows of blocks
+ */
+template<std::size_t Tile>
+constexpr std::size_t layout_band_size(tiled<Tile>) {
+  return (layout_band_rows + Tile - 1) / Tile * Tile;
+}
+
+/**
+ * The other layouts of c get the row major product of a band of rows at a time,
+ * so every panel of b is packed once per band, and add it to c afterwards
+ */
+template<typename T, typename Lhs, typename Rhs, typename Layout>
+void gemm_layout(std::size_t m, std::size_t n, std::size_t k,
+				 const Lhs &a, bool a_transposed, const Rhs &b, bool b_transposed,
+				 T *c, const T &alpha, Layout) {
+  if (m == 0 || n == 0 || k == 0)
+	return;
+
+  const engine_operand<Lhs> lhs(a, a_transposed);
+  const engine_operand<Rhs> rhs(b, b_transposed);
+
+  const std::size_t band_rows = std::min(m, layout_band_size(Layout()));
+  std::unique_ptr<T[]> band(new T[band_rows * n]);
+
+  for (std::size_t top = 0; top < m; top += band_rows) {
+	const std::size_t height = std::min(band_rows, m - top);
+
+	std::fill(band.get(), band.get() + height * n, T{});
+	gemm_accumulate(height, n, k, lhs.get().block(top, 0), rhs.get(), band.get(), n, alpha);
+	add_layout_band(m, n, top, height, band.get(), c, Layout());
+  }
+}
+
+} // namespace detail end
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_LAYOUT_H_
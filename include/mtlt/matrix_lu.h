@@ -0,0 +1,242 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        The lu class keeps the LU factorization of a square matrix,
+ *        it is computed once in O(n^3) and then gives the determinant,
+ *        the inverse and solutions of linear systems
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_LU_H_
+#define MTLT_MATRIX_LU_H_
+
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_config.h>
+#include <mtlt/matrix_decomposition.h>
+
+namespace mtlt {
+
+/**
+ * determinant == sign * exp(log_abs), sign is 1, -1 or 0 for singular matrices
+ */
+template<typename T>
+struct slogdet_result {
+  T sign;
+  T log_abs;
+};
+
+/**
+ * @class lu
+ *
+ * Factorization P * A = L * U with partial pivoting, L has a unit diagonal.
+ * The factorization is blocked, updates of the trailing matrix
+ * run on the multiplication engine
+ *
+ * @code
+ *
+ * mtlt::matrix<int> a(3, 3, {2, 5, 0, 0, 9, 7, 8, 1, 3});
+ * mtlt::lu<double> factorization(a); // O(n^3) once
+ *
+ * double determinant = factorization.determinant(); // 320
+ * mtlt::matrix<double> x = factorization.solve(b); // a * x = b, O(n^2) per column of b
+ * factorization.solve_in_place(b); // b = x
+ * mtlt::matrix<double> inverse = factorization.inverse();
+ *
+ * @endcode
+ */
+template<typename T = double>
+class lu {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+public:
+  lu() = default;
+
+  template<typename U, typename Allocator, typename Layout>
+  explicit lu(const matrix<U, Allocator, Layout> &a) : factors_(detail::row_major_copy<T>(a)), pivots_(a.rows()) {
+	if (a.rows() != a.cols())
+	  throw std::logic_error("LU factorization can be found only for square matrices");
+
+	regular_ = detail::lu_factor(size(), size(), factors_.data(), size(), pivots_.data());
+  }
+
+public:
+  MATRIX_CXX17_NODISCARD
+  size_type size() const noexcept { return factors_.rows(); }
+
+  /**
+   * L and U packed into one matrix, the unit diagonal of L is not stored
+   */
+  MATRIX_CXX17_NODISCARD
+  const matrix<T> &factors() const noexcept { return factors_; }
+
+  /**
+   * Row i was swapped with row pivots()[i] at step i
+   */
+  MATRIX_CXX17_NODISCARD
+  const std::vector<size_type> &pivots() const noexcept { return pivots_; }
+
+  /**
+   * True if some pivot is exactly zero, solve() and inverse() throw then.
+   * inverse() also throws for a pivot negligible next to the largest item of U
+   */
+  MATRIX_CXX17_NODISCARD
+  bool singular() const noexcept { return !regular_; }
+
+  MATRIX_CXX17_NODISCARD
+  matrix<T> lower() const {
+	matrix<T> l(size(), size());
+
+	for (size_type row = 0; row != size(); ++row) {
+	  for (size_type col = 0; col != row; ++col)
+		l(row, col) = factors_(row, col);
+	  l(row, row) = T(1);
+	}
+
+	return l;
+  }
+
+  MATRIX_CXX17_NODISCARD
+  matrix<T> upper() const {
+	matrix<T> u(size(), size());
+
+	for (size_type row = 0; row != size(); ++row)
+	  for (size_type col = row; col != size(); ++col)
+		u(row, col) = factors_(row, col);
+
+	return u;
+  }
+
+  MATRIX_CXX17_NODISCARD
+  T determinant() const {
+	if (!regular_)
+	  return T{};
+
+	return detail::lu_determinant(size(), factors_.data(), size(), pivots_.data());
+  }
+
+  /**
+   * Sign and logarithm of |determinant|, they stay finite where
+   * determinant() overflows to inf or underflows to zero
+   */
+  MATRIX_CXX17_NODISCARD
+  slogdet_result<T> slogdet() const {
+	slogdet_result<T> result{T{}, -std::numeric_limits<T>::infinity()};
+	if (regular_)
+	  result.log_abs = detail::lu_log_determinant(size(), factors_.data(), size(), pivots_.data(), result.sign);
+	return result;
+  }
+
+  /**
+   * Solves A * X = B for every column of b
+   */
+  template<typename U, typename Allocator, typename Layout>
+  MATRIX_CXX17_NODISCARD
+  matrix<T> solve(const matrix<U, Allocator, Layout> &b) const {
+	matrix<T> x = detail::row_major_copy<T>(b);
+	solve_in_place(x);
+	return x;
+  }
+
+  template<typename U>
+  MATRIX_CXX17_NODISCARD
+  std::vector<T> solve(const std::vector<U> &b) const {
+	std::vector<T> x(b.begin(), b.end());
+	solve_in_place(x);
+	return x;
+  }
+
+  /**
+   * Overwrites b with the solution of A * X = B, nothing is allocated
+   */
+  template<typename Allocator>
+  void solve_in_place(matrix<T, Allocator> &b) const {
+	if (b.rows() != size())
+	  throw std::logic_error("Can't solve the system because b.rows() != size()");
+
+	solve_items(b.data(), b.cols(), b.cols());
+  }
+
+  void solve_in_place(std::vector<T> &b) const {
+	if (b.size() != size())
+	  throw std::logic_error("Can't solve the system because b.size() != size()");
+
+	solve_items(b.data(), 1, 1);
+  }
+
+  MATRIX_CXX17_NODISCARD
+  matrix<T> inverse() const {
+	if (detail::lu_negligible_pivot(size(), factors_.data(), size()))
+	  throw std::logic_error("Can't found inverse matrix because the matrix is singular");
+
+	matrix<T> inverted = matrix<T>::identity(size(), size());
+	solve_in_place(inverted);
+	return inverted;
+  }
+
+private:
+  void solve_items(T *b, size_type nrhs, size_type ldb) const {
+	if (!regular_)
+	  throw std::logic_error("Can't solve the system because the matrix is singular");
+
+	detail::lu_solve(size(), factors_.data(), size(), pivots_.data(), nrhs, b, ldb);
+  }
+
+private:
+  matrix<T> factors_;
+  std::vector<size_type> pivots_;
+  bool regular_ = true;
+};
+
+/**
+ * Sign and logarithm of the absolute determinant of a square matrix from
+ * its LU factorization. For symmetric positive definite matrices
+ * mtlt::cholesky::slogdet() is twice as fast
+ *
+ * @code
+ *
+ * mtlt::matrix<double> covariance(1000, 1000);
+ * mtlt::slogdet_result<double> det = mtlt::slogdet(covariance);
+ *
+ * det.sign; // 1, -1 or 0
+ * det.log_abs; // Finite where determinant_gaussian() gives inf or 0
+ *
+ * @endcode
+ */
+#if __cplusplus > 201703L
+template<typename T, typename Allocator, typename Layout> requires (std::floating_point<T>)
+slogdet_result<T> slogdet(const matrix<T, Allocator, Layout> &a) {
+#else
+template<typename T, typename Allocator, typename Layout>
+slogdet_result<T> slogdet(const matrix<T, Allocator, Layout> &a) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  return lu<T>(a).slogdet();
+}
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_LU_H_
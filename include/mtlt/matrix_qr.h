@@ -0,0 +1,238 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        The qr class keeps the Householder QR factorization of any matrix,
+ *        it gives the orthogonal and triangular factors and solves
+ *        overdetermined systems in the least squares sense without
+ *        forming the badly conditioned a^T * a
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_QR_H_
+#define MTLT_MATRIX_QR_H_
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_config.h>
+#include <mtlt/matrix_decomposition.h>
+
+namespace mtlt {
+
+/**
+ * @class qr
+ *
+ * Factorization A = Q * R of a m x n matrix, Q is kept as k = min(m, n)
+ * Householder reflectors. The reflectors are grouped in panels and applied
+ * in the compact WY form I - V * T * V^T, so a panel updates the columns
+ * to its right with three products instead of one reflector at a time
+ *
+ * @code
+ *
+ * mtlt::matrix<double> a(100000, 50), b(100000, 1);
+ * mtlt::qr<double> factorization(a);
+ *
+ * mtlt::matrix<double> x = factorization.solve(b); // min |a * x - b|, x is 50 x 1
+ * mtlt::matrix<double> q = factorization.thin_q(); // 100000 x 50, not 100000 x 100000
+ * mtlt::matrix<double> r = factorization.r(); // 50 x 50
+ *
+ * @endcode
+ */
+template<typename T = double>
+class qr {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+public:
+  qr() = default;
+
+  template<typename U, typename Allocator, typename Layout>
+  explicit qr(const matrix<U, Allocator, Layout> &a)
+	  : factors_(detail::row_major_copy<T>(a)), tau_(std::min(a.rows(), a.cols())),
+		t_(detail::qr_block_size * tau_.size()) {
+	std::vector<T> workspace(detail::qr_workspace_size(cols(), 0));
+	detail::qr_factor(rows(), cols(), factors_.data(), cols(), tau_.data(), t_.data(), tau_.size(), workspace.data());
+  }
+
+public:
+  MATRIX_CXX17_NODISCARD
+  size_type rows() const noexcept { return factors_.rows(); }
+
+  MATRIX_CXX17_NODISCARD
+  size_type cols() const noexcept { return factors_.cols(); }
+
+  /**
+   * R above the diagonal and the Householder vectors below it,
+   * the unit leading items of the vectors are not stored
+   */
+  MATRIX_CXX17_NODISCARD
+  const matrix<T> &factors() const noexcept { return factors_; }
+
+  /**
+   * Reflector i is I - tau()[i] * v * v^T
+   */
+  MATRIX_CXX17_NODISCARD
+  const std::vector<T> &tau() const noexcept { return tau_; }
+
+  /**
+   * The k x n upper trapezoidal factor
+   */
+  MATRIX_CXX17_NODISCARD
+  matrix<T> r() const {
+	matrix<T> upper(tau_.size(), cols());
+
+	for (size_type row = 0; row != upper.rows(); ++row)
+	  for (size_type col = row; col != cols(); ++col)
+		upper(row, col) = factors_(row, col);
+
+	return upper;
+  }
+
+  /**
+   * The first k columns of Q, thin_q() * r() == A
+   */
+  MATRIX_CXX17_NODISCARD
+  matrix<T> thin_q() const {
+	matrix<T> q(rows(), tau_.size());
+	for (size_type i = 0; i != q.cols(); ++i)
+	  q(i, i) = T(1);
+
+	apply_q(q);
+	return q;
+  }
+
+  /**
+   * The full m x m orthogonal factor
+   */
+  MATRIX_CXX17_NODISCARD
+  matrix<T> q() const {
+	matrix<T> full = matrix<T>::identity(rows(), rows());
+	apply_q(full);
+	return full;
+  }
+
+  /**
+   * Overwrites b(m x nrhs) with Q * b
+   */
+  template<typename Allocator>
+  void apply_q(matrix<T, Allocator> &b) const { apply(false, b); }
+
+  /**
+   * Overwrites b(m x nrhs) with Q^T * b
+   */
+  template<typename Allocator>
+  void apply_qt(matrix<T, Allocator> &b) const { apply(true, b); }
+
+  /**
+   * Least squares solution of A * X = B for every column of b, needs rows() >= cols()
+   * and R of full rank. Returns a cols() x b.cols() matrix
+   */
+  template<typename U, typename Allocator, typename Layout>
+  MATRIX_CXX17_NODISCARD
+  matrix<T> solve(const matrix<U, Allocator, Layout> &b) const {
+	if (b.rows() != rows())
+	  throw std::logic_error("Can't solve the system because b.rows() != rows()");
+
+	matrix<T> x = detail::row_major_copy<T>(b);
+	solve_items(x.data(), x.cols(), x.cols());
+	x.resize(cols(), x.cols());
+	return x;
+  }
+
+  template<typename U>
+  MATRIX_CXX17_NODISCARD
+  std::vector<T> solve(const std::vector<U> &b) const {
+	if (b.size() != rows())
+	  throw std::logic_error("Can't solve the system because b.size() != rows()");
+
+	std::vector<T> x(b.begin(), b.end());
+	solve_items(x.data(), 1, 1);
+	x.resize(cols());
+	return x;
+  }
+
+private:
+  template<typename Allocator>
+  void apply(bool transposed, matrix<T, Allocator> &b) const {
+	if (b.rows() != rows())
+	  throw std::logic_error("Can't apply Q because b.rows() != rows()");
+
+	std::vector<T> workspace(detail::qr_workspace_size(0, b.cols()));
+	detail::qr_apply(rows(), tau_.size(), factors_.data(), cols(), t_.data(), tau_.size(),
+					 transposed, b.cols(), b.data(), b.cols(), workspace.data());
+  }
+
+  void solve_items(T *b, size_type nrhs, size_type ldb) const {
+	if (rows() < cols())
+	  throw std::logic_error("Can't solve the least squares problem because rows() < cols()");
+
+	for (size_type i = 0; i != cols(); ++i)
+	  if (factors_(i, i) == T{})
+		throw std::logic_error("Can't solve the least squares problem because the matrix is rank deficient");
+
+	std::vector<T> workspace(detail::qr_workspace_size(0, nrhs));
+	detail::qr_apply(rows(), cols(), factors_.data(), cols(), t_.data(), cols(),
+					 true, nrhs, b, ldb, workspace.data());
+	detail::trsm_upper(cols(), nrhs, detail::make_gemm_operand(factors_.data(), cols()), b, ldb);
+  }
+
+private:
+  matrix<T> factors_;
+  std::vector<T> tau_;
+  std::vector<T> t_;
+};
+
+/**
+ * Least squares solution of a * x = b for a with a.rows() >= a.cols() of full rank,
+ * QR is used instead of the normal equations, so the accuracy depends on
+ * the condition number of a and not on its square
+ *
+ * @code
+ *
+ * mtlt::matrix<double> a(100000, 50), b(100000, 3);
+ * mtlt::matrix<double> x = mtlt::lstsq(a, b); // 50 x 3
+ *
+ * @endcode
+ */
+template<typename T, typename Allocator, typename Layout, typename OtherAllocator, typename OtherLayout>
+MATRIX_CXX17_NODISCARD
+matrix<T> lstsq(const matrix<T, Allocator, Layout> &a, const matrix<T, OtherAllocator, OtherLayout> &b) {
+  if (a.rows() != b.rows())
+	throw std::logic_error("Can't solve the least squares problem because a.rows() != b.rows()");
+
+  return qr<T>(a).solve(b);
+}
+
+template<typename T, typename Allocator, typename Layout>
+MATRIX_CXX17_NODISCARD
+std::vector<T> lstsq(const matrix<T, Allocator, Layout> &a, const std::vector<T> &b) {
+  if (a.rows() != b.size())
+	throw std::logic_error("Can't solve the least squares problem because a.rows() != b.size()");
+
+  return qr<T>(a).solve(b);
+}
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_QR_H_
@@ -0,0 +1,185 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        The quantized multiplication multiplies int8 and uint8 matrices
+ *        into int32 accumulators on the blocked engine, the items are
+ *        widened and shifted by their zero points while they are packed
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_QUANTIZED_H_
+#define MTLT_MATRIX_QUANTIZED_H_
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_gemm.h>
+#include <mtlt/matrix_layout.h>
+
+namespace mtlt {
+
+/**
+ * @struct quantization
+ *
+ * Real value of a quantized item q is scale * (q - zero_point).
+ * Zero points and scales are given per row of lhs and per column of rhs,
+ * empty vectors mean that zero_point and scale are shared by all of them
+ *
+ * @code
+ *
+ * mtlt::quantization activations;
+ * activations.zero_point = 128; // uint8 activations
+ * activations.scale = 0.02f;
+ *
+ * mtlt::quantization weights;
+ * weights.scales = {...}; // One scale per output channel (column of rhs)
+ *
+ * @endcode
+ */
+struct quantization {
+  std::int32_t zero_point = 0;
+  std::vector<std::int32_t> zero_points;
+
+  float scale = 1;
+  std::vector<float> scales;
+
+  std::int32_t zero_point_at(std::size_t index) const {
+	return zero_points.empty() ? zero_point : zero_points[index];
+  }
+
+  float scale_at(std::size_t index) const {
+	return scales.empty() ? scale : scales[index];
+  }
+};
+
+namespace detail {
+
+template<typename T>
+struct is_quantized_type : std::integral_constant<bool,
+												  std::is_same<T, std::int8_t>::value ||
+													  std::is_same<T, std::uint8_t>::value> {
+};
+
+/**
+ * @struct quantized_operand
+ *
+ * Operand of the engine which reads items of type S and returns
+ * them widened to int32 and shifted by the zero point of their row
+ * (lhs) or column (rhs), zeros is null when the zero point is shared
+ */
+template<typename S>
+struct quantized_operand {
+  const S *data;
+  std::size_t row_stride;
+  std::size_t col_stride;
+
+  std::int32_t zero;
+  const std::int32_t *row_zeros;
+  const std::int32_t *col_zeros;
+
+  std::int32_t operator()(std::size_t row, std::size_t col) const {
+	const std::int32_t shift = row_zeros ? row_zeros[row] : col_zeros ? col_zeros[col] : zero;
+	return static_cast<std::int32_t>(data[row * row_stride + col * col_stride]) - shift;
+  }
+
+  quantized_operand block(std::size_t row, std::size_t col) const {
+	return {data + row * row_stride + col * col_stride, row_stride, col_stride, zero,
+			row_zeros ? row_zeros + row : nullptr,
+			col_zeros ? col_zeros + col : nullptr};
+  }
+};
+
+inline void check_quantization(const quantization &q, std::size_t size, const char *message) {
+  if ((!q.zero_points.empty() && q.zero_points.size() != size) || (!q.scales.empty() && q.scales.size() != size))
+	throw std::logic_error(message);
+}
+
+} // namespace detail end
+
+/**
+ * Computes the int32 product of quantized matrices, item (i, j) of the result is
+ * sum over k of (lhs(i, k) - lhs_zero_point(i)) * (rhs(k, j) - rhs_zero_point(j)).
+ * Scales are not applied, see dequantize. The accumulators overflow when
+ * lhs.cols() is above 33000 for the widest uint8 ranges
+ *
+ * @code
+ *
+ * mtlt::matrix<std::uint8_t> activations(batch, 512);
+ * mtlt::matrix<std::int8_t> weights(512, 256);
+ * mtlt::matrix<std::int32_t> accumulators = mtlt::gemm_s8(activations, weights, activations_q, weights_q);
+ * mtlt::matrix<float> outputs = mtlt::dequantize(accumulators, activations_q, weights_q);
+ *
+ * @endcode
+ */
+template<typename A, typename B, typename AllocatorA, typename AllocatorB, typename LayoutA, typename LayoutB>
+matrix<std::int32_t> gemm_s8(const matrix<A, AllocatorA, LayoutA> &lhs, const matrix<B, AllocatorB, LayoutB> &rhs,
+							 const quantization &lhs_quantization = quantization(),
+							 const quantization &rhs_quantization = quantization()) {
+  static_assert(detail::is_quantized_type<A>::value && detail::is_quantized_type<B>::value,
+				"Operands must be int8_t or uint8_t matrices");
+
+  if (lhs.cols() != rhs.rows())
+	throw std::logic_error("Can't multiply two matrices because lhs.cols() != rhs.rows()");
+
+  detail::check_quantization(lhs_quantization, lhs.rows(), "Quantization of lhs must have lhs.rows() items");
+  detail::check_quantization(rhs_quantization, rhs.cols(), "Quantization of rhs must have rhs.cols() items");
+
+  // Row and column major operands are read in place, the others are copied to row major once
+  const detail::engine_operand<matrix<A, AllocatorA, LayoutA>> lhs_items(lhs, false);
+  const detail::engine_operand<matrix<B, AllocatorB, LayoutB>> rhs_items(rhs, false);
+
+  const detail::quantized_operand<A> a{
+	  lhs_items.get().data, lhs_items.get().row_stride, lhs_items.get().col_stride, lhs_quantization.zero_point,
+	  lhs_quantization.zero_points.empty() ? nullptr : lhs_quantization.zero_points.data(), nullptr};
+  const detail::quantized_operand<B> b{
+	  rhs_items.get().data, rhs_items.get().row_stride, rhs_items.get().col_stride, rhs_quantization.zero_point,
+	  nullptr, rhs_quantization.zero_points.empty() ? nullptr : rhs_quantization.zero_points.data()};
+
+  matrix<std::int32_t> accumulators(lhs.rows(), rhs.cols());
+  detail::gemm_accumulate(lhs.rows(), rhs.cols(), lhs.cols(), a, b, accumulators.data(), accumulators.cols());
+
+  return accumulators;
+}
+
+/**
+ * Converts int32 accumulators of gemm_s8 to real values,
+ * item (i, j) is multiplied by lhs_scale(i) * rhs_scale(j)
+ */
+inline matrix<float> dequantize(const matrix<std::int32_t> &accumulators,
+								const quantization &lhs_quantization,
+								const quantization &rhs_quantization) {
+  detail::check_quantization(lhs_quantization, accumulators.rows(), "Quantization of lhs must have rows() items");
+  detail::check_quantization(rhs_quantization, accumulators.cols(), "Quantization of rhs must have cols() items");
+
+  matrix<float> result(accumulators.rows(), accumulators.cols());
+
+  for (std::size_t row = 0; row != result.rows(); ++row) {
+	const float row_scale = lhs_quantization.scale_at(row);
+	for (std::size_t col = 0; col != result.cols(); ++col)
+	  result(row, col) = static_cast<float>(accumulators(row, col)) * row_scale * rhs_quantization.scale_at(col);
+  }
+
+  return result;
+}
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_QUANTIZED_H_
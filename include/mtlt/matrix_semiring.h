@@ -0,0 +1,192 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        Semirings replace + and * of the matrix product, e.g. the min-plus
+ *        product of distance matrices gives shortest paths. Products over
+ *        semirings run on the blocked and parallel multiplication engine
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_SEMIRING_H_
+#define MTLT_MATRIX_SEMIRING_H_
+
+#include <limits>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_gemm.h>
+#include <mtlt/matrix_layout.h>
+
+namespace mtlt {
+
+/**
+ * @struct min_plus
+ *
+ * Tropical semiring (min, +), zero() is infinity (numeric_limits<T>::max()
+ * for integral T) and a sum with an infinite term is infinite.
+ * The product of distance matrices gives the shortest paths of two edges
+ */
+template<typename T>
+struct min_plus {
+  using value_type = T;
+
+  static constexpr T zero() { return detail::positive_infinity<T>(); }
+  static constexpr T one() { return T{}; }
+  static T add(const T &x, const T &y) { return y < x ? y : x; }
+  static T mul(const T &x, const T &y) {
+	return std::numeric_limits<T>::has_infinity || (x != zero() && y != zero()) ? x + y : zero();
+  }
+};
+
+/**
+ * @struct max_plus
+ *
+ * Semiring (max, +), zero() is minus infinity (numeric_limits<T>::lowest()
+ * for integral T). The product gives the longest paths, e.g. critical paths
+ */
+template<typename T>
+struct max_plus {
+  using value_type = T;
+
+  static constexpr T zero() { return detail::negative_infinity<T>(); }
+  static constexpr T one() { return T{}; }
+  static T add(const T &x, const T &y) { return x < y ? y : x; }
+  static T mul(const T &x, const T &y) {
+	return std::numeric_limits<T>::has_infinity || (x != zero() && y != zero()) ? x + y : zero();
+  }
+};
+
+/**
+ * @struct boolean
+ *
+ * Semiring (or, and), non zero items are true and results are 0 or 1.
+ * The product of adjacency matrices tells which vertices are connected
+ */
+template<typename T>
+struct boolean {
+  using value_type = T;
+
+  static constexpr T zero() { return T{}; }
+  static constexpr T one() { return T(1); }
+  static T add(const T &x, const T &y) { return static_cast<T>(x != T{} || y != T{}); }
+  static T mul(const T &x, const T &y) { return static_cast<T>(x != T{} && y != T{}); }
+};
+
+/**
+ * @struct bottleneck
+ *
+ * Semiring (max, min), the product of capacity matrices gives
+ * the widest paths: the path capacity is its narrowest edge
+ */
+template<typename T>
+struct bottleneck {
+  using value_type = T;
+
+  static constexpr T zero() { return detail::negative_infinity<T>(); }
+  static constexpr T one() { return detail::positive_infinity<T>(); }
+  static T add(const T &x, const T &y) { return x < y ? y : x; }
+  static T mul(const T &x, const T &y) { return y < x ? y : x; }
+};
+
+namespace detail {
+
+template<typename T>
+struct simd_semiring<min_plus<T>> : std::true_type {
+  static constexpr semiring_op op = semiring_op::min_plus;
+};
+
+template<typename T>
+struct simd_semiring<max_plus<T>> : std::true_type {
+  static constexpr semiring_op op = semiring_op::max_plus;
+};
+
+template<typename T>
+struct simd_semiring<bottleneck<T>> : std::true_type {
+  static constexpr semiring_op op = semiring_op::max_min;
+};
+
+template<typename Semiring, typename T, typename Allocator, typename Lhs, typename Rhs>
+void semiring_multiply(const Lhs &lhs, const Rhs &rhs, matrix<T, Allocator, row_major> &multiplied, std::true_type) {
+  const engine_operand<Lhs> a(lhs, false);
+  const engine_operand<Rhs> b(rhs, false);
+  gemm_accumulate(multiplied.rows(), multiplied.cols(), lhs.cols(), a.get(), b.get(),
+				  multiplied.data(), multiplied.cols(), Semiring::one(), Semiring());
+}
+
+/**
+ * The engine writes a row major buffer, it is copied to multiplied of other layouts
+ */
+template<typename Semiring, typename T, typename Allocator, typename Layout, typename Lhs, typename Rhs>
+void semiring_multiply(const Lhs &lhs, const Rhs &rhs, matrix<T, Allocator, Layout> &multiplied, std::true_type) {
+  matrix<T> buffer(multiplied.rows(), multiplied.cols(), Semiring::zero());
+  semiring_multiply<Semiring>(lhs, rhs, buffer, std::true_type());
+  copy_blocked(buffer, multiplied);
+}
+
+template<typename Semiring, typename T, typename Allocator, typename Layout, typename Lhs, typename Rhs>
+void semiring_multiply(const Lhs &lhs, const Rhs &rhs, matrix<T, Allocator, Layout> &multiplied, std::false_type) {
+  for (std::size_t row = 0; row != multiplied.rows(); ++row)
+	for (std::size_t k = 0; k != lhs.cols(); ++k)
+	  for (std::size_t col = 0; col != multiplied.cols(); ++col)
+		multiplied(row, col) = Semiring::add(multiplied(row, col), Semiring::mul(lhs(row, k), rhs(k, col)));
+}
+
+} // namespace detail end
+
+/**
+ * Multiplies lhs by rhs over Semiring: result(i, j) is the Semiring::add
+ * of Semiring::mul(lhs(i, k), rhs(k, j)) over k. Products of arithmetic
+ * types run on the multiplication engine, min_plus, max_plus and bottleneck
+ * over float, double and int32_t have vector kernels. The result has the
+ * allocator and the layout of lhs
+ *
+ * @code
+ *
+ * const int inf = mtlt::min_plus<int>::zero();
+ * mtlt::matrix<int> dist(3, 3, {0, 4, inf,
+ *                               inf, 0, 1,
+ *                               2, inf, 0});
+ *
+ * mtlt::matrix<int> two = mtlt::mul<mtlt::min_plus<int>>(dist, dist); // paths of at most 2 edges
+ * // two = { 0, 4, 5,
+ * //         3, 0, 1,
+ * //         2, 6, 0 }
+ *
+ * @endcode
+ */
+#if __cplusplus > 201703L
+template<typename Semiring, typename T, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+requires (std::same_as<typename Semiring::value_type, T>)
+matrix<T, Allocator, Layout> mul(const matrix<T, Allocator, Layout> &lhs, const matrix<T, OtherAllocator, OtherLayout> &rhs) {
+#else
+template<typename Semiring, typename T, typename Allocator, typename OtherAllocator, typename Layout, typename OtherLayout>
+matrix<T, Allocator, Layout> mul(const matrix<T, Allocator, Layout> &lhs, const matrix<T, OtherAllocator, OtherLayout> &rhs) {
+  static_assert(std::is_same<typename Semiring::value_type, T>::value, "Semiring::value_type must be T");
+#endif
+  if (lhs.cols() != rhs.rows())
+	throw std::logic_error("Can't multiply two matrices because lhs.cols() != rhs.rows()");
+
+  matrix<T, Allocator, Layout> multiplied(lhs.rows(), rhs.cols(), Semiring::zero(), lhs.get_allocator());
+  detail::semiring_multiply<Semiring>(lhs, rhs, multiplied, std::is_arithmetic<T>());
+  return multiplied;
+}
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_SEMIRING_H_
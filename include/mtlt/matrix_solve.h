@@ -0,0 +1,149 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        Linear systems A * X = B are solved by the LU factorization of A
+ *        and blocked triangular solves, all columns of B are solved at once
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_SOLVE_H_
+#define MTLT_MATRIX_SOLVE_H_
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_lu.h>
+#include <mtlt/static_matrix.h>
+#include <mtlt/matrix_decomposition.h>
+
+namespace mtlt {
+
+namespace detail {
+
+template<typename T>
+void solve_in_place(std::size_t n, T *a, std::size_t *pivots, std::size_t nrhs, T *b) {
+  if (!lu_factor(n, n, a, n, pivots))
+	throw std::logic_error("Can't solve the system because the matrix is singular");
+
+  lu_solve(n, a, n, pivots, nrhs, b, nrhs);
+}
+
+} // namespace detail end
+
+/**
+ * Solves a * x = b for every column of b. To solve many systems
+ * with the same a keep its factorization in mtlt::lu instead
+ *
+ * @code
+ *
+ * mtlt::matrix<double> a(500, 500), b(500, 20);
+ * mtlt::matrix<double> x = mtlt::solve(a, b); // a * x == b
+ *
+ * std::vector<double> y = mtlt::solve(a, std::vector<double>(500, 1.0));
+ *
+ * @endcode
+ */
+#if __cplusplus > 201703L
+template<typename T, typename Allocator, typename Layout, typename OtherAllocator, typename OtherLayout>
+  requires (std::floating_point<T>)
+matrix<T> solve(const matrix<T, Allocator, Layout> &a, const matrix<T, OtherAllocator, OtherLayout> &b) {
+#else
+template<typename T, typename Allocator, typename Layout, typename OtherAllocator, typename OtherLayout>
+matrix<T> solve(const matrix<T, Allocator, Layout> &a, const matrix<T, OtherAllocator, OtherLayout> &b) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  if (a.rows() != b.rows())
+	throw std::logic_error("Can't solve the system because a.rows() != b.rows()");
+
+  return lu<T>(a).solve(b);
+}
+
+#if __cplusplus > 201703L
+template<typename T, typename Allocator, typename Layout> requires (std::floating_point<T>)
+std::vector<T> solve(const matrix<T, Allocator, Layout> &a, const std::vector<T> &b) {
+#else
+template<typename T, typename Allocator, typename Layout>
+std::vector<T> solve(const matrix<T, Allocator, Layout> &a, const std::vector<T> &b) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  if (a.rows() != b.size())
+	throw std::logic_error("Can't solve the system because a.rows() != b.size()");
+
+  return lu<T>(a).solve(b);
+}
+
+/**
+ * Solves a * x = b without allocating matrices: a is overwritten
+ * by its LU factors and b by the solution
+ *
+ * @code
+ *
+ * mtlt::matrix<double> a(500, 500), b(500, 20);
+ * mtlt::solve_in_place(a, b); // b is x now
+ *
+ * @endcode
+ */
+#if __cplusplus > 201703L
+template<typename T, typename Allocator, typename OtherAllocator> requires (std::floating_point<T>)
+void solve_in_place(matrix<T, Allocator> &a, matrix<T, OtherAllocator> &b) {
+#else
+template<typename T, typename Allocator, typename OtherAllocator>
+void solve_in_place(matrix<T, Allocator> &a, matrix<T, OtherAllocator> &b) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  if (a.rows() != a.cols())
+	throw std::logic_error("Can't solve the system because a is not square");
+  if (a.rows() != b.rows())
+	throw std::logic_error("Can't solve the system because a.rows() != b.rows()");
+
+  std::vector<std::size_t> pivots(a.rows());
+  detail::solve_in_place(a.rows(), a.data(), pivots.data(), b.cols(), b.data());
+}
+
+#if __cplusplus > 201703L
+template<typename T, std::size_t N, std::size_t M> requires (std::floating_point<T>)
+void solve_in_place(static_matrix<T, N, N> &a, static_matrix<T, N, M> &b) {
+#else
+template<typename T, std::size_t N, std::size_t M>
+void solve_in_place(static_matrix<T, N, N> &a, static_matrix<T, N, M> &b) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  std::array<std::size_t, N> pivots{};
+  detail::solve_in_place(N, a.data(), pivots.data(), M, b.data());
+}
+
+#if __cplusplus > 201703L
+template<typename T, std::size_t N, std::size_t M> requires (std::floating_point<T>)
+static_matrix<T, N, M> solve(const static_matrix<T, N, N> &a, const static_matrix<T, N, M> &b) {
+#else
+template<typename T, std::size_t N, std::size_t M>
+static_matrix<T, N, M> solve(const static_matrix<T, N, N> &a, const static_matrix<T, N, M> &b) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  static_matrix<T, N, N> factors(a);
+  static_matrix<T, N, M> x(b);
+  solve_in_place(factors, x);
+  return x;
+}
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_SOLVE_H_
@@ -0,0 +1,191 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        The Strassen-Winograd multiplication does 7 half sized products
+ *        instead of 8 on every level of recursion and hands off to the
+ *        blocked engine below a cutoff, it pays off for very large matrices
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_STRASSEN_H_
+#define MTLT_MATRIX_STRASSEN_H_
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_gemm.h>
+
+namespace mtlt {
+
+/**
+ * Recursion stops when any of m, n, k is below this value, the seven
+ * products only outweigh the extra additions from about 4096 on
+ */
+MATRIX_CXX17_INLINE constexpr std::size_t strassen_default_cutoff = 2048;
+
+namespace detail {
+
+template<typename T>
+void block_add(std::size_t m, std::size_t n, const T *a, std::size_t lda,
+			   const T *b, std::size_t ldb, T *c, std::size_t ldc) {
+  for (std::size_t i = 0; i != m; ++i)
+	for (std::size_t j = 0; j != n; ++j)
+	  c[i * ldc + j] = a[i * lda + j] + b[i * ldb + j];
+}
+
+template<typename T>
+void block_sub(std::size_t m, std::size_t n, const T *a, std::size_t lda,
+			   const T *b, std::size_t ldb, T *c, std::size_t ldc) {
+  for (std::size_t i = 0; i != m; ++i)
+	for (std::size_t j = 0; j != n; ++j)
+	  c[i * ldc + j] = a[i * lda + j] - b[i * ldb + j];
+}
+
+template<typename T>
+void block_zero(std::size_t m, std::size_t n, T *c, std::size_t ldc) {
+  for (std::size_t i = 0; i != m; ++i)
+	std::fill(c + i * ldc, c + i * ldc + n, T{});
+}
+
+/**
+ * Scratch of one recursion level is X (m/2 x max(k/2, n/2)) and Y (k/2 x n/2),
+ * the levels are laid out one after another in a single buffer
+ */
+inline std::size_t strassen_workspace_size(std::size_t m, std::size_t n, std::size_t k, std::size_t cutoff) {
+  std::size_t size = 0;
+
+  while (m >= cutoff && n >= cutoff && k >= cutoff && m >= 2 && n >= 2 && k >= 2) {
+	m /= 2, n /= 2, k /= 2;
+	size += m * std::max(k, n) + k * n;
+  }
+
+  return size;
+}
+
+/**
+ * Computes c(m x n) = a(m x k) * b(k x n). Odd rows and columns are peeled
+ * off and fixed up with the blocked engine, the even part is split into
+ * 2 x 2 blocks and computed with the Winograd schedule of 7 products and
+ * 15 additions which uses the quadrants of c as scratch besides X and Y
+ */
+template<typename T>
+void strassen_multiply(std::size_t m, std::size_t n, std::size_t k,
+					   const T *a, std::size_t lda, const T *b, std::size_t ldb, T *c, std::size_t ldc,
+					   std::size_t cutoff, T *workspace) {
+  if (m < cutoff || n < cutoff || k < cutoff || m < 2 || n < 2 || k < 2) {
+	block_zero(m, n, c, ldc);
+	gemm_accumulate(m, n, k, a, lda, b, ldb, c, ldc);
+	return;
+  }
+
+  const std::size_t m2 = m / 2, n2 = n / 2, k2 = k / 2;
+
+  const T *a11 = a, *a12 = a + k2, *a21 = a + m2 * lda, *a22 = a21 + k2;
+  const T *b11 = b, *b12 = b + n2, *b21 = b + k2 * ldb, *b22 = b21 + n2;
+  T *c11 = c, *c12 = c + n2, *c21 = c + m2 * ldc, *c22 = c21 + n2;
+
+  const std::size_t ldx = std::max(k2, n2), ldy = n2;
+  T *x = workspace, *y = workspace + m2 * ldx;
+  T *next = y + k2 * ldy;
+
+  block_sub(m2, k2, a11, lda, a21, lda, x, ldx);                     // X = S3 = A11 - A21
+  block_sub(k2, n2, b22, ldb, b12, ldb, y, ldy);                     // Y = T3 = B22 - B12
+  strassen_multiply(m2, n2, k2, x, ldx, y, ldy, c21, ldc, cutoff, next); // C21 = P7 = S3 * T3
+
+  block_add(m2, k2, a21, lda, a22, lda, x, ldx);                     // X = S1 = A21 + A22
+  block_sub(k2, n2, b12, ldb, b11, ldb, y, ldy);                     // Y = T1 = B12 - B11
+  strassen_multiply(m2, n2, k2, x, ldx, y, ldy, c22, ldc, cutoff, next); // C22 = P5 = S1 * T1
+
+  block_sub(m2, k2, x, ldx, a11, lda, x, ldx);                       // X = S2 = S1 - A11
+  block_sub(k2, n2, b22, ldb, y, ldy, y, ldy);                       // Y = T2 = B22 - T1
+  strassen_multiply(m2, n2, k2, x, ldx, y, ldy, c12, ldc, cutoff, next); // C12 = P6 = S2 * T2
+
+  block_sub(m2, k2, a12, lda, x, ldx, x, ldx);                       // X = S4 = A12 - S2
+  strassen_multiply(m2, n2, k2, x, ldx, b22, ldb, c11, ldc, cutoff, next); // C11 = P3 = S4 * B22
+
+  strassen_multiply(m2, n2, k2, a11, lda, b11, ldb, x, ldx, cutoff, next); // X = P1 = A11 * B11
+  block_add(m2, n2, x, ldx, c12, ldc, c12, ldc);                     // C12 = U2 = P1 + P6
+  block_add(m2, n2, c12, ldc, c21, ldc, c21, ldc);                   // C21 = U3 = U2 + P7
+  block_add(m2, n2, c12, ldc, c22, ldc, c12, ldc);                   // C12 = U4 = U2 + P5
+  block_add(m2, n2, c21, ldc, c22, ldc, c22, ldc);                   // C22 = U7 = U3 + P5
+  block_add(m2, n2, c12, ldc, c11, ldc, c12, ldc);                   // C12 = U5 = U4 + P3
+
+  block_sub(k2, n2, y, ldy, b21, ldb, y, ldy);                       // Y = T4 = T2 - B21
+  strassen_multiply(m2, n2, k2, a22, lda, y, ldy, c11, ldc, cutoff, next); // C11 = P4 = A22 * T4
+  block_sub(m2, n2, c21, ldc, c11, ldc, c21, ldc);                   // C21 = U6 = U3 - P4
+
+  strassen_multiply(m2, n2, k2, a12, lda, b21, ldb, c11, ldc, cutoff, next); // C11 = P2 = A12 * B21
+  block_add(m2, n2, x, ldx, c11, ldc, c11, ldc);                     // C11 = U1 = P1 + P2
+
+  const std::size_t even_m = 2 * m2, even_n = 2 * n2, even_k = 2 * k2;
+
+  if (even_k != k)
+	gemm_accumulate(even_m, even_n, 1, a + even_k, lda, b + even_k * ldb, ldb, c, ldc);
+
+  if (even_n != n) {
+	block_zero(m, 1, c + even_n, ldc);
+	gemm_accumulate(m, 1, k, a, lda, b + even_n, ldb, c + even_n, ldc);
+  }
+
+  if (even_m != m) {
+	block_zero(1, even_n, c + even_m * ldc, ldc);
+	gemm_accumulate(1, even_n, k, a + even_m * lda, lda, b, ldb, c + even_m * ldc, ldc);
+  }
+}
+
+} // namespace detail end
+
+/**
+ * Multiplies lhs by rhs with Strassen-Winograd recursion down to cutoff,
+ * any shapes are supported. The result differs from lhs * rhs by rounding
+ * for floating types, the error grows with the depth of recursion
+ *
+ * @code
+ *
+ * mtlt::matrix<double> a(4096, 4096), b(4096, 4096);
+ * mtlt::matrix<double> c = mtlt::mul_strassen(a, b); // 2 levels: 4096 -> 2048 -> 1024
+ * mtlt::matrix<double> d = mtlt::mul_strassen(a, b, 512); // 4 levels: 4096 -> ... -> 256
+ *
+ * @endcode
+ */
+template<typename T>
+matrix<T> mul_strassen(const matrix<T> &lhs, const matrix<T> &rhs,
+					   std::size_t cutoff = strassen_default_cutoff) {
+  static_assert(detail::is_gemm_compatible<T, T>::value, "T must be arithmetic type");
+
+  if (lhs.cols() != rhs.rows())
+	throw std::logic_error("Can't multiply two matrices because lhs.cols() != rhs.rows()");
+
+  const std::size_t m = lhs.rows(), n = rhs.cols(), k = lhs.cols();
+  if (cutoff < 2)
+	cutoff = 2;
+
+  std::vector<T> workspace(detail::strassen_workspace_size(m, n, k, cutoff));
+  matrix<T> multiplied(m, n);
+
+  detail::strassen_multiply(m, n, k, lhs.data(), k, rhs.data(), n, multiplied.data(), n,
+							cutoff, workspace.data());
+
+  return multiplied;
+}
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_STRASSEN_H_
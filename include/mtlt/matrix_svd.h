@@ -0,0 +1,279 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        The singular value decomposition: the full one runs one-sided
+ *        Jacobi on the triangular factor of QR, the randomized one finds
+ *        an orthonormal basis of the range of the matrix with a few products
+ *        on the multiplication engine and decomposes the small projection
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_SVD_H_
+#define MTLT_MATRIX_SVD_H_
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <cstddef>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_qr.h>
+#include <mtlt/matrix_config.h>
+
+namespace mtlt {
+
+/**
+ * a == u * diag(s) * vt, singular values s are in descending order,
+ * the columns of u and the rows of vt are orthonormal
+ */
+template<typename T>
+struct svd_result {
+  matrix<T> u;
+  std::vector<T> s;
+  matrix<T> vt;
+};
+
+namespace detail {
+
+template<typename T>
+T row_dot(std::size_t n, const T *x, const T *y) {
+  T sum{};
+  for (std::size_t i = 0; i != n; ++i)
+	sum += x[i] * y[i];
+  return sum;
+}
+
+/**
+ * One-sided Jacobi: plane rotations from the left make the rows of w(n x len)
+ * orthogonal and are accumulated in v(n x n). Rows are contiguous, so every
+ * rotation streams two rows of w and two rows of v
+ */
+template<typename T>
+void jacobi_orthogonalize_rows(std::size_t n, std::size_t len, T *w, T *v) {
+  const T tolerance = std::numeric_limits<T>::epsilon() * std::sqrt(static_cast<T>(len));
+  std::vector<T> norms(n);
+
+  for (std::size_t sweep = 0; sweep != 60; ++sweep) {
+	for (std::size_t i = 0; i != n; ++i)
+	  norms[i] = row_dot(len, w + i * len, w + i * len);
+
+	bool rotated = false;
+	for (std::size_t i = 0; i != n; ++i) {
+	  for (std::size_t j = i + 1; j != n; ++j) {
+		T *w_i = w + i * len, *w_j = w + j * len;
+		const T alpha = norms[i], beta = norms[j];
+		const T gamma = row_dot(len, w_i, w_j);
+
+		if (std::fabs(gamma) <= tolerance * std::sqrt(alpha * beta))
+		  continue;
+
+		// The smaller root of t^2 + 2 * zeta * t - 1 = 0 zeroes w_i * w_j
+		const T zeta = (beta - alpha) / (2 * gamma);
+		const T t = (zeta >= T{} ? T(1) : T(-1)) / (std::fabs(zeta) + std::sqrt(1 + zeta * zeta));
+		const T c = 1 / std::sqrt(1 + t * t), s = c * t;
+
+		for (std::size_t p = 0; p != len; ++p) {
+		  const T x = w_i[p], y = w_j[p];
+		  w_i[p] = c * x - s * y;
+		  w_j[p] = s * x + c * y;
+		}
+
+		T *v_i = v + i * n, *v_j = v + j * n;
+		for (std::size_t p = 0; p != n; ++p) {
+		  const T x = v_i[p], y = v_j[p];
+		  v_i[p] = c * x - s * y;
+		  v_j[p] = s * x + c * y;
+		}
+
+		norms[i] = alpha - t * gamma;
+		norms[j] = beta + t * gamma;
+		rotated = true;
+	  }
+	}
+
+	if (!rotated)
+	  return;
+  }
+}
+
+/**
+ * Thin SVD of a(m x n) with m >= n
+ */
+template<typename T, typename Allocator, typename Layout>
+svd_result<T> svd_tall(const matrix<T, Allocator, Layout> &a) {
+  const std::size_t n = a.cols();
+  qr<T> factorization(a);
+
+  // R = U_r * S * V^T turns into V^T * R^T = S * U_r^T, so the rows
+  // of R^T are orthogonalized and the rotations give V^T
+  matrix<T> w = factorization.r().transpose();
+  matrix<T> vt = matrix<T>::identity(n, n);
+  jacobi_orthogonalize_rows(n, n, w.data(), vt.data());
+
+  std::vector<T> s(n);
+  for (std::size_t i = 0; i != n; ++i)
+	s[i] = std::sqrt(row_dot(n, w.data() + i * n, w.data() + i * n));
+
+  std::vector<std::size_t> order(n);
+  std::iota(order.begin(), order.end(), std::size_t{});
+  std::stable_sort(order.begin(), order.end(), [&s](std::size_t lhs, std::size_t rhs) { return s[lhs] > s[rhs]; });
+
+  svd_result<T> result{matrix<T>(), std::vector<T>(n), matrix<T>(n, n)};
+  matrix<T> ut(n, n);
+
+  // Singular values below the rank cutoff are zero in working precision,
+  // dividing by them would give rows of u that are not orthonormal
+  const T cutoff = T(std::max(a.rows(), n)) * std::numeric_limits<T>::epsilon() * (n != 0 ? s[order[0]] : T{});
+  std::vector<bool> null(n);
+
+  for (std::size_t i = 0; i != n; ++i) {
+	const std::size_t from = order[i];
+	result.s[i] = s[from];
+	null[i] = s[from] <= cutoff;
+	std::copy(vt.data() + from * n, vt.data() + (from + 1) * n, result.vt.data() + i * n);
+
+	if (!null[i])
+	  for (std::size_t p = 0; p != n; ++p)
+		ut(i, p) = w(from, p) / s[from];
+  }
+
+  // Rows of numerically zero singular values are completed to an orthonormal basis
+  for (std::size_t i = 0; i != n; ++i) {
+	if (!null[i])
+	  continue;
+
+	T *row = ut.data() + i * n;
+	for (std::size_t unit = 0; unit != n; ++unit) {
+	  std::fill(row, row + n, T{});
+	  row[unit] = T(1);
+
+	  for (std::size_t j = 0; j != n; ++j) {
+		if (j == i || (null[j] && j > i))
+		  continue;
+		const T projection = row_dot(n, row, ut.data() + j * n);
+		for (std::size_t p = 0; p != n; ++p)
+		  row[p] -= projection * ut(j, p);
+	  }
+
+	  const T norm = std::sqrt(row_dot(n, row, row));
+	  if (norm > T(0.5)) {
+		for (std::size_t p = 0; p != n; ++p)
+		  row[p] /= norm;
+		break;
+	  }
+	}
+  }
+
+  result.u = mul_nt(factorization.thin_q(), ut);
+  return result;
+}
+
+} // namespace detail end
+
+/**
+ * Thin singular value decomposition a == u * diag(s) * vt of a m x n matrix,
+ * u is m x k, vt is k x n, k = min(m, n). One-sided Jacobi gives the small
+ * singular values with high relative accuracy, it costs several O(k^3) sweeps
+ *
+ * @code
+ *
+ * mtlt::matrix<double> a(500, 200);
+ * mtlt::svd_result<double> decomposition = mtlt::svd(a);
+ *
+ * decomposition.s[0]; // The largest singular value, the spectral norm of a
+ * decomposition.u * diag(decomposition.s) * decomposition.vt; // a
+ *
+ * @endcode
+ */
+#if __cplusplus > 201703L
+template<typename T, typename Allocator, typename Layout> requires (std::floating_point<T>)
+svd_result<T> svd(const matrix<T, Allocator, Layout> &a) {
+#else
+template<typename T, typename Allocator, typename Layout>
+svd_result<T> svd(const matrix<T, Allocator, Layout> &a) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  if (a.rows() >= a.cols())
+	return detail::svd_tall(a);
+
+  // a^T = U * S * V^T, so a = V * S * U^T
+  svd_result<T> transposed = detail::svd_tall(a.transpose());
+  return svd_result<T>{transposed.vt.transpose(), std::move(transposed.s), transposed.u.transpose()};
+}
+
+/**
+ * Rank k approximation a ~ u * diag(s) * vt (Halko, Martinsson, Tropp).
+ * The range of a is sampled by a * omega with k + oversample gaussian columns,
+ * power_iters passes through a * a^T sharpen a slowly decaying spectrum.
+ * All the products with a run on the parallel multiplication engine,
+ * the random numbers use a fixed seed, so the result is reproducible
+ *
+ * @code
+ *
+ * mtlt::matrix<float> embeddings(100000, 1000);
+ * mtlt::svd_result<float> low_rank = mtlt::randomized_svd(embeddings, 64);
+ *
+ * low_rank.u; // 100000 x 64
+ * low_rank.vt; // 64 x 1000
+ *
+ * @endcode
+ */
+#if __cplusplus > 201703L
+template<typename T, typename Allocator, typename Layout> requires (std::floating_point<T>)
+svd_result<T> randomized_svd(const matrix<T, Allocator, Layout> &a, std::size_t k,
+							 std::size_t oversample = 10, std::size_t power_iters = 2) {
+#else
+template<typename T, typename Allocator, typename Layout>
+svd_result<T> randomized_svd(const matrix<T, Allocator, Layout> &a, std::size_t k,
+							 std::size_t oversample = 10, std::size_t power_iters = 2) {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point type");
+#endif
+  const std::size_t m = a.rows(), n = a.cols();
+  if (k == 0 || k > std::min(m, n))
+	throw std::logic_error("Can't compute randomized SVD because k is not in [1, min(rows, cols)]");
+
+  const std::size_t samples = std::min(k + oversample, std::min(m, n));
+
+  std::mt19937 engine(5489u);
+  std::normal_distribution<T> distribution;
+  matrix<T> omega(n, samples);
+  omega.generate([&]() { return distribution(engine); });
+
+  matrix<T> q = qr<T>(a * omega).thin_q();
+  for (std::size_t iteration = 0; iteration != power_iters; ++iteration) {
+	q = qr<T>(mul_tn(a, q)).thin_q();
+	q = qr<T>(a * q).thin_q();
+  }
+
+  // a ~ q * q^T * a, the small samples x n projection is decomposed exactly
+  svd_result<T> small = svd(mul_tn(q, a));
+
+  svd_result<T> result{q * small.u, std::move(small.s), std::move(small.vt)};
+  result.u.resize(m, k);
+  result.s.resize(k);
+  result.vt.resize(k, n);
+  return result;
+}
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_SVD_H_
@@ -0,0 +1,722 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        The matrix_view class refers to a row major block of items owned
+ *        by someone else: a matrix, a static_matrix or an external buffer.
+ *        Rows are leading_dimension() items apart, so submatrices, rows and
+ *        columns are views too and are passed to the kernels without copies
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_MATRIX_VIEW_H_
+#define MTLT_MATRIX_VIEW_H_
+
+#include <vector>
+#include <cstddef>
+#include <iomanip>
+#include <utility>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_gemm.h>
+#include <mtlt/static_matrix.h>
+#include <mtlt/matrix_config.h>
+
+namespace mtlt {
+
+/**
+ * @class matrix_view_iterator
+ *
+ * Random access iterator over the items of a strided block in row major order,
+ * the gap of leading_dimension() - cols() items after each row is skipped
+ */
+template<typename Pointer>
+class matrix_view_iterator {
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename std::remove_cv<typename std::pointer_traits<Pointer>::element_type>::type;
+  using pointer = Pointer;
+  using reference = typename std::pointer_traits<Pointer>::element_type &;
+  using difference_type = std::ptrdiff_t;
+
+public:
+  MATRIX_CXX17_CONSTEXPR matrix_view_iterator() noexcept = default;
+
+  MATRIX_CXX17_CONSTEXPR matrix_view_iterator(Pointer base, std::size_t cols, std::size_t ld,
+											  difference_type index) noexcept
+	  : base_(base), cols_(cols), ld_(ld) {
+	seek(index);
+  }
+
+  template<typename Other, typename std::enable_if<std::is_convertible<Other, Pointer>::value, bool>::type = true>
+  MATRIX_CXX17_CONSTEXPR matrix_view_iterator(const matrix_view_iterator<Other> &other) noexcept
+	  : matrix_view_iterator(other.base(), other.cols(), other.leading_dimension(), other.index()) {}
+
+public:
+  MATRIX_CXX17_CONSTEXPR reference operator*() const noexcept { return base_[offset_ + col_]; }
+
+  MATRIX_CXX17_CONSTEXPR pointer operator->() const noexcept { return base_ + offset_ + col_; }
+
+  MATRIX_CXX17_CONSTEXPR reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+  MATRIX_CXX17_CONSTEXPR matrix_view_iterator &operator++() noexcept {
+	++index_;
+	if (++col_ == cols_) {
+	  col_ = 0;
+	  offset_ += ld_;
+	}
+	return *this;
+  }
+
+  MATRIX_CXX17_CONSTEXPR matrix_view_iterator operator++(int) noexcept {
+	matrix_view_iterator tmp(*this);
+	++*this;
+	return tmp;
+  }
+
+  MATRIX_CXX17_CONSTEXPR matrix_view_iterator &operator--() noexcept {
+	--index_;
+	if (col_ == 0) {
+	  col_ = cols_;
+	  offset_ -= ld_;
+	}
+	--col_;
+	return *this;
+  }
+
+  MATRIX_CXX17_CONSTEXPR matrix_view_iterator operator--(int) noexcept {
+	matrix_view_iterator tmp(*this);
+	--*this;
+	return tmp;
+  }
+
+  MATRIX_CXX17_CONSTEXPR matrix_view_iterator &operator+=(difference_type n) noexcept {
+	seek(index_ + n);
+	return *this;
+  }
+
+  MATRIX_CXX17_CONSTEXPR matrix_view_iterator &operator-=(difference_type n) noexcept {
+	seek(index_ - n);
+	return *this;
+  }
+
+  MATRIX_CXX17_CONSTEXPR matrix_view_iterator operator+(difference_type n) const noexcept {
+	matrix_view_iterator tmp(*this);
+	return tmp += n;
+  }
+
+  MATRIX_CXX17_CONSTEXPR matrix_view_iterator operator-(difference_type n) const noexcept {
+	matrix_view_iterator tmp(*this);
+	return tmp -= n;
+  }
+
+  MATRIX_CXX17_CONSTEXPR difference_type operator-(const matrix_view_iterator &rhs) const noexcept {
+	return index_ - rhs.index_;
+  }
+
+  MATRIX_CXX17_CONSTEXPR Pointer base() const noexcept { return base_; }
+  MATRIX_CXX17_CONSTEXPR std::size_t cols() const noexcept { return cols_; }
+  MATRIX_CXX17_CONSTEXPR std::size_t leading_dimension() const noexcept { return ld_; }
+  MATRIX_CXX17_CONSTEXPR difference_type index() const noexcept { return index_; }
+
+private:
+  MATRIX_CXX17_CONSTEXPR void seek(difference_type index) noexcept {
+	index_ = index;
+	if (cols_ == 0)
+	  return;
+
+	offset_ = static_cast<std::size_t>(index) / cols_ * ld_;
+	col_ = static_cast<std::size_t>(index) % cols_;
+  }
+
+private:
+  Pointer base_ = nullptr;
+  std::size_t cols_ = 0, ld_ = 0;
+  std::size_t offset_ = 0, col_ = 0;
+  difference_type index_ = 0;
+};
+
+template<typename Lhs, typename Rhs>
+MATRIX_CXX17_NODISCARD MATRIX_CXX17_CONSTEXPR
+bool operator==(const matrix_view_iterator<Lhs> &lhs, const matrix_view_iterator<Rhs> &rhs) {
+  return lhs.index() == rhs.index();
+}
+
+template<typename Lhs, typename Rhs>
+MATRIX_CXX17_NODISCARD MATRIX_CXX17_CONSTEXPR
+bool operator!=(const matrix_view_iterator<Lhs> &lhs, const matrix_view_iterator<Rhs> &rhs) {
+  return lhs.index() != rhs.index();
+}
+
+template<typename Lhs, typename Rhs>
+MATRIX_CXX17_NODISCARD MATRIX_CXX17_CONSTEXPR
+bool operator<(const matrix_view_iterator<Lhs> &lhs, const matrix_view_iterator<Rhs> &rhs) {
+  return lhs.index() < rhs.index();
+}
+
+template<typename Lhs, typename Rhs>
+MATRIX_CXX17_NODISCARD MATRIX_CXX17_CONSTEXPR
+bool operator>(const matrix_view_iterator<Lhs> &lhs, const matrix_view_iterator<Rhs> &rhs) {
+  return lhs.index() > rhs.index();
+}
+
+template<typename Lhs, typename Rhs>
+MATRIX_CXX17_NODISCARD MATRIX_CXX17_CONSTEXPR
+bool operator<=(const matrix_view_iterator<Lhs> &lhs, const matrix_view_iterator<Rhs> &rhs) {
+  return lhs.index() <= rhs.index();
+}
+
+template<typename Lhs, typename Rhs>
+MATRIX_CXX17_NODISCARD MATRIX_CXX17_CONSTEXPR
+bool operator>=(const matrix_view_iterator<Lhs> &lhs, const matrix_view_iterator<Rhs> &rhs) {
+  return lhs.index() >= rhs.index();
+}
+
+template<typename Pointer>
+MATRIX_CXX17_CONSTEXPR
+matrix_view_iterator<Pointer> operator+(std::ptrdiff_t n, const matrix_view_iterator<Pointer> &it) {
+  return it + n;
+}
+
+/**
+ * @class matrix_view
+ *
+ * Non owning reference to rows x cols items, the row r starts at
+ * data() + r * leading_dimension(). matrix_view<const T> is read only.
+ * The view is as cheap to copy as a pointer, the owner must outlive it
+ *
+ * @code
+ *
+ * mtlt::matrix<double> m(1000, 1000);
+ * mtlt::matrix_view<double> block = mtlt::make_view(m).submatrix(100, 200, 64, 64); // No copy
+ * block.fill(0.0); // Writes into m
+ *
+ * mtlt::matrix_view<const double> row = mtlt::make_view(m).row(5); // 1 x 1000
+ * mtlt::matrix<double> product = block * mtlt::make_view(m).submatrix(0, 0, 64, 10); // Strided gemm
+ *
+ * float external[4 * 8]; // 4 x 6 items with padded rows
+ * mtlt::matrix_view<float> padded(external, 4, 6, 8);
+ *
+ * @endcode
+ */
+template<typename T>
+class matrix_view {
+public:
+  using element_type = T;
+  using value_type = typename std::remove_cv<T>::type;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using iterator = matrix_view_iterator<pointer>;
+  using const_iterator = matrix_view_iterator<const_pointer>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+public:
+  MATRIX_CXX17_CONSTEXPR matrix_view() noexcept = default;
+
+  MATRIX_CXX17_CONSTEXPR matrix_view(pointer data, size_type rows, size_type cols) noexcept
+	  : data_(data), rows_(rows), cols_(cols), ld_(cols) {}
+
+  MATRIX_CXX17_CONSTEXPR matrix_view(pointer data, size_type rows, size_type cols, size_type leading_dimension)
+	  : data_(data), rows_(rows), cols_(cols), ld_(leading_dimension) {
+	if (ld_ < cols_)
+	  throw std::logic_error("Can't create matrix view because leading dimension is less than cols");
+  }
+
+  template<typename Allocator>
+  matrix_view(matrix<value_type, Allocator> &m) noexcept
+	  : matrix_view(m.data(), m.rows(), m.cols()) {}
+
+  template<typename Allocator, typename U = T,
+	  typename std::enable_if<std::is_const<U>::value, bool>::type = true>
+  matrix_view(const matrix<value_type, Allocator> &m) noexcept
+	  : matrix_view(m.data(), m.rows(), m.cols()) {}
+
+  template<std::size_t Rows, std::size_t Cols>
+  MATRIX_CXX17_CONSTEXPR matrix_view(static_matrix<value_type, Rows, Cols> &m) noexcept
+	  : matrix_view(m.data(), Rows, Cols) {}
+
+  template<std::size_t Rows, std::size_t Cols, typename U = T,
+	  typename std::enable_if<std::is_const<U>::value, bool>::type = true>
+  MATRIX_CXX17_CONSTEXPR matrix_view(const static_matrix<value_type, Rows, Cols> &m) noexcept
+	  : matrix_view(m.data(), Rows, Cols) {}
+
+  template<typename U = T, typename std::enable_if<std::is_const<U>::value, bool>::type = true>
+  MATRIX_CXX17_CONSTEXPR matrix_view(const matrix_view<value_type> &other) noexcept
+	  : data_(other.data()), rows_(other.rows()), cols_(other.cols()), ld_(other.leading_dimension()) {}
+
+public:
+  MATRIX_CXX17_CONSTEXPR iterator begin() const noexcept { return iterator(data_, cols_, ld_, 0); }
+
+  MATRIX_CXX17_CONSTEXPR iterator end() const noexcept {
+	return iterator(data_, cols_, ld_, static_cast<difference_type>(size()));
+  }
+
+  MATRIX_CXX17_CONSTEXPR const_iterator cbegin() const noexcept { return begin(); }
+
+  MATRIX_CXX17_CONSTEXPR const_iterator cend() const noexcept { return end(); }
+
+  MATRIX_CXX17_CONSTEXPR reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+
+  MATRIX_CXX17_CONSTEXPR reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+  MATRIX_CXX17_CONSTEXPR const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+
+  MATRIX_CXX17_CONSTEXPR const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+public:
+  MATRIX_CXX17_CONSTEXPR reference operator()(size_type row, size_type col) const noexcept {
+	return data_[row * ld_ + col];
+  }
+
+  reference at(size_type row, size_type col) const {
+	if (row >= rows_ || col >= cols_)
+	  throw std::out_of_range("row or col is out of range of matrix view");
+
+	return (*this)(row, col);
+  }
+
+  MATRIX_CXX17_NODISCARD MATRIX_CXX17_CONSTEXPR
+  size_type rows() const noexcept { return rows_; }
+
+  MATRIX_CXX17_NODISCARD MATRIX_CXX17_CONSTEXPR
+  size_type cols() const noexcept { return cols_; }
+
+  MATRIX_CXX17_NODISCARD MATRIX_CXX17_CONSTEXPR
+  size_type size() const noexcept { return rows_ * cols_; }
+
+  MATRIX_CXX17_NODISCARD MATRIX_CXX17_CONSTEXPR
+  size_type leading_dimension() const noexcept { return ld_; }
+
+  MATRIX_CXX17_NODISCARD MATRIX_CXX17_CONSTEXPR
+  bool is_contiguous() const noexcept { return ld_ == cols_ || rows_ <= 1; }
+
+  MATRIX_CXX17_CONSTEXPR pointer data() const noexcept { return data_; }
+
+public:
+  /**
+   * The rows x cols block whose first item is (row, col)
+   */
+  matrix_view submatrix(size_type row, size_type col, size_type rows, size_type cols) const {
+	if (row + rows > rows_ || col + cols > cols_)
+	  throw std::out_of_range("Can't create submatrix because it is out of range of matrix view");
+
+	return matrix_view(data_ + row * ld_ + col, rows, cols, ld_);
+  }
+
+  matrix_view row(size_type row) const {
+	return submatrix(row, 0, 1, cols_);
+  }
+
+  matrix_view col(size_type col) const {
+	return submatrix(0, col, rows_, 1);
+  }
+
+public:
+  template<typename UnaryOperation>
+  const matrix_view &transform(UnaryOperation &&op) const {
+	for (size_type row = 0; row != rows_; ++row) {
+	  pointer items = data_ + row * ld_;
+	  std::transform(items, items + cols_, items, op);
+	}
+	return *this;
+  }
+
+  template<typename U, typename BinaryOperation>
+  const matrix_view &transform(const matrix_view<U> &other, BinaryOperation &&op) const {
+	for (size_type row = 0; row != rows_; ++row) {
+	  pointer items = data_ + row * ld_;
+	  std::transform(items, items + cols_, other.data() + row * other.leading_dimension(), items, op);
+	}
+	return *this;
+  }
+
+  template<typename Operation>
+  const matrix_view &generate(Operation &&op) const {
+	for (size_type row = 0; row != rows_; ++row)
+	  for (size_type col = 0; col != cols_; ++col)
+		(*this)(row, col) = op();
+	return *this;
+  }
+
+  const matrix_view &fill(const value_type &number) const {
+	for (size_type row = 0; row != rows_; ++row)
+	  std::fill(data_ + row * ld_, data_ + row * ld_ + cols_, number);
+	return *this;
+  }
+
+  /**
+   * Copies the items of other into the viewed storage, the shapes must be equal
+   */
+  template<typename U>
+  const matrix_view &assign(const matrix_view<U> &other) const {
+	if (rows_ != other.rows() || cols_ != other.cols())
+	  throw std::logic_error("Can't assign matrix view because rows != other.rows() or cols != other.cols()");
+
+	for (size_type row = 0; row != rows_; ++row) {
+	  const U *items = other.data() + row * other.leading_dimension();
+	  std::copy(items, items + cols_, data_ + row * ld_);
+	}
+	return *this;
+  }
+
+  const matrix_view &add(const value_type &number) const {
+	return transform([&number](const value_type &item) { return item + number; });
+  }
+
+  const matrix_view &sub(const value_type &number) const {
+	return transform([&number](const value_type &item) { return item - number; });
+  }
+
+  const matrix_view &mul(const value_type &number) const {
+	return transform([&number](const value_type &item) { return item * number; });
+  }
+
+  const matrix_view &div(const value_type &number) const {
+	if (std::is_integral<value_type>::value && number == 0)
+	  throw std::logic_error("Dividing by zero");
+
+	return transform([&number](const value_type &item) { return item / number; });
+  }
+
+  template<typename U>
+  const matrix_view &add(const matrix_view<U> &rhs) const {
+	if (rhs.rows() != rows_ || rhs.cols() != cols_)
+	  throw std::logic_error("Can't add different sized matrices");
+
+	return transform(rhs, [](const value_type &lhs, const U &rhs) { return lhs + rhs; });
+  }
+
+  template<typename U>
+  const matrix_view &sub(const matrix_view<U> &rhs) const {
+	if (rhs.rows() != rows_ || rhs.cols() != cols_)
+	  throw std::logic_error("Can't sub different sized matrices");
+
+	return transform(rhs, [](const value_type &lhs, const U &rhs) { return lhs - rhs; });
+  }
+
+  template<typename U>
+  const matrix_view &mul_by_element(const matrix_view<U> &rhs) const {
+	if (rows_ != rhs.rows() || cols_ != rhs.cols())
+	  throw std::logic_error("Can't multiply by element two matrices because rows != rhs.rows() or cols != rhs.cols()");
+
+	return transform(rhs, [](const value_type &lhs, const U &rhs) { return lhs * rhs; });
+  }
+
+  void swap_rows(size_type row1, size_type row2) const {
+	if (row1 >= rows_ || row2 >= rows_)
+	  throw std::logic_error("row1 or row2 is bigger that this->rows()");
+
+	std::swap_ranges(data_ + row1 * ld_, data_ + row1 * ld_ + cols_, data_ + row2 * ld_);
+  }
+
+  void swap_cols(size_type col1, size_type col2) const {
+	if (col1 >= cols_ || col2 >= cols_)
+	  throw std::logic_error("col1 or col2 is bigger that this->cols()");
+
+	for (size_type row = 0; row != rows_; ++row)
+	  std::swap((*this)(row, col1), (*this)(row, col2));
+  }
+
+public:
+  value_type sum() const {
+	value_type sum{};
+	for (size_type row = 0; row != rows_; ++row)
+	  for (size_type col = 0; col != cols_; ++col)
+		sum += (*this)(row, col);
+	return sum;
+  }
+
+  value_type trace() const {
+	if (rows_ != cols_)
+	  throw std::logic_error("Trace can be found only for square matrices");
+
+	value_type tr{};
+	for (size_type i = 0; i != rows_; ++i)
+	  tr += (*this)(i, i);
+	return tr;
+  }
+
+  template<typename EqualCompare = std::equal_to<value_type>>
+  bool equal_to(const matrix_view<const value_type> &rhs) const {
+	if (rows_ != rhs.rows() || cols_ != rhs.cols())
+	  return false;
+
+	EqualCompare compare;
+	for (size_type row = 0; row != rows_; ++row)
+	  for (size_type col = 0; col != cols_; ++col)
+		if (!compare((*this)(row, col), rhs(row, col)))
+		  return false;
+
+	return true;
+  }
+
+  /**
+   * Owning copy of the viewed items
+   */
+  matrix<value_type> to_matrix() const {
+	matrix<value_type> copy(rows_, cols_, uninitialized);
+	matrix_view<value_type>(copy).assign(*this);
+	return copy;
+  }
+
+  matrix<value_type> transpose() const {
+	matrix<value_type> transposed(cols_, rows_, uninitialized);
+	for (size_type row = 0; row != rows_; ++row)
+	  for (size_type col = 0; col != cols_; ++col)
+		transposed(col, row) = (*this)(row, col);
+	return transposed;
+  }
+
+  void print(std::ostream &os = std::cout, matrix_debug_settings s = matrix_debug_settings{}) const {
+	for (size_type row = 0; row != rows_; ++row) {
+	  for (size_type col = 0; col != cols_; ++col)
+		os << std::setw(s.width) << std::setprecision(s.precision) << (*this)(row, col) << s.separator;
+	  os << s.end;
+	}
+
+	if (s.is_double_end)
+	  os << s.end;
+  }
+
+private:
+  pointer data_ = nullptr;
+  size_type rows_ = 0, cols_ = 0, ld_ = 0;
+};
+
+/**
+ * View of the whole storage with the item type deduced
+ */
+template<typename T, typename Allocator>
+matrix_view<T> make_view(matrix<T, Allocator> &m) noexcept {
+  return matrix_view<T>(m);
+}
+
+template<typename T, typename Allocator>
+matrix_view<const T> make_view(const matrix<T, Allocator> &m) noexcept {
+  return matrix_view<const T>(m);
+}
+
+template<typename T, std::size_t Rows, std::size_t Cols>
+MATRIX_CXX17_CONSTEXPR matrix_view<T> make_view(static_matrix<T, Rows, Cols> &m) noexcept {
+  return matrix_view<T>(m);
+}
+
+template<typename T, std::size_t Rows, std::size_t Cols>
+MATRIX_CXX17_CONSTEXPR matrix_view<const T> make_view(const static_matrix<T, Rows, Cols> &m) noexcept {
+  return matrix_view<const T>(m);
+}
+
+namespace detail {
+
+template<typename T>
+void gemm(const T &alpha, matrix_view<const T> a, matrix_view<const T> b, matrix_view<T> c, std::true_type) {
+  gemm_accumulate(c.rows(), c.cols(), a.cols(),
+				  make_gemm_operand(a.data(), a.leading_dimension()),
+				  make_gemm_operand(b.data(), b.leading_dimension()),
+				  c.data(), c.leading_dimension(), alpha);
+}
+
+template<typename T>
+void gemm(const T &alpha, matrix_view<const T> a, matrix_view<const T> b, matrix_view<T> c, std::false_type) {
+  for (std::size_t row = 0; row != c.rows(); ++row)
+	for (std::size_t col = 0; col != c.cols(); ++col) {
+	  T sum{};
+	  for (std::size_t k = 0; k != a.cols(); ++k)
+		sum += a(row, k) * b(k, col);
+	  c(row, col) += alpha * sum;
+	}
+}
+
+template<typename T>
+void gemv(const T &alpha, matrix_view<const T> a, const T *x, T *y, std::true_type) {
+  gemv_accumulate(a.rows(), a.cols(), a.data(), a.leading_dimension(), x, y, alpha);
+}
+
+template<typename T>
+void gemv(const T &alpha, matrix_view<const T> a, const T *x, T *y, std::false_type) {
+  for (std::size_t row = 0; row != a.rows(); ++row) {
+	T sum{};
+	for (std::size_t col = 0; col != a.cols(); ++col)
+	  sum += a(row, col) * x[col];
+	y[row] += alpha * sum;
+  }
+}
+
+inline bool intervals_overlap(std::size_t lhs_first, std::size_t lhs_count, std::size_t rhs_first, std::size_t rhs_count) {
+  return lhs_count != 0 && rhs_count != 0 && lhs_first < rhs_first + rhs_count && rhs_first < lhs_first + lhs_count;
+}
+
+/**
+ * Reports whether two views touch a common item. Views that share the
+ * leading dimension are compared as row x col rectangles of one strided
+ * buffer, so disjoint blocks of the same matrix do not overlap
+ */
+template<typename T>
+bool views_overlap(matrix_view<const T> lhs, matrix_view<const T> rhs) {
+  if (lhs.size() == 0 || rhs.size() == 0)
+	return false;
+
+  const std::less<const T *> less;
+  const T *lhs_last = &lhs(lhs.rows() - 1, lhs.cols() - 1), *rhs_last = &rhs(rhs.rows() - 1, rhs.cols() - 1);
+  if (less(lhs_last, rhs.data()) || less(rhs_last, lhs.data()))
+	return false;
+
+  const std::size_t ld = lhs.leading_dimension();
+  if (ld == 0 || ld != rhs.leading_dimension())
+	return true;
+
+  // The address ranges intersect, so both views live in the same buffer
+  if (less(rhs.data(), lhs.data()))
+	std::swap(lhs, rhs);
+
+  const std::size_t offset = static_cast<std::size_t>(rhs.data() - lhs.data());
+  const std::size_t row = offset / ld, col = offset % ld;
+
+  // A block may start near the end of a row and wrap into the following one
+  const std::size_t head = std::min(rhs.cols(), ld - col), tail = rhs.cols() - head;
+  return (intervals_overlap(0, lhs.rows(), row, rhs.rows()) && intervals_overlap(0, lhs.cols(), col, head)) ||
+	  (intervals_overlap(0, lhs.rows(), row + 1, rhs.rows()) && intervals_overlap(0, lhs.cols(), 0, tail));
+}
+
+} // namespace detail end
+
+/**
+ * Computes c = alpha * a * b + beta * c for strided blocks, the products
+ * of tiles run on the multiplication engine in place of the owners
+ *
+ * @code
+ *
+ * mtlt::matrix<double> a(512, 512), b(512, 512), c(512, 512);
+ * mtlt::matrix_view<double> va(a), vb(b), vc(c);
+ *
+ * // The top left quarter of c += the top half of a * the left half of b
+ * mtlt::gemm(1.0, va.submatrix(0, 0, 256, 512), vb.submatrix(0, 0, 512, 256), 1.0, vc.submatrix(0, 0, 256, 256));
+ *
+ * @endcode
+ */
+template<typename T, typename A, typename B>
+void gemm(const T &alpha, const matrix_view<A> &a, const matrix_view<B> &b, const T &beta, const matrix_view<T> &c) {
+  static_assert(std::is_same<typename std::remove_cv<A>::type, T>::value &&
+				std::is_same<typename std::remove_cv<B>::type, T>::value, "a, b and c must have the same items");
+
+  if (a.cols() != b.rows())
+	throw std::logic_error("Can't multiply two matrices because a.cols() != b.rows()");
+
+  if (c.rows() != a.rows() || c.cols() != b.cols())
+	throw std::logic_error("Can't accumulate product because c is not a.rows() x b.cols()");
+
+  if (detail::views_overlap<T>(c, a) || detail::views_overlap<T>(c, b))
+	throw std::logic_error("Can't accumulate product into storage of one of its operands");
+
+  if (beta == T{})
+	c.fill(T{});
+  else if (beta != T(1))
+	c.mul(beta);
+
+  detail::gemm<T>(alpha, a, b, c, detail::is_gemm_compatible<T, T>());
+}
+
+/**
+ * Computes y = alpha * a * x + beta * y for a strided block a
+ */
+template<typename T, typename A>
+void gemv(const T &alpha, const matrix_view<A> &a, const T *x, const T &beta, T *y) {
+  static_assert(std::is_same<typename std::remove_cv<A>::type, T>::value, "a, x and y must have the same items");
+
+  const std::size_t rows = a.rows();
+
+  if (beta == T{})
+	std::fill(y, y + rows, T{});
+  else if (beta != T(1))
+	std::transform(y, y + rows, y, [&beta](const T &item) { return item * beta; });
+
+  detail::gemv<T>(alpha, a, x, y, detail::is_gemm_compatible<T, T>());
+}
+
+template<typename T>
+std::ostream &operator<<(std::ostream &out, const matrix_view<T> &rhs) {
+  rhs.print(out);
+  return out;
+}
+
+template<typename T, typename U>
+matrix<typename std::remove_cv<T>::type> operator+(const matrix_view<T> &lhs, const matrix_view<U> &rhs) {
+  matrix<typename std::remove_cv<T>::type> result = lhs.to_matrix();
+  make_view(result).add(rhs);
+  return result;
+}
+
+template<typename T, typename U>
+matrix<typename std::remove_cv<T>::type> operator-(const matrix_view<T> &lhs, const matrix_view<U> &rhs) {
+  matrix<typename std::remove_cv<T>::type> result = lhs.to_matrix();
+  make_view(result).sub(rhs);
+  return result;
+}
+
+template<typename T, typename U>
+matrix<typename std::remove_cv<T>::type> operator*(const matrix_view<T> &lhs, const matrix_view<U> &rhs) {
+  using value_type = typename std::remove_cv<T>::type;
+
+  matrix<value_type> result(lhs.rows(), rhs.cols());
+  gemm(value_type(1), lhs, rhs, value_type{}, make_view(result));
+  return result;
+}
+
+template<typename T>
+matrix<typename std::remove_cv<T>::type> operator*(const matrix_view<T> &lhs,
+												   const typename std::remove_cv<T>::type &rhs) {
+  matrix<typename std::remove_cv<T>::type> result = lhs.to_matrix();
+  result.mul(rhs);
+  return result;
+}
+
+template<typename T>
+std::vector<typename std::remove_cv<T>::type> operator*(const matrix_view<T> &lhs,
+														const std::vector<typename std::remove_cv<T>::type> &rhs) {
+  if (lhs.cols() != rhs.size())
+	throw std::logic_error("Can't multiply matrix by vector because lhs.cols() != rhs.size()");
+
+  using value_type = typename std::remove_cv<T>::type;
+
+  std::vector<value_type> multiplied(lhs.rows());
+  gemv(value_type(1), lhs, rhs.data(), value_type{}, multiplied.data());
+  return multiplied;
+}
+
+template<typename T, typename U>
+bool operator==(const matrix_view<T> &lhs, const matrix_view<U> &rhs) {
+  return lhs.equal_to(rhs);
+}
+
+template<typename T, typename U>
+bool operator!=(const matrix_view<T> &lhs, const matrix_view<U> &rhs) {
+  return !(lhs == rhs);
+}
+
+} // namespace mtlt end
+
+#endif // MTLT_MATRIX_VIEW_H_
@@ -29,6 +29,7 @@
 #include <random>
 #include <chrono>
 #include <iomanip>
+#include <limits>
 #include <numeric>
 #include <iostream>
 #include <algorithm>
@@ -38,8 +39,10 @@
 #include <concepts>
 #endif
 
+#include <mtlt/matrix_gemm.h>
 #include <mtlt/matrix_config.h>
 #include <mtlt/matrix_type_traits.h>
+#include <mtlt/matrix_decomposition.h>
 #include <mtlt/matrix_normal_iterator.h>
 #include <mtlt/matrix_reverse_iterator.h>
 
@@ -259,6 +262,12 @@ public:
   MATRIX_CXX17_CONSTEXPR
   size_type size() const noexcept { return rows_ * cols_; }
 
+  MATRIX_CXX17_CONSTEXPR
+  pointer data() noexcept { return data_; }
+
+  MATRIX_CXX17_CONSTEXPR
+  const_pointer data() const noexcept { return data_; }
+
 public:
   void print(std::ostream &os = std::cout, matrix_debug_settings s = matrix_debug_settings{}) const {
 	int width = s.width, precision = s.precision;
@@ -420,9 +429,14 @@ public:
 #endif // C++ <= 201703L
 	static_matrix<T, Rows, Cols2> multiplied;
 
+	if (!MATRIX_IS_CONSTANT_EVALUATED() && Rows * Cols2 * Cols > detail::gemm_naive_threshold) {
+	  multiply(rhs, multiplied, detail::is_gemm_compatible<T, U>());
+	  return multiplied;
+	}
+
 	for (size_type row = 0; row != Rows; ++row)
-	  for (size_type col = 0; col != Cols2; ++col)
-		for (size_type k = 0; k != Cols; ++k)
+	  for (size_type k = 0; k != Cols; ++k)
+		for (size_type col = 0; col != Cols2; ++col)
 		  multiplied(row, col) += (*this)(row, k) * rhs(k, col);
 
 	return multiplied;
@@ -686,36 +700,42 @@ public:
 	return determinant_value;
   }
 
+  /**
+   * Cofactor expansion along the first row, O(n!) without allocations,
+   * an explicit opt-in for tiny matrices only
+   */
 #if __cplusplus > 201703L
-  MATRIX_CXX17_CONSTEXPR double determinant_laplacian() const requires(Rows == Cols) {
+  MATRIX_CXX17_CONSTEXPR double determinant_laplacian() const requires(Rows == Cols && Rows <= detail::cofactor_max_size) {
 #else
   MATRIX_CXX17_CONSTEXPR
   double determinant_laplacian() const {
 	static_assert(Rows == Cols, "Matrix must be square");
+	static_assert(Rows <= detail::cofactor_max_size, "determinant_laplacian is O(n!), use determinant_bareiss");
 #endif // C++ <= 201703L
-	double determinant_value{};
-	int sign = 1;
+	size_type columns[detail::cofactor_max_size] = {};
+	for (size_type col = 0; col != Cols; ++col)
+	  columns[col] = col;
+
+	return detail::cofactor_determinant(*this, 0, columns, Cols);
+  }
 
+  /**
+   * Exact determinant of an integral matrix by fraction-free Bareiss
+   * elimination in O(n^3), the products are taken in a twice wider integer
+   */
 #if __cplusplus > 201703L
-	if MATRIX_CXX17_CONSTEXPR (Rows == 1 && Cols == 1)
-	  determinant_value = (*this)(0, 0);
-	else if MATRIX_CXX17_CONSTEXPR (Rows == 2 && Cols == 2)
-	  determinant_value = ((*this)(0, 0) * (*this)(1, 1)) - ((*this)(1, 0) * (*this)(0, 1));
+  MATRIX_CXX17_CONSTEXPR value_type determinant_bareiss() const requires(Rows == Cols && std::integral<T>) {
 #else
-	if (Rows == 1 && Cols == 1)
-	  determinant_value = (*this)(0, 0);
-	else if (Rows == 2 && Cols == 2)
-	  determinant_value = ((*this)(0, 0) * (*this)(1, 1)) - ((*this)(1, 0) * (*this)(0, 1));
+  MATRIX_CXX17_CONSTEXPR
+  value_type determinant_bareiss() const {
+	static_assert(Rows == Cols, "Matrix must be square");
+	static_assert(std::is_integral<T>::value, "T must be integral type");
 #endif // C++ <= 201703L
-	else {
-	  for (size_type col = 0; col != Cols; ++col) {
-		static_matrix<value_type, Rows - 1, Cols - 1> minored = this->minor(0, col);
-		determinant_value += sign * (*this)(0, col) * minored.determinant_laplacian();
-		sign = -sign;
-	  }
-	}
+	std::array<typename detail::bareiss_type<T>::type, Rows * Cols> factors{};
+	for (size_type i = 0; i != Rows * Cols; ++i)
+	  factors[i] = data_[i];
 
-	return determinant_value;
+	return static_cast<value_type>(detail::bareiss_determinant(Rows, factors.data()));
   }
 
 #if __cplusplus > 201703L
@@ -737,6 +757,10 @@ public:
 	return complements;
   }
 
+  /**
+   * Throws if a pivot of the LU factorization is negligible next to the
+   * largest item of U, the same as mtlt::matrix::inverse()
+   */
 #if __cplusplus > 201703L
   MATRIX_CXX17_CONSTEXPR static_matrix inverse() const requires(Rows == Cols) {
 #else
@@ -744,16 +768,19 @@ public:
   static_matrix inverse() const {
 	static_assert(Rows == Cols, "Matrix must be square");
 #endif // C++ <= 201703L
-	double determinant = determinant_gaussian();
+	static_matrix<double, Rows, Cols> factors = convert_to<double>();
+	size_type pivots[Rows]{};
+	lu_factor(factors, pivots);
 
-	double tmp = determinant < 0 ? -determinant : determinant;
-	if (tmp <= 1e-6)
-	  return zero();
+	if (negligible_pivot(factors))
+	  throw std::logic_error("Can't found inverse matrix because determinant is zero");
 
-	return calc_complements().transpose().
-		mul_by_element(static_matrix<T, Rows, Cols>(1 / determinant));
+	return lu_inverse(factors, pivots);
   }
 
+  /**
+   * The caller's determinant is compared with the absolute threshold 1e-6
+   */
 #if __cplusplus > 201703L
   MATRIX_CXX17_CONSTEXPR static_matrix inverse(double determinant) const requires(Rows == Cols) {
 #else
@@ -763,10 +790,13 @@ public:
 #endif // C++ <= 201703L
 	double tmp = determinant < 0 ? -determinant : determinant;
 	if (tmp <= 1e-6)
-	  return zero();
+	  throw std::logic_error("Can't found inverse matrix because determinant is zero");
 
-	return calc_complements().transpose().
-		mul_by_element(static_matrix<T, Rows, Cols>(1 / determinant));
+	static_matrix<double, Rows, Cols> factors = convert_to<double>();
+	size_type pivots[Rows]{};
+	lu_factor(factors, pivots);
+
+	return lu_inverse(factors, pivots);
   }
 
 #if __cplusplus > 201703L
@@ -834,6 +864,115 @@ public:
 	return true;
   }
 
+private:
+  template<typename U, size_type Cols2>
+  void multiply(const static_matrix<U, Cols, Cols2> &rhs, static_matrix<T, Rows, Cols2> &multiplied,
+				std::true_type) const {
+	detail::gemm_accumulate(Rows, Cols2, Cols, data_, Cols, rhs.data(), Cols2, multiplied.data(), Cols2);
+  }
+
+  template<typename U, size_type Cols2>
+  void multiply(const static_matrix<U, Cols, Cols2> &rhs, static_matrix<T, Rows, Cols2> &multiplied,
+				std::false_type) const {
+	for (size_type row = 0; row != Rows; ++row)
+	  for (size_type k = 0; k != Cols; ++k)
+		for (size_type col = 0; col != Cols2; ++col)
+		  multiplied(row, col) += (*this)(row, k) * rhs(k, col);
+  }
+
+  /**
+   * Unblocked LU factorization with partial pivoting, the same as detail::lu_factor
+   * but constexpr. Returns the determinant
+   */
+  MATRIX_CXX17_CONSTEXPR
+  static double lu_factor(static_matrix<double, Rows, Cols> &factors, size_type (&pivots)[Rows]) {
+	double determinant = 1;
+
+	for (size_type c = 0; c != Rows; ++c) {
+	  size_type pivot = c;
+	  double largest = factors(c, c) < 0 ? -factors(c, c) : factors(c, c);
+
+	  for (size_type r = c + 1; r != Rows; ++r) {
+		const double item = factors(r, c) < 0 ? -factors(r, c) : factors(r, c);
+		if (item > largest) {
+		  largest = item;
+		  pivot = r;
+		}
+	  }
+
+	  pivots[c] = pivot;
+	  if (pivot != c) {
+		factors.swap_rows(c, pivot);
+		determinant = -determinant;
+	  }
+
+	  determinant *= factors(c, c);
+	  if (factors(c, c) == 0.0)
+		continue;
+
+	  for (size_type r = c + 1; r != Rows; ++r) {
+		const double l = factors(r, c) /= factors(c, c);
+		for (size_type q = c + 1; q != Cols; ++q)
+		  factors(r, q) -= l * factors(c, q);
+	  }
+	}
+
+	return determinant;
+  }
+
+  /**
+   * The relative pivot test of detail::lu_negligible_pivot, constexpr:
+   * |u_ii| <= n * epsilon * max |u_ij|
+   */
+  MATRIX_CXX17_CONSTEXPR
+  static bool negligible_pivot(const static_matrix<double, Rows, Cols> &factors) {
+	double largest = 0, smallest_pivot = std::numeric_limits<double>::infinity();
+
+	for (size_type i = 0; i != Rows; ++i) {
+	  const double pivot = factors(i, i) < 0 ? -factors(i, i) : factors(i, i);
+	  if (pivot < smallest_pivot)
+		smallest_pivot = pivot;
+
+	  for (size_type j = i; j != Cols; ++j) {
+		const double item = factors(i, j) < 0 ? -factors(i, j) : factors(i, j);
+		if (item > largest)
+		  largest = item;
+	  }
+	}
+
+	return Rows != 0 && smallest_pivot <= double(Rows) * std::numeric_limits<double>::epsilon() * largest;
+  }
+
+  /**
+   * Solves factors * X = I by forward and back substitution
+   */
+  MATRIX_CXX17_CONSTEXPR
+  static static_matrix lu_inverse(const static_matrix<double, Rows, Cols> &factors, const size_type (&pivots)[Rows]) {
+	static_matrix<double, Rows, Cols> inverted;
+	for (size_type i = 0; i != Rows; ++i)
+	  inverted(i, i) = 1;
+
+	for (size_type i = 0; i != Rows; ++i)
+	  if (pivots[i] != i)
+		inverted.swap_rows(i, pivots[i]);
+
+	for (size_type i = 1; i < Rows; ++i)
+	  for (size_type q = 0; q != i; ++q)
+		for (size_type col = 0; col != Cols; ++col)
+		  inverted(i, col) -= factors(i, q) * inverted(q, col);
+
+	for (size_type i = Rows; i-- != 0;) {
+	  for (size_type q = i + 1; q != Rows; ++q)
+		for (size_type col = 0; col != Cols; ++col)
+		  inverted(i, col) -= factors(i, q) * inverted(q, col);
+
+	  for (size_type col = 0; col != Cols; ++col)
+		inverted(i, col) /= factors(i, i);
+	}
+
+	return inverted.template convert_to<T>();
+  }
+
 private:
   size_type rows_ = Rows, cols_ = Cols;
   value_type data_[Rows * Cols]{};
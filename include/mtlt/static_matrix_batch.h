@@ -0,0 +1,171 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        The batched multiplication multiplies arrays of small static
+ *        matrices pair by pair. Groups of pairs are interleaved so that
+ *        one vector instruction computes the same item of 4 to 16 products
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_STATIC_MATRIX_BATCH_H_
+#define MTLT_STATIC_MATRIX_BATCH_H_
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <mtlt/static_matrix.h>
+#include <mtlt/matrix_gemm.h>
+#include <mtlt/matrix_kernels.h>
+#include <mtlt/thread_pool.h>
+
+namespace mtlt {
+
+namespace detail {
+
+/**
+ * Products with Rows * Cols * Cols2 above this value are not small,
+ * every pair of them is multiplied by the blocked engine
+ */
+MATRIX_CXX17_INLINE constexpr std::size_t batch_max_work = 16 * 16 * 16;
+
+/**
+ * Operands and results with more items than this are not small either:
+ * a group of them is staged on the stack of the calling thread, so the
+ * limit keeps batch_mul_groups near 100 KB of stack for double
+ */
+MATRIX_CXX17_INLINE constexpr std::size_t batch_max_items = 16 * 16;
+
+template<typename T, std::size_t Rows, std::size_t Cols, std::size_t Cols2>
+void batch_mul_groups(const static_matrix<T, Rows, Cols> *lhs, const static_matrix<T, Cols, Cols2> *rhs,
+					  static_matrix<T, Rows, Cols2> *result, std::size_t count,
+					  typename batch_kernel<T>::function_type kernel) {
+  constexpr std::size_t group = batch_group_size;
+  constexpr std::size_t lhs_size = Rows * Cols, rhs_size = Cols * Cols2, result_size = Rows * Cols2;
+
+  alignas(64) T a[lhs_size * group];
+  alignas(64) T b[rhs_size * group];
+  alignas(64) T c[result_size * group];
+
+  // Lanes of the last group past count read zeros and write to a scratch matrix
+  const T zeros[lhs_size > rhs_size ? lhs_size : rhs_size]{};
+  T discarded[result_size];
+
+  const T *lhs_items[group], *rhs_items[group];
+  T *result_items[group];
+
+  for (std::size_t first = 0; first < count; first += group) {
+	const std::size_t size = std::min(group, count - first);
+
+	for (std::size_t g = 0; g != group; ++g) {
+	  lhs_items[g] = g < size ? lhs[first + g].data() : zeros;
+	  rhs_items[g] = g < size ? rhs[first + g].data() : zeros;
+	  result_items[g] = g < size ? result[first + g].data() : discarded;
+	}
+
+	batch_interleave(lhs_items, lhs_size, a);
+	batch_interleave(rhs_items, rhs_size, b);
+	kernel(a, b, c);
+
+	// Operands of the group are already copied, so result may alias lhs or rhs
+	batch_deinterleave(c, result_size, result_items);
+  }
+}
+
+template<typename T, std::size_t Rows, std::size_t Cols, std::size_t Cols2>
+void batch_mul(const static_matrix<T, Rows, Cols> *lhs, const static_matrix<T, Cols, Cols2> *rhs,
+			   static_matrix<T, Rows, Cols2> *result, std::size_t count, std::true_type) {
+  const typename batch_kernel<T>::function_type kernel = select_batch_kernel<T, Rows, Cols, Cols2>();
+
+  const std::size_t work = count * Rows * Cols * Cols2;
+  const std::size_t threads = work > gemm_parallel_threshold ? get_num_threads() : 1;
+
+  if (threads == 1) {
+	batch_mul_groups(lhs, rhs, result, count, kernel);
+	return;
+  }
+
+  const std::size_t groups = (count + batch_group_size - 1) / batch_group_size;
+  const std::size_t chunk = (groups + 4 * threads - 1) / (4 * threads) * batch_group_size;
+
+  parallel_for((count + chunk - 1) / chunk, [=](std::size_t task) {
+	const std::size_t first = task * chunk;
+	batch_mul_groups(lhs + first, rhs + first, result + first, std::min(chunk, count - first), kernel);
+  });
+}
+
+template<typename T, std::size_t Rows, std::size_t Cols, std::size_t Cols2>
+void batch_mul(const static_matrix<T, Rows, Cols> *lhs, const static_matrix<T, Cols, Cols2> *rhs,
+			   static_matrix<T, Rows, Cols2> *result, std::size_t count, std::false_type) {
+  for (std::size_t i = 0; i != count; ++i)
+	result[i] = lhs[i].mul(rhs[i]);
+}
+
+template<typename T, std::size_t Rows, std::size_t Cols, std::size_t Cols2>
+struct is_batch_compatible : std::integral_constant<bool,
+													is_gemm_compatible<T, T>::value &&
+														Rows * Cols * Cols2 <= batch_max_work &&
+														Rows * Cols <= batch_max_items &&
+														Cols * Cols2 <= batch_max_items &&
+														Rows * Cols2 <= batch_max_items> {
+};
+
+} // namespace detail end
+
+/**
+ * Computes result[i] = lhs[i] * rhs[i] for i in [0, count),
+ * result may be the same array as lhs or rhs
+ *
+ * @code
+ *
+ * std::vector<mtlt::static_matrix<float, 4, 4>> world(n), local(n), transforms(n);
+ * mtlt::batch_mul(world.data(), local.data(), transforms.data(), n);
+ *
+ * @endcode
+ */
+template<typename T, std::size_t Rows, std::size_t Cols, std::size_t Cols2>
+void batch_mul(const static_matrix<T, Rows, Cols> *lhs, const static_matrix<T, Cols, Cols2> *rhs,
+			   static_matrix<T, Rows, Cols2> *result, std::size_t count) {
+  detail::batch_mul(lhs, rhs, result, count, detail::is_batch_compatible<T, Rows, Cols, Cols2>());
+}
+
+/**
+ * Returns the vector of lhs[i] * rhs[i], lhs and rhs must have the same size
+ *
+ * @code
+ *
+ * std::vector<mtlt::static_matrix<double, 3, 3>> lhs(n), rhs(n);
+ * std::vector<mtlt::static_matrix<double, 3, 3>> products = mtlt::batch_mul(lhs, rhs);
+ *
+ * @endcode
+ */
+template<typename T, std::size_t Rows, std::size_t Cols, std::size_t Cols2>
+std::vector<static_matrix<T, Rows, Cols2>> batch_mul(const std::vector<static_matrix<T, Rows, Cols>> &lhs,
+													 const std::vector<static_matrix<T, Cols, Cols2>> &rhs) {
+  if (lhs.size() != rhs.size())
+	throw std::logic_error("Can't multiply batches because lhs.size() != rhs.size()");
+
+  std::vector<static_matrix<T, Rows, Cols2>> result(lhs.size());
+  batch_mul(lhs.data(), rhs.data(), result.data(), lhs.size());
+  return result;
+}
+
+} // namespace mtlt end
+
+#endif // MTLT_STATIC_MATRIX_BATCH_H_
@@ -0,0 +1,312 @@
+/*
+ *        Copyright 2024, School21 (Sberbank) Student Library
+ *        All rights reserved
+ *
+ *        MTLT - Matrix Template Library Tonitaga (STL Like)
+ *
+ *        Author:   Gubaydullin Nurislam aka tonitaga
+ *        Email:    gubaydullin.nurislam@gmail.com
+ *        Telegram: @tonitaga
+ *
+ *        The Template Matrix Library for different types
+ *        contains most of the operations on matrices.
+ *
+ *        The thread_pool is a work stealing pool used by the library
+ *        to run heavy operations (e.g. matrix multiplication) on all cores.
+ *        Every worker owns a deque of tasks, pops from its back and steals
+ *        from the front of other deques when its own deque is empty
+ *
+ *        The Template Matrix library is written in the C++20 standard
+ *        Supports C++11 C++14 C++17 C++20 C++23 versions. Also
+ *        The Library is  written in STL style and supports
+ *        STL Algorithms Library.
+*/
+
+#ifndef MTLT_THREAD_POOL_H_
+#define MTLT_THREAD_POOL_H_
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+#include <mtlt/matrix_config.h>
+
+namespace mtlt {
+
+/**
+ * @class thread_pool
+ *
+ * The calling thread of parallel_for also executes tasks, so a pool
+ * of size n runs n - 1 workers. Nested parallel_for calls are allowed,
+ * a waiting thread executes queued tasks of any call and sleeps only
+ * while no task is queued
+ *
+ * @code
+ *
+ * mtlt::thread_pool pool(4);
+ * pool.parallel_for(100, [](std::size_t task) { ... }); // Blocks until all tasks are done
+ *
+ * @endcode
+ */
+class thread_pool {
+private:
+  struct batch {
+	std::function<void(std::size_t)> function;
+	std::atomic<std::size_t> remaining{0};
+	std::exception_ptr exception;
+	std::mutex mutex;
+  };
+
+  struct task {
+	batch *owner;
+	std::size_t index;
+  };
+
+  struct worker_queue {
+	std::mutex mutex;
+	std::deque<task> tasks;
+  };
+
+public:
+  explicit thread_pool(std::size_t threads) : queues_(threads == 0 ? 1 : threads) {
+	for (auto &queue : queues_)
+	  queue.reset(new worker_queue);
+
+	for (std::size_t worker = 1; worker < queues_.size(); ++worker)
+	  workers_.emplace_back([this, worker]() { work(worker); });
+  }
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+  ~thread_pool() {
+	{
+	  std::lock_guard<std::mutex> lock(wake_mutex_);
+	  stop_ = true;
+	}
+	wake_.notify_all();
+
+	for (auto &worker : workers_)
+	  worker.join();
+  }
+
+public:
+  MATRIX_CXX17_NODISCARD
+  std::size_t size() const noexcept { return queues_.size(); }
+
+  /**
+   * Calls function(task) for task in [0, count) on the pool threads,
+   * the first exception thrown by a task is rethrown to the caller
+   */
+  template<typename Function>
+  void parallel_for(std::size_t count, Function &&function) {
+	if (count == 0)
+	  return;
+
+	if (count == 1 || size() == 1) {
+	  for (std::size_t index = 0; index != count; ++index)
+		function(index);
+	  return;
+	}
+
+	batch work;
+	work.function = std::forward<Function>(function);
+	work.remaining.store(count);
+
+	{
+	  std::lock_guard<std::mutex> lock(wake_mutex_);
+	  pending_ += count;
+	}
+
+	for (std::size_t index = 0; index != count; ++index) {
+	  worker_queue &queue = *queues_[index % queues_.size()];
+	  std::lock_guard<std::mutex> lock(queue.mutex);
+	  queue.tasks.push_back(task{&work, index});
+	}
+	wake_.notify_all();
+
+	while (work.remaining.load() != 0) {
+	  task next{};
+	  if (steal(0, next)) {
+		run(next);
+		continue;
+	  }
+
+	  // New tasks of nested calls wake the waiting thread as well as the workers
+	  std::unique_lock<std::mutex> lock(wake_mutex_);
+	  wake_.wait(lock, [this, &work]() { return work.remaining.load() == 0 || pending_ != 0; });
+	}
+
+	std::lock_guard<std::mutex> lock(work.mutex);
+	if (work.exception)
+	  std::rethrow_exception(work.exception);
+  }
+
+private:
+  bool pop(std::size_t worker, task &next) {
+	worker_queue &queue = *queues_[worker];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+
+	if (queue.tasks.empty())
+	  return false;
+
+	next = queue.tasks.back();
+	queue.tasks.pop_back();
+	return true;
+  }
+
+  bool steal(std::size_t thief, task &next) {
+	if (pop(thief, next))
+	  return true;
+
+	for (std::size_t offset = 1; offset < queues_.size(); ++offset) {
+	  worker_queue &queue = *queues_[(thief + offset) % queues_.size()];
+	  std::lock_guard<std::mutex> lock(queue.mutex);
+
+	  if (queue.tasks.empty())
+		continue;
+
+	  next = queue.tasks.front();
+	  queue.tasks.pop_front();
+	  return true;
+	}
+
+	return false;
+  }
+
+  void run(const task &next) {
+	{
+	  std::lock_guard<std::mutex> lock(wake_mutex_);
+	  --pending_;
+	}
+
+	batch &owner = *next.owner;
+	std::exception_ptr exception;
+	try {
+	  owner.function(next.index);
+	} catch (...) {
+	  exception = std::current_exception();
+	}
+
+	if (exception) {
+	  std::lock_guard<std::mutex> lock(owner.mutex);
+	  if (!owner.exception)
+		owner.exception = exception;
+	}
+
+	// The owner may leave parallel_for as soon as remaining is zero, so the
+	// batch isn't touched after the decrement. It happens under wake_mutex_,
+	// so the owner can't miss the notification between its check and its wait
+	bool finished;
+	{
+	  std::lock_guard<std::mutex> lock(wake_mutex_);
+	  finished = owner.remaining.fetch_sub(1) == 1;
+	}
+
+	if (finished)
+	  wake_.notify_all();
+  }
+
+  void work(std::size_t worker) {
+	for (;;) {
+	  task next{};
+	  if (steal(worker, next)) {
+		run(next);
+		continue;
+	  }
+
+	  std::unique_lock<std::mutex> lock(wake_mutex_);
+	  wake_.wait(lock, [this]() { return stop_ || pending_ != 0; });
+
+	  if (stop_)
+		return;
+	}
+  }
+
+private:
+  std::vector<std::unique_ptr<worker_queue>> queues_;
+  std::vector<std::thread> workers_;
+
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+  std::size_t pending_ = 0;
+  bool stop_ = false;
+};
+
+namespace detail {
+
+inline std::size_t default_num_threads() {
+  const std::size_t threads = std::thread::hardware_concurrency();
+  return threads == 0 ? 1 : threads;
+}
+
+struct global_thread_pool {
+  std::mutex mutex;
+  std::size_t threads = default_num_threads();
+  std::unique_ptr<thread_pool> pool;
+};
+
+inline global_thread_pool &global_thread_pool_storage() {
+  static global_thread_pool storage;
+  return storage;
+}
+
+} // namespace detail end
+
+/**
+ * Sets the number of threads used by the library, 0 means
+ * std::thread::hardware_concurrency(). Must not be called while
+ * another thread runs a parallel operation of the library
+ */
+inline void set_num_threads(std::size_t threads) {
+  detail::global_thread_pool &storage = detail::global_thread_pool_storage();
+  std::lock_guard<std::mutex> lock(storage.mutex);
+
+  if (threads == 0)
+	threads = detail::default_num_threads();
+
+  if (storage.threads == threads)
+	return;
+
+  storage.pool.reset();
+  storage.threads = threads;
+}
+
+inline std::size_t get_num_threads() {
+  detail::global_thread_pool &storage = detail::global_thread_pool_storage();
+  std::lock_guard<std::mutex> lock(storage.mutex);
+  return storage.threads;
+}
+
+namespace detail {
+
+inline thread_pool &global_pool() {
+  global_thread_pool &storage = global_thread_pool_storage();
+  std::lock_guard<std::mutex> lock(storage.mutex);
+
+  if (!storage.pool)
+	storage.pool.reset(new thread_pool(storage.threads));
+
+  return *storage.pool;
+}
+
+/**
+ * Runs function(task) for task in [0, count) on the library pool
+ */
+template<typename Function>
+void parallel_for(std::size_t count, Function &&function) {
+  global_pool().parallel_for(count, std::forward<Function>(function));
+}
+
+} // namespace detail end
+
+} // namespace mtlt end
+
+#endif // MTLT_THREAD_POOL_H_
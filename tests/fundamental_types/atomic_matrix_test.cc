@@ -19,6 +19,17 @@ TEST(FTAtomicmatrix, Sizedmatrix) {
   ASSERT_EQ(m(0, 0), 5);
 }
 
+TEST(FTAtomicmatrix, Uninitializedmatrix) {
+  atomic_matrix<int> m(4, 6, uninitialized);
+  ASSERT_EQ(m.size(), 24);
+
+  m.fill(3);
+  ASSERT_EQ(m(3, 5), 3);
+
+  atomic_matrix<int> transposed = m.transpose();
+  ASSERT_EQ(transposed(5, 3), 3);
+}
+
 TEST(FTAtomicmatrix, Sqmatrix) {
   atomic_matrix<int> m(5);
   ASSERT_EQ(m.size(), 25);
@@ -266,6 +277,17 @@ TEST(FTAtomicmatrix, determinant) {
   EXPECT_THROW(m.determinant_gaussian(), std::logic_error);
 }
 
+TEST(FTAtomicmatrix, determinant_bareiss) {
+  atomic_matrix<int> m(3, 3, {3, 6, 2, 8, 6, 1, 9, 4, 7});
+  ASSERT_EQ(m.determinant_bareiss(), -212);
+
+  atomic_matrix<long long> zero_pivot(3, 3, {0, 1, 2, 3, 4, 5, 6, 7, 9});
+  ASSERT_EQ(zero_pivot.determinant_bareiss(), -3);
+
+  m.resize(3, 4);
+  EXPECT_THROW(m.determinant_bareiss(), std::logic_error);
+}
+
 TEST(FTAtomicmatrix, trace) {
   atomic_matrix<int> m(3, 3, {
 	  1, 2, 3,
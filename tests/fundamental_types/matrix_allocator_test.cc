@@ -0,0 +1,291 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include <mtlt/matrix.h>
+#include <mtlt/atomic_matrix.h>
+#include <mtlt/matrix_allocator.h>
+
+using namespace mtlt;
+
+namespace {
+
+bool is_aligned(const void *p, std::size_t alignment) {
+  return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+struct allocation_counter {
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+  std::size_t items = 0;
+};
+
+template<typename T>
+struct counting_allocator {
+  using value_type = T;
+
+  explicit counting_allocator(allocation_counter *counter) noexcept : counter(counter) {}
+
+  template<typename U>
+  counting_allocator(const counting_allocator<U> &other) noexcept : counter(other.counter) {}
+
+  T *allocate(std::size_t n) {
+	++counter->allocations;
+	counter->items += n;
+	return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T *p, std::size_t n) noexcept {
+	++counter->deallocations;
+	counter->items -= n;
+	std::allocator<T>().deallocate(p, n);
+  }
+
+  allocation_counter *counter;
+};
+
+template<typename T, typename U>
+bool operator==(const counting_allocator<T> &lhs, const counting_allocator<U> &rhs) {
+  return lhs.counter == rhs.counter;
+}
+
+template<typename T, typename U>
+bool operator!=(const counting_allocator<T> &lhs, const counting_allocator<U> &rhs) {
+  return !(lhs == rhs);
+}
+
+} // namespace
+
+TEST(FTAllocator, DefaultAllocator) {
+  ASSERT_TRUE((std::is_same<matrix<double>::allocator_type, aligned_allocator<double>>::value));
+  ASSERT_TRUE((std::is_same<matrix<std::string>::allocator_type, std::allocator<std::string>>::value));
+  ASSERT_TRUE((std::is_same<atomic_matrix<int>::allocator_type, aligned_allocator<std::atomic<int>>>::value));
+}
+
+TEST(FTAllocator, AlignedStorage) {
+  for (std::size_t size = 1; size != 40; ++size) {
+	matrix<char> c(size, 3);
+	matrix<float> f(size, size, 1.5f);
+	matrix<double> d = matrix<double>::identity(size, size);
+	atomic_matrix<int> a(size, 2, 7);
+
+	ASSERT_TRUE(is_aligned(c.data(), 64));
+	ASSERT_TRUE(is_aligned(f.data(), 64));
+	ASSERT_TRUE(is_aligned(d.data(), 64));
+	ASSERT_TRUE(is_aligned(&a(0, 0), 64));
+	ASSERT_EQ(f(size - 1, size - 1), 1.5f);
+	ASSERT_EQ(a(size - 1, 1), 7);
+  }
+
+  matrix<double> m(5, 7);
+  m.resize(13, 3);
+  ASSERT_TRUE(is_aligned(m.data(), 64));
+  ASSERT_TRUE(is_aligned((m * m.transpose()).data(), 64));
+}
+
+TEST(FTAllocator, WiderAlignment) {
+  std::vector<float, aligned_allocator<float, 256>> buffer(100, 1.0f);
+  ASSERT_TRUE(is_aligned(buffer.data(), 256));
+
+  matrix<double, aligned_allocator<double, 128>> m(3, 3, 2.0);
+  ASSERT_TRUE(is_aligned(m.data(), 128));
+  ASSERT_EQ((m * m)(1, 1), 12.0);
+}
+
+TEST(FTAllocator, StandardAllocator) {
+  matrix<int, std::allocator<int>> m(2, 2, {1, 2, 3, 4});
+  matrix<int, std::allocator<int>> squared = m * m;
+  matrix<int> aligned(2, 2, {1, 2, 3, 4});
+
+  ASSERT_EQ(squared(0, 0), 7);
+  ASSERT_EQ(squared(1, 1), 22);
+
+  // Operands of different allocators mix, the result takes the left one
+  matrix<int, std::allocator<int>> sum = m + aligned;
+  ASSERT_EQ(sum(1, 0), 6);
+
+  // gemm reads and writes storage of any allocators in place
+  matrix<int, aligned_allocator<int, 128>> c(2, 2, 1);
+  gemm(2, m, aligned, 1, c);
+  ASSERT_EQ(c(0, 0), 15);
+  ASSERT_EQ(c(1, 1), 45);
+}
+
+TEST(FTAllocator, ScalarOfOtherType) {
+  // The allocator of the result is rebound to the type of the scalar
+  matrix<double> scaled = 2.5 * matrix<int>(2, 2, {1, 2, 3, 4});
+  ASSERT_EQ(scaled(0, 1), 5.0);
+  ASSERT_EQ(scaled(1, 1), 10.0);
+
+  matrix<long, std::allocator<long>> widened = 3L * matrix<int, std::allocator<int>>(1, 2, {1, 2});
+  ASSERT_EQ(widened(0, 1), 6L);
+}
+
+TEST(FTAllocator, EveryAllocationThroughAllocator) {
+  allocation_counter counter;
+  {
+	counting_allocator<double> allocator(&counter);
+	matrix<double, counting_allocator<double>> m(3, 4, 1.0, allocator);
+	ASSERT_EQ(counter.allocations, 1u);
+	ASSERT_EQ(counter.items, 12u);
+
+	matrix<double, counting_allocator<double>> copy(m);
+	ASSERT_EQ(copy.get_allocator(), allocator);
+	ASSERT_EQ(counter.allocations, 2u);
+
+	m.resize(5, 5);
+	ASSERT_EQ(counter.allocations, 3u);
+	ASSERT_EQ(counter.items, 12u + 25u);
+	ASSERT_EQ(m(2, 3), 1.0);
+	ASSERT_EQ(m(4, 4), 0.0);
+
+	m.rows(2);
+	m.cols(3);
+	ASSERT_EQ(counter.items, 12u + 6u);
+
+	matrix<double, counting_allocator<double>> product = m * copy;
+	ASSERT_EQ(product.get_allocator(), allocator);
+	ASSERT_EQ(product(1, 2), 3.0);
+
+	matrix<double, counting_allocator<double>> transposed = product.transpose();
+	ASSERT_EQ(transposed.get_allocator(), allocator);
+
+	matrix<double, counting_allocator<double>> moved(std::move(transposed));
+	ASSERT_EQ(moved.get_allocator(), allocator);
+
+	m.clear();
+	ASSERT_EQ(counter.items, 12u + 8u + 8u);
+  }
+
+  ASSERT_EQ(counter.items, 0u);
+  ASSERT_EQ(counter.allocations, counter.deallocations);
+}
+
+TEST(FTAllocator, AtomicThroughAllocator) {
+  allocation_counter counter;
+  {
+	counting_allocator<std::atomic<int>> allocator(&counter);
+	atomic_matrix<int, std::atomic, counting_allocator<std::atomic<int>>> m(3, 3, 2, allocator);
+	ASSERT_EQ(counter.items, 9u);
+
+	m.resize(4, 4);
+	ASSERT_EQ(counter.items, 16u);
+	ASSERT_EQ(m(2, 2), 2);
+	ASSERT_EQ(m(3, 3), 0);
+	ASSERT_EQ(m.get_allocator(), allocator);
+  }
+
+  ASSERT_EQ(counter.items, 0u);
+  ASSERT_EQ(counter.allocations, counter.deallocations);
+}
+
+TEST(FTAllocator, AssignmentKeepsNotPropagatingAllocator) {
+  using allocator_type = counting_allocator<double>;
+  static_assert(!std::allocator_traits<allocator_type>::propagate_on_container_copy_assignment::value, "");
+  static_assert(!std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value, "");
+
+  allocation_counter left_counter, right_counter;
+  {
+	allocator_type left(&left_counter), right(&right_counter);
+	matrix<double, allocator_type> m(2, 3, 1.0, left);
+	matrix<double, allocator_type> other(3, 2, 5.0, right);
+	const double *storage = m.data();
+
+	m = other;
+	ASSERT_EQ(m.get_allocator(), left);
+	ASSERT_EQ(m.data(), storage);
+	ASSERT_EQ(m.rows(), 3u);
+	ASSERT_EQ(m(2, 1), 5.0);
+	ASSERT_EQ(left_counter.allocations, 1u);
+
+	matrix<double, allocator_type> bigger(4, 4, 7.0, right);
+	m = bigger;
+	ASSERT_EQ(m.get_allocator(), left);
+	ASSERT_EQ(m(3, 3), 7.0);
+	ASSERT_EQ(left_counter.allocations, 2u);
+	ASSERT_EQ(left_counter.deallocations, 1u);
+
+	m = std::move(other);
+	ASSERT_EQ(m.get_allocator(), left);
+	ASSERT_EQ(m(1, 1), 5.0);
+	ASSERT_EQ(left_counter.allocations, 3u);
+	ASSERT_EQ(right_counter.deallocations, 0u);
+
+	matrix<double, allocator_type> same(2, 2, 3.0, left);
+	storage = same.data();
+	m = std::move(same);
+	ASSERT_EQ(m.data(), storage);
+	ASSERT_EQ(left_counter.allocations, 4u);
+  }
+
+  ASSERT_EQ(left_counter.items, 0u);
+  ASSERT_EQ(right_counter.items, 0u);
+  ASSERT_EQ(left_counter.allocations, left_counter.deallocations);
+  ASSERT_EQ(right_counter.allocations, right_counter.deallocations);
+}
+
+TEST(FTAllocator, AtomicAssignmentKeepsNotPropagatingAllocator) {
+  using allocator_type = counting_allocator<std::atomic<int>>;
+  using atomic_type = atomic_matrix<int, std::atomic, allocator_type>;
+
+  allocation_counter left_counter, right_counter;
+  {
+	allocator_type left(&left_counter), right(&right_counter);
+	atomic_type m(2, 2, 1, left);
+	atomic_type other(2, 2, 4, right);
+
+	m = other;
+	ASSERT_EQ(m.get_allocator(), left);
+	ASSERT_EQ(m(1, 1), 4);
+	ASSERT_EQ(left_counter.allocations, 1u);
+
+	atomic_type bigger(3, 3, 6, right);
+	m = std::move(bigger);
+	ASSERT_EQ(m.get_allocator(), left);
+	ASSERT_EQ(m(2, 2), 6);
+	ASSERT_EQ(left_counter.allocations, 2u);
+  }
+
+  ASSERT_EQ(left_counter.items, 0u);
+  ASSERT_EQ(right_counter.items, 0u);
+  ASSERT_EQ(left_counter.allocations, left_counter.deallocations);
+  ASSERT_EQ(right_counter.allocations, right_counter.deallocations);
+}
+
+namespace {
+
+struct throwing_item {
+  static int live;
+  static int constructions_left;
+
+  throwing_item() {
+	if (constructions_left-- == 0)
+	  throw std::runtime_error("construction failed");
+	++live;
+  }
+
+  throwing_item(const throwing_item &) : throwing_item() {}
+
+  ~throwing_item() { --live; }
+};
+
+int throwing_item::live = 0;
+int throwing_item::constructions_left = 0;
+
+} // namespace
+
+TEST(FTAllocator, ThrowingConstructor) {
+  allocation_counter counter;
+  counting_allocator<throwing_item> allocator(&counter);
+
+  throwing_item::constructions_left = 5;
+  ASSERT_ANY_THROW((matrix<throwing_item, counting_allocator<throwing_item>>(3, 3, uninitialized, allocator)));
+
+  ASSERT_EQ(throwing_item::live, 0);
+  ASSERT_EQ(counter.items, 0u);
+  ASSERT_EQ(counter.allocations, counter.deallocations);
+}
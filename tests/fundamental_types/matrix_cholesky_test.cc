@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_lu.h>
+#include <mtlt/matrix_cholesky.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+namespace {
+
+matrix<double> spd_matrix(std::size_t n, int seed) {
+  matrix<double> m = random_matrix(n, n, seed);
+  return mul_nt(m, m) + matrix<double>::identity(n, n) * static_cast<double>(n);
+}
+
+} // namespace
+
+TEST(FTCholesky, FactorReproducesMatrix) {
+  const std::size_t sizes[] = {1, 5, 16, 17, 100, 203};
+
+  for (std::size_t n : sizes) {
+	matrix<double> a = spd_matrix(n, static_cast<int>(n));
+	cholesky<double> factorization(a);
+
+	ASSERT_EQ(factorization.size(), n);
+	expect_near(factorization.lower() * factorization.upper(), a, 1e-9);
+
+	for (std::size_t row = 0; row != n; ++row)
+	  for (std::size_t col = row + 1; col != n; ++col)
+		ASSERT_EQ(factorization.lower()(row, col), 0.0);
+  }
+}
+
+TEST(FTCholesky, UpperTriangleIsIgnored) {
+  matrix<double> a = spd_matrix(90, 3);
+  matrix<double> garbage(a);
+  for (std::size_t row = 0; row != a.rows(); ++row)
+	for (std::size_t col = row + 1; col != a.cols(); ++col)
+	  garbage(row, col) = -1e6;
+
+  ASSERT_EQ(cholesky<double>(garbage).lower(), cholesky<double>(a).lower());
+}
+
+TEST(FTCholesky, SolveAndInverse) {
+  matrix<double> a = spd_matrix(130, 4);
+  matrix<double> b = random_matrix(130, 7, 5);
+  cholesky<double> factorization(a);
+
+  expect_near(a * factorization.solve(b), b, 1e-9);
+  expect_near(a * factorization.inverse(), matrix<double>::identity(130, 130), 1e-9);
+
+  std::vector<double> y(130, 1.0);
+  std::vector<double> x = solve_spd(a, y);
+  for (std::size_t row = 0; row != 130; ++row) {
+	double sum = 0;
+	for (std::size_t col = 0; col != 130; ++col)
+	  sum += a(row, col) * x[col];
+	ASSERT_NEAR(sum, 1.0, 1e-9);
+  }
+
+  expect_near(solve_spd(a, b), lu<double>(a).solve(b), 1e-9);
+}
+
+TEST(FTCholesky, Determinant) {
+  matrix<double> small(3, 3, {4, 2, 2, 2, 5, 3, 2, 3, 6});
+  cholesky<double> factorization(small);
+  ASSERT_NEAR(factorization.determinant(), 64.0, 1e-9);
+  ASSERT_NEAR(factorization.log_determinant(), std::log(64.0), 1e-12);
+
+  // The determinant itself overflows, its logarithm does not
+  matrix<double> large = spd_matrix(300, 6);
+  double lu_log = 0;
+  matrix<double> factors = lu<double>(large).upper();
+  for (std::size_t i = 0; i != 300; ++i)
+	lu_log += std::log(std::fabs(factors(i, i)));
+
+  ASSERT_NEAR(cholesky<double>(large).log_determinant(), lu_log, 1e-8);
+
+  slogdet_result<double> det = cholesky<double>(large).slogdet();
+  ASSERT_EQ(det.sign, 1.0);
+  ASSERT_NEAR(det.log_abs, slogdet(large).log_abs, 1e-8);
+}
+
+TEST(FTCholesky, FloatFactorization) {
+  matrix<float> a(3, 3, {4, 2, 2, 2, 5, 3, 2, 3, 6});
+  cholesky<float> factorization(a);
+
+  std::vector<float> x = factorization.solve(std::vector<float>{8, 10, 11});
+  ASSERT_NEAR(x[0], 1.0f, 1e-5f);
+  ASSERT_NEAR(x[1], 1.0f, 1e-5f);
+  ASSERT_NEAR(x[2], 1.0f, 1e-5f);
+}
+
+TEST(FTCholesky, ParallelMatchesSequential) {
+  matrix<double> a = spd_matrix(260, 7);
+  matrix<double> sequential = cholesky<double>(a).lower();
+
+  const scoped_num_threads threads(4);
+  matrix<double> parallel = cholesky<double>(a).lower();
+
+  expect_near(parallel, sequential, 1e-12);
+}
+
+TEST(FTCholesky, Exceptions) {
+  ASSERT_ANY_THROW(cholesky<double>(matrix<double>(2, 3)));
+  ASSERT_ANY_THROW(cholesky<double>(matrix<double>(2, 2, {1, 2, 2, 1})));
+  ASSERT_ANY_THROW(cholesky<double>(matrix<double>(2, 2, {-1, 0, 0, 1})));
+  ASSERT_ANY_THROW(cholesky<double>(matrix<double>(2, 2, {0, 0, 0, 0})));
+
+  matrix<double> indefinite = spd_matrix(60, 8);
+  indefinite(45, 45) = -1e3;
+  ASSERT_ANY_THROW(cholesky<double>{indefinite});
+
+  cholesky<double> factorization(spd_matrix(4, 9));
+  matrix<double> wrong(3, 1);
+  std::vector<double> wrong_vector(5);
+  ASSERT_ANY_THROW(factorization.solve_in_place(wrong));
+  ASSERT_ANY_THROW(factorization.solve_in_place(wrong_vector));
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_qr.h>
+#include <mtlt/matrix_eigen.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+namespace {
+
+matrix<double> symmetric_matrix(std::size_t n, int seed) {
+  matrix<double> m = random_matrix(n, n, seed);
+  return m + m.transpose();
+}
+
+void expect_eigenpairs(const matrix<double> &a, const eigh_result<double> &eigen, double tolerance) {
+  const std::size_t count = eigen.values.size();
+  ASSERT_EQ(eigen.vectors.rows(), a.rows());
+  ASSERT_EQ(eigen.vectors.cols(), count);
+
+  matrix<double> product = a * eigen.vectors;
+  for (std::size_t row = 0; row != a.rows(); ++row)
+	for (std::size_t col = 0; col != count; ++col)
+	  ASSERT_NEAR(product(row, col), eigen.vectors(row, col) * eigen.values[col], tolerance);
+
+  matrix<double> gram = mul_tn(eigen.vectors, eigen.vectors);
+  for (std::size_t row = 0; row != count; ++row)
+	for (std::size_t col = 0; col != count; ++col)
+	  ASSERT_NEAR(gram(row, col), row == col ? 1.0 : 0.0, tolerance);
+
+  for (std::size_t i = 1; i < count; ++i)
+	ASSERT_LE(eigen.values[i - 1], eigen.values[i]);
+}
+
+} // namespace
+
+TEST(FTEigen, RandomSymmetric) {
+  const std::size_t sizes[] = {1, 2, 7, 32, 33, 100, 250};
+
+  for (std::size_t n : sizes)
+	expect_eigenpairs(symmetric_matrix(n, static_cast<int>(n)), eigh(symmetric_matrix(n, static_cast<int>(n))), 1e-12);
+}
+
+TEST(FTEigen, KnownEigenvalues) {
+  matrix<double> a(2, 2, {2, 1, 1, 2});
+  eigh_result<double> eigen = eigh(a);
+
+  ASSERT_NEAR(eigen.values[0], 1.0, 1e-14);
+  ASSERT_NEAR(eigen.values[1], 3.0, 1e-14);
+  ASSERT_NEAR(std::fabs(eigen.vectors(0, 1)), std::sqrt(0.5), 1e-14);
+
+  // Tridiagonal 2, -1 has eigenvalues 2 - 2 * cos(pi * k / (n + 1))
+  const std::size_t n = 120;
+  matrix<double> laplacian(n, n);
+  for (std::size_t i = 0; i != n; ++i) {
+	laplacian(i, i) = 2;
+	if (i != 0)
+	  laplacian(i, i - 1) = laplacian(i - 1, i) = -1;
+  }
+
+  std::vector<double> values = eigvalsh(laplacian);
+  for (std::size_t k = 0; k != n; ++k)
+	ASSERT_NEAR(values[k], 2 - 2 * std::cos(std::acos(-1.0) * static_cast<double>(k + 1) / (n + 1)), 1e-12);
+}
+
+TEST(FTEigen, RepeatedEigenvalues) {
+  const std::size_t n = 150;
+  matrix<double> q = qr<double>(random_matrix(n, n, 3)).thin_q();
+  matrix<double> diagonal(n, n);
+  for (std::size_t i = 0; i != n; ++i)
+	diagonal(i, i) = static_cast<double>(i % 3);
+
+  matrix<double> a = q * diagonal * q.transpose();
+  eigh_result<double> eigen = eigh(a);
+  expect_eigenpairs(a, eigen, 1e-12);
+  for (std::size_t i = 0; i != n; ++i)
+	ASSERT_NEAR(eigen.values[i], static_cast<double>(i / 50), 1e-12);
+
+  expect_eigenpairs(a, eigh(a, 60), 1e-12);
+  expect_eigenpairs(matrix<double>::identity(n, n), eigh(matrix<double>::identity(n, n)), 0.0);
+}
+
+TEST(FTEigen, UpperTriangleIsIgnored) {
+  matrix<double> a = symmetric_matrix(80, 4);
+  matrix<double> garbage(a);
+  for (std::size_t row = 0; row != a.rows(); ++row)
+	for (std::size_t col = row + 1; col != a.cols(); ++col)
+	  garbage(row, col) = 1e6;
+
+  ASSERT_EQ(eigh(garbage).values, eigh(a).values);
+}
+
+TEST(FTEigen, LargestOnlyMatchesFull) {
+  matrix<double> a = symmetric_matrix(200, 5);
+  eigh_result<double> full = eigh(a);
+  eigh_result<double> top = eigh(a, 20);
+
+  ASSERT_EQ(top.values.size(), 20);
+  expect_eigenpairs(a, top, 1e-12);
+  for (std::size_t i = 0; i != 20; ++i)
+	ASSERT_NEAR(top.values[i], full.values[180 + i], 1e-12);
+
+  std::vector<double> values = eigvalsh(a);
+  for (std::size_t i = 0; i != values.size(); ++i)
+	ASSERT_NEAR(values[i], full.values[i], 1e-12);
+
+  ASSERT_TRUE(eigh(a, 0).values.empty());
+}
+
+TEST(FTEigen, FloatAndParallel) {
+  matrix<float> small(3, 3, {4, 1, 0, 1, 4, 1, 0, 1, 4});
+  std::vector<float> values = eigvalsh(small);
+  ASSERT_NEAR(values[0], 4 - std::sqrt(2.0f), 1e-5f);
+  ASSERT_NEAR(values[1], 4.0f, 1e-5f);
+  ASSERT_NEAR(values[2], 4 + std::sqrt(2.0f), 1e-5f);
+
+  matrix<double> a = symmetric_matrix(300, 6);
+  const scoped_num_threads threads(4);
+  eigh_result<double> parallel = eigh(a);
+
+  expect_eigenpairs(a, parallel, 1e-12);
+}
+
+TEST(FTEigen, Exceptions) {
+  ASSERT_ANY_THROW(eigh(matrix<double>(2, 3)));
+  ASSERT_ANY_THROW(eigh(matrix<double>(2, 3), 1));
+  ASSERT_ANY_THROW(eigvalsh(matrix<double>(3, 2)));
+  ASSERT_ANY_THROW(eigh(matrix<double>(3, 3), 4));
+  ASSERT_TRUE(eigh(matrix<double>()).values.empty());
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+#include <mtlt/matrix.h>
+#include <mtlt/static_matrix.h>
+#include <mtlt/matrix_functions.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+namespace {
+
+// Partial sums of the Taylor series, accurate for small norms only
+matrix<double> taylor_exp(const matrix<double> &a) {
+  matrix<double> sum = matrix<double>::identity(a.rows(), a.cols()), term(sum);
+  for (int k = 1; k != 40; ++k) {
+	term = term * a;
+	term.mul(1.0 / k);
+	sum += term;
+  }
+  return sum;
+}
+
+} // namespace
+
+TEST(FTFunctions, PowMatchesRepeatedProduct) {
+  matrix<long long> a(4, 4, {1, 1, 0, 0, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 0, 1});
+  matrix<long long> repeated = matrix<long long>::identity(4, 4);
+
+  for (std::size_t k = 0; k != 25; ++k) {
+	ASSERT_EQ(pow(a, k), repeated);
+	repeated = repeated * a;
+  }
+
+  matrix<double> b = random_matrix(70, 70, 1);
+  matrix<double> product = b;
+  for (int k = 1; k != 13; ++k)
+	product = product * b;
+  expect_near(pow(b, 13), product, 1e-7);
+}
+
+TEST(FTFunctions, PowFibonacci) {
+  matrix<long long> step(2, 2, {1, 1, 1, 0});
+  ASSERT_EQ(pow(step, 90)(0, 1), 2880067194370816120LL);
+}
+
+TEST(FTFunctions, PowMarkovChainConverges) {
+  matrix<double> transition(3, 3, {0.9, 0.075, 0.025, 0.15, 0.8, 0.05, 0.25, 0.25, 0.5});
+  matrix<double> limit = pow(transition, 1000);
+
+  for (std::size_t row = 0; row != 3; ++row) {
+	ASSERT_NEAR(limit(row, 0), 0.625, 1e-12);
+	ASSERT_NEAR(limit(row, 1), 0.3125, 1e-12);
+	ASSERT_NEAR(limit(row, 2), 0.0625, 1e-12);
+  }
+}
+
+TEST(FTFunctions, PowStaticMatrix) {
+  static_matrix<int, 2, 2> step({1, 1, 1, 0});
+  static_matrix<int, 2, 2> fibonacci = pow(step, 20);
+  ASSERT_EQ(fibonacci(0, 1), 6765);
+  ASSERT_EQ(pow(step, 0), step.identity());
+
+#if __cplusplus > 201703L
+  constexpr static_matrix<long long, 2, 2> compile_time = pow(static_matrix<long long, 2, 2>({1, 1, 1, 0}), 50);
+  static_assert(compile_time(0, 1) == 12586269025LL);
+#endif
+}
+
+TEST(FTFunctions, OtherLayouts) {
+  using columns_type = matrix<double, default_allocator<double>, column_major>;
+  using tiles_type = matrix<double, default_allocator<double>, tiled<8>>;
+
+  matrix<double> a = random_matrix(37, 37, 2);
+  a.mul(0.05);
+  const columns_type columns(a);
+  const tiles_type tiles(a);
+
+  expect_near(matrix<double>(pow(columns, 7)), pow(a, 7), 1e-10);
+  expect_near(matrix<double>(pow(tiles, 7)), pow(a, 7), 1e-10);
+  expect_near(matrix<double>(pow(tiles, 0)), matrix<double>::identity(37, 37), 0.0);
+
+  expect_near(matrix<double>(expm(columns)), expm(a), 1e-12);
+  expect_near(matrix<double>(expm(tiles)), expm(a), 1e-12);
+}
+
+TEST(FTFunctions, ExpmKnownValues) {
+  expect_near(expm(matrix<double>(5, 5)), matrix<double>::identity(5, 5), 0.0);
+
+  matrix<double> nilpotent(3, 3, {0, 1, 0, 0, 0, 1, 0, 0, 0});
+  expect_near(expm(nilpotent), matrix<double>(3, 3, {1, 1, 0.5, 0, 1, 1, 0, 0, 1}), 1e-15);
+
+  matrix<double> diagonal(3, 3, {-1, 0, 0, 0, 2, 0, 0, 0, 7});
+  matrix<double> exponential = expm(diagonal);
+  ASSERT_NEAR(exponential(0, 0), std::exp(-1.0), 1e-15);
+  ASSERT_NEAR(exponential(1, 1), std::exp(2.0), 1e-14);
+  ASSERT_NEAR(exponential(2, 2) / std::exp(7.0), 1.0, 1e-14);
+
+  // Rotation generators of growing norm go through every Pade degree and the squarings
+  const double angles[] = {0.01, 0.2, 0.9, 2.0, 5.0, 40.0};
+  for (double angle : angles) {
+	matrix<double> rotation = expm(matrix<double>(2, 2, {0, -angle, angle, 0}));
+	ASSERT_NEAR(rotation(0, 0), std::cos(angle), 1e-13);
+	ASSERT_NEAR(rotation(0, 1), -std::sin(angle), 1e-13);
+	ASSERT_NEAR(rotation(1, 0), std::sin(angle), 1e-13);
+	ASSERT_NEAR(rotation(1, 1), std::cos(angle), 1e-13);
+  }
+}
+
+TEST(FTFunctions, ExpmMatchesTaylorAndInverse) {
+  matrix<double> small = random_matrix(30, 30, 2);
+  small.mul(0.1);
+  expect_near(expm(small), taylor_exp(small), 1e-13);
+
+  matrix<double> large = random_matrix(60, 60, 3);
+  large.mul(3.0);
+  matrix<double> negative = large * -1.0;
+  expect_near(expm(large) * expm(negative), matrix<double>::identity(60, 60), 1e-8);
+
+  matrix<float> single(2, 2, {0, 1, -1, 0});
+  matrix<float> rotation = expm(single);
+  ASSERT_NEAR(rotation(0, 0), std::cos(1.0f), 1e-6f);
+  ASSERT_NEAR(rotation(0, 1), std::sin(1.0f), 1e-6f);
+}
+
+TEST(FTFunctions, ExpmNonFiniteItems) {
+  const double inf = std::numeric_limits<double>::infinity();
+  ASSERT_THROW(expm(matrix<double>(2, 2, {inf, 0, 0, 1})), std::logic_error);
+  ASSERT_THROW(expm(static_matrix<double, 2, 2>({1, -inf, 0, 1})), std::logic_error);
+}
+
+TEST(FTFunctions, ExpmStaticMatrix) {
+  static_matrix<double, 2, 2> generator({0, -10, 10, 0});
+  static_matrix<double, 2, 2> rotation = expm(generator);
+  ASSERT_NEAR(rotation(0, 0), std::cos(10.0), 1e-12);
+  ASSERT_NEAR(rotation(1, 0), std::sin(10.0), 1e-12);
+
+#if __cplusplus > 201703L
+  constexpr static_matrix<double, 2, 2> compile_time = expm(static_matrix<double, 2, 2>({0, 1, 0, 0}));
+  static_assert(compile_time(0, 0) == 1.0 && compile_time(0, 1) == 1.0 && compile_time(1, 0) == 0.0);
+#endif
+}
+
+TEST(FTFunctions, Exceptions) {
+  ASSERT_ANY_THROW(pow(matrix<int>(2, 3), 2));
+  ASSERT_ANY_THROW(expm(matrix<double>(2, 3)));
+}
@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include <mtlt/matrix.h>
+#include <mtlt/static_matrix.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+namespace {
+
+template<typename T>
+matrix<T> naive_mul(const matrix<T> &lhs, const matrix<T> &rhs) {
+  matrix<T> result(lhs.rows(), rhs.cols());
+  for (std::size_t row = 0; row != lhs.rows(); ++row)
+	for (std::size_t col = 0; col != rhs.cols(); ++col)
+	  for (std::size_t k = 0; k != lhs.cols(); ++k)
+		result(row, col) += lhs(row, k) * rhs(k, col);
+  return result;
+}
+
+} // namespace
+
+TEST(FTGemm, IntegralBlockedMatchesNaive) {
+  const std::size_t sizes[][3] = {{1, 1, 1}, {3, 5, 7}, {64, 64, 64}, {67, 129, 45}, {130, 3, 257}, {5, 300, 40}};
+
+  for (const auto &size : sizes) {
+	matrix<int> lhs = integer_matrix<int>(size[0], size[1], 3);
+	matrix<int> rhs = integer_matrix<int>(size[1], size[2], 5);
+
+	ASSERT_EQ(lhs * rhs, naive_mul(lhs, rhs));
+  }
+}
+
+TEST(FTGemm, FloatingBlockedMatchesNaive) {
+  matrix<double> lhs = integer_matrix<double>(97, 211, 1);
+  matrix<double> rhs = integer_matrix<double>(211, 73, 2);
+
+  matrix<double> blocked = lhs * rhs;
+  matrix<double> expected = naive_mul(lhs, rhs);
+
+  ASSERT_EQ(blocked.rows(), 97);
+  ASSERT_EQ(blocked.cols(), 73);
+  for (std::size_t i = 0; i != blocked.size(); ++i)
+	ASSERT_NEAR(blocked.data()[i], expected.data()[i], 1e-9);
+}
+
+TEST(FTGemm, FloatBlockedMatchesNaive) {
+  matrix<float> lhs = integer_matrix<float>(75, 90, 4);
+  matrix<float> rhs = integer_matrix<float>(90, 81, 6);
+
+  matrix<float> blocked = lhs * rhs;
+  matrix<float> expected = naive_mul(lhs, rhs);
+
+  for (std::size_t i = 0; i != blocked.size(); ++i)
+	ASSERT_FLOAT_EQ(blocked.data()[i], expected.data()[i]);
+}
+
+TEST(FTGemm, SmallCacheBlocking) {
+  cache_info saved = get_cache_info();
+  cache_info tiny;
+  tiny.l1 = 1024;
+  tiny.l2 = 4096;
+  tiny.l3 = 16384;
+  set_cache_info(tiny);
+
+  matrix<long long> lhs = integer_matrix<long long>(150, 170, 7);
+  matrix<long long> rhs = integer_matrix<long long>(170, 190, 8);
+  matrix<long long> blocked = lhs * rhs;
+
+  set_cache_info(saved);
+  ASSERT_EQ(blocked, naive_mul(lhs, rhs));
+}
+
+TEST(FTGemm, MixedTypesUseNaiveLoop) {
+  matrix<double> lhs(2, 2, {1.5, 2, 3, 4});
+  matrix<int> rhs(2, 2, {1, 2, 3, 4});
+
+  matrix<double> result = lhs * rhs;
+  ASSERT_EQ(result, matrix<double>(2, 2, {7.5, 11, 15, 22}));
+}
+
+TEST(FTGemm, EmptyInnerDimension) {
+  matrix<double> lhs(4, 0);
+  matrix<double> rhs(0, 5);
+
+  matrix<double> result = lhs * rhs;
+  ASSERT_EQ(result, matrix<double>(4, 5));
+}
+
+TEST(FTGemm, EverySimdLevelMatchesNaive) {
+  const simd_level detected = detected_simd_level();
+
+  matrix<double> lhs_d = integer_matrix<double>(83, 131, 1);
+  matrix<double> rhs_d = integer_matrix<double>(131, 59, 2);
+  matrix<float> lhs_f = integer_matrix<float>(83, 131, 3);
+  matrix<float> rhs_f = integer_matrix<float>(131, 59, 4);
+  matrix<int> lhs_i = integer_matrix<int>(83, 131, 5);
+  matrix<int> rhs_i = integer_matrix<int>(131, 59, 6);
+
+  for (int level = 0; level <= static_cast<int>(detected); ++level) {
+	set_simd_level(static_cast<simd_level>(level));
+	ASSERT_EQ(get_simd_level(), static_cast<simd_level>(level));
+
+	ASSERT_EQ(lhs_d * rhs_d, naive_mul(lhs_d, rhs_d));
+	ASSERT_EQ(lhs_f * rhs_f, naive_mul(lhs_f, rhs_f));
+	ASSERT_EQ(lhs_i * rhs_i, naive_mul(lhs_i, rhs_i));
+  }
+
+  set_simd_level(simd_level::avx512);
+  ASSERT_EQ(get_simd_level(), detected);
+}
+
+TEST(FTGemm, StaticMatrixBlockedMatchesNaive) {
+  static_matrix<int, 40, 50> lhs;
+  static_matrix<int, 50, 30> rhs;
+  std::iota(lhs.begin(), lhs.end(), -1000);
+  std::iota(rhs.begin(), rhs.end(), -700);
+
+  static_matrix<int, 40, 30> blocked = lhs * rhs;
+  for (std::size_t row = 0; row != 40; ++row)
+	for (std::size_t col = 0; col != 30; ++col) {
+	  int expected = 0;
+	  for (std::size_t k = 0; k != 50; ++k)
+		expected += lhs(row, k) * rhs(k, col);
+	  ASSERT_EQ(blocked(row, col), expected);
+	}
+}
+
+TEST(FTGemm, ParallelMatchesNaive) {
+  const scoped_num_threads threads(4);
+
+  matrix<int> lhs = integer_matrix<int>(301, 187, 9);
+  matrix<int> rhs = integer_matrix<int>(187, 263, 10);
+  matrix<double> lhs_d = integer_matrix<double>(160, 140, 11);
+  matrix<double> rhs_d = integer_matrix<double>(140, 150, 12);
+
+  matrix<int> parallel = lhs * rhs;
+  matrix<double> parallel_d = lhs_d * rhs_d;
+
+  ASSERT_EQ(parallel, naive_mul(lhs, rhs));
+  ASSERT_EQ(parallel_d, naive_mul(lhs_d, rhs_d));
+}
+
+TEST(FTGemm, TransposedOperands) {
+  const std::size_t sizes[][3] = {{3, 5, 7}, {67, 129, 45}, {130, 64, 257}};
+
+  for (const auto &size : sizes) {
+	matrix<int> a = integer_matrix<int>(size[1], size[0], 1);
+	matrix<int> b = integer_matrix<int>(size[1], size[2], 2);
+	matrix<int> c = integer_matrix<int>(size[2], size[1], 3);
+	matrix<int> d = integer_matrix<int>(size[0], size[1], 4);
+
+	ASSERT_EQ(mul_tn(a, b), naive_mul(a.transpose(), b));
+	ASSERT_EQ(mul_nt(d, c), naive_mul(d, c.transpose()));
+	ASSERT_EQ(mul_tt(a, c), naive_mul(a.transpose(), c.transpose()));
+  }
+}
+
+TEST(FTGemm, TransposedOperandsParallel) {
+  const scoped_num_threads threads(3);
+
+  matrix<double> a = integer_matrix<double>(150, 170, 5);
+  matrix<double> b = integer_matrix<double>(190, 150, 6);
+  matrix<double> tt = mul_tt(a, b);
+
+  ASSERT_EQ(tt, naive_mul(a.transpose(), b.transpose()));
+}
+
+TEST(FTGemm, TransposedOperandsMixedTypes) {
+  matrix<double> lhs(2, 3, {1, 2, 3, 4, 5, 6});
+  matrix<int> rhs(2, 2, {1, 0, 0, 2});
+
+  ASSERT_EQ(mul_tn(lhs, rhs), matrix<double>(3, 2, {1, 8, 2, 10, 3, 12}));
+  ASSERT_ANY_THROW(mul_nt(lhs, rhs));
+}
+
+TEST(FTGemm, AlphaBetaAccumulation) {
+  matrix<int> a = integer_matrix<int>(70, 90, 1);
+  matrix<int> b = integer_matrix<int>(90, 50, 2);
+  matrix<int> c = integer_matrix<int>(70, 50, 3);
+  const matrix<int> product = naive_mul(a, b);
+
+  matrix<int> accumulated(c);
+  gemm(1, a, b, 1, accumulated);
+  ASSERT_EQ(accumulated, c + product);
+
+  matrix<int> scaled(c);
+  gemm(3, a, b, -2, scaled);
+  ASSERT_EQ(scaled, product * 3 + c * -2);
+
+  matrix<int> overwritten(c);
+  gemm(2, a, b, 0, overwritten);
+  ASSERT_EQ(overwritten, product * 2);
+}
+
+TEST(FTGemm, AlphaBetaFloatingParallel) {
+  const scoped_num_threads threads(4);
+
+  matrix<float> a = integer_matrix<float>(160, 150, 4);
+  matrix<float> b = integer_matrix<float>(150, 170, 5);
+  matrix<float> c(160, 170, std::numeric_limits<float>::quiet_NaN());
+  gemm(0.5, a, b, 0.0, c);
+
+  ASSERT_EQ(c, naive_mul(a, b) * 0.5f);
+}
+
+TEST(FTGemm, AlphaBetaExceptions) {
+  matrix<double> a(3, 4), b(4, 5), c(3, 5), wrong(5, 3), square(4, 4);
+
+  ASSERT_NO_THROW(gemm(1, a, b, 1, c));
+  ASSERT_ANY_THROW(gemm(1, a, wrong, 1, c));
+  ASSERT_ANY_THROW(gemm(1, a, b, 1, wrong));
+  ASSERT_ANY_THROW(gemm(1, square, square, 1, square));
+
+  // Borrowed matrices in one buffer overlap without sharing data()
+  std::vector<double> buffer(40, 1.0);
+  matrix<double> lhs = matrix<double>::borrow(buffer.data(), 4, 4);
+  matrix<double> overlapping = matrix<double>::borrow(buffer.data() + 8, 4, 4);
+  matrix<double> disjoint = matrix<double>::borrow(buffer.data() + 24, 4, 4);
+  ASSERT_ANY_THROW(gemm(1.0, lhs, square, 0.0, overlapping));
+  ASSERT_ANY_THROW(gemm(1.0, square, overlapping, 0.0, lhs));
+  ASSERT_NO_THROW(gemm(1.0, lhs, overlapping, 0.0, disjoint));
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <mtlt/matrix.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+namespace {
+
+template<typename T>
+std::vector<T> integer_vector(std::size_t size, int seed) {
+  return integer_matrix<T>(1, size, seed).to_vector();
+}
+
+template<typename T>
+std::vector<T> naive_gemv(const matrix<T> &lhs, const std::vector<T> &rhs) {
+  std::vector<T> result(lhs.rows());
+  for (std::size_t row = 0; row != lhs.rows(); ++row)
+	for (std::size_t col = 0; col != lhs.cols(); ++col)
+	  result[row] += lhs(row, col) * rhs[col];
+  return result;
+}
+
+template<typename T>
+std::vector<T> naive_gevm(const std::vector<T> &lhs, const matrix<T> &rhs) {
+  std::vector<T> result(rhs.cols());
+  for (std::size_t row = 0; row != rhs.rows(); ++row)
+	for (std::size_t col = 0; col != rhs.cols(); ++col)
+	  result[col] += lhs[row] * rhs(row, col);
+  return result;
+}
+
+} // namespace
+
+TEST(FTGemv, MatrixByVector) {
+  const std::size_t sizes[][2] = {{1, 1}, {3, 5}, {4, 16}, {17, 33}, {130, 257}};
+
+  for (const auto &size : sizes) {
+	matrix<int> a = integer_matrix<int>(size[0], size[1], 1);
+	matrix<double> b = integer_matrix<double>(size[0], size[1], 2);
+	matrix<float> c = integer_matrix<float>(size[0], size[1], 3);
+	matrix<long long> d = integer_matrix<long long>(size[0], size[1], 4);
+
+	ASSERT_EQ(a * integer_vector<int>(size[1], 5), naive_gemv(a, integer_vector<int>(size[1], 5)));
+	ASSERT_EQ(b * integer_vector<double>(size[1], 6), naive_gemv(b, integer_vector<double>(size[1], 6)));
+	ASSERT_EQ(c * integer_vector<float>(size[1], 7), naive_gemv(c, integer_vector<float>(size[1], 7)));
+	ASSERT_EQ(d * integer_vector<long long>(size[1], 8), naive_gemv(d, integer_vector<long long>(size[1], 8)));
+  }
+}
+
+TEST(FTGemv, VectorByMatrix) {
+  const std::size_t sizes[][2] = {{1, 1}, {3, 5}, {4, 16}, {17, 33}, {130, 257}};
+
+  for (const auto &size : sizes) {
+	matrix<int> a = integer_matrix<int>(size[0], size[1], 1);
+	matrix<double> b = integer_matrix<double>(size[0], size[1], 2);
+
+	ASSERT_EQ(integer_vector<int>(size[0], 3) * a, naive_gevm(integer_vector<int>(size[0], 3), a));
+	ASSERT_EQ(integer_vector<double>(size[0], 4) * b, naive_gevm(integer_vector<double>(size[0], 4), b));
+  }
+}
+
+TEST(FTGemv, EverySimdLevel) {
+  const simd_level detected = detected_simd_level();
+
+  matrix<float> a = integer_matrix<float>(37, 71, 1);
+  std::vector<float> x = integer_vector<float>(71, 2);
+  std::vector<float> y = integer_vector<float>(37, 3);
+
+  for (int level = 0; level <= static_cast<int>(detected); ++level) {
+	set_simd_level(static_cast<simd_level>(level));
+
+	ASSERT_EQ(a * x, naive_gemv(a, x));
+	ASSERT_EQ(y * a, naive_gevm(y, a));
+  }
+
+  set_simd_level(detected);
+}
+
+TEST(FTGemv, ParallelTallAndWide) {
+  const scoped_num_threads threads(4);
+
+  matrix<double> tall = integer_matrix<double>(3001, 97, 1);
+  matrix<double> wide = integer_matrix<double>(97, 3001, 2);
+  std::vector<double> x = integer_vector<double>(97, 3);
+
+  std::vector<double> tall_result = tall * x;
+  std::vector<double> wide_result = x * wide;
+
+  ASSERT_EQ(tall_result, naive_gemv(tall, x));
+  ASSERT_EQ(wide_result, naive_gevm(x, wide));
+}
+
+TEST(FTGemv, AlphaBeta) {
+  matrix<int> a = integer_matrix<int>(9, 13, 1);
+  std::vector<int> x = integer_vector<int>(13, 2);
+  std::vector<int> y = integer_vector<int>(9, 3);
+  std::vector<int> expected = naive_gemv(a, x);
+
+  std::vector<int> result(y);
+  gemv(2, a, x.data(), -1, result.data());
+  for (std::size_t i = 0; i != y.size(); ++i)
+	ASSERT_EQ(result[i], 2 * expected[i] - y[i]);
+
+  gemv(1, a, x.data(), 0, result.data());
+  ASSERT_EQ(result, expected);
+}
+
+TEST(FTGemv, Exceptions) {
+  matrix<double> a(3, 4);
+  ASSERT_ANY_THROW(a * std::vector<double>(3));
+  ASSERT_ANY_THROW(std::vector<double>(4) * a);
+  ASSERT_NO_THROW(a * std::vector<double>(4));
+  ASSERT_NO_THROW(std::vector<double>(3) * a);
+}
+
+#if __cplusplus > 201703L
+TEST(FTGemv, Span) {
+  matrix<double> a = integer_matrix<double>(5, 7, 1);
+  std::vector<double> x = integer_vector<double>(7, 2);
+  std::vector<double> y = integer_vector<double>(5, 3);
+
+  ASSERT_EQ(a * std::span<const double>(x), naive_gemv(a, x));
+  ASSERT_EQ(std::span<double>(y) * a, naive_gevm(y, a));
+}
+#endif
@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_krylov.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+namespace {
+
+// 5-point Laplacian on a side x side grid, never stored as a matrix
+struct laplacian {
+  std::size_t side;
+
+  void operator()(const double *x, double *y) const {
+	for (std::size_t row = 0; row != side; ++row) {
+	  for (std::size_t col = 0; col != side; ++col) {
+		const std::size_t i = row * side + col;
+		double sum = 4 * x[i];
+		if (row != 0) sum -= x[i - side];
+		if (row + 1 != side) sum -= x[i + side];
+		if (col != 0) sum -= x[i - 1];
+		if (col + 1 != side) sum -= x[i + 1];
+		y[i] = sum;
+	  }
+	}
+  }
+};
+
+matrix<double> laplacian_matrix(std::size_t side) {
+  const std::size_t n = side * side;
+  matrix<double> a(n, n);
+  std::vector<double> unit(n), column(n);
+  for (std::size_t col = 0; col != n; ++col) {
+	unit[col] = 1;
+	laplacian{side}(unit.data(), column.data());
+	unit[col] = 0;
+	for (std::size_t row = 0; row != n; ++row)
+	  a(row, col) = column[row];
+  }
+  return a;
+}
+
+// Upwinded convection-diffusion in 1D, nonsymmetric
+matrix<double> convection_matrix(std::size_t n) {
+  matrix<double> a(n, n);
+  for (std::size_t i = 0; i != n; ++i) {
+	a(i, i) = 3;
+	if (i != 0) a(i, i - 1) = -2;
+	if (i + 1 != n) a(i, i + 1) = -0.5;
+  }
+  return a;
+}
+
+double relative_residual(const matrix<double> &a, const std::vector<double> &b, const std::vector<double> &x) {
+  std::vector<double> ax = a * x;
+  double residual = 0, norm = 0;
+  for (std::size_t i = 0; i != b.size(); ++i) {
+	residual += (b[i] - ax[i]) * (b[i] - ax[i]);
+	norm += b[i] * b[i];
+  }
+  return std::sqrt(residual / norm);
+}
+
+} // namespace
+
+TEST(FTKrylov, ConjugateGradientMatrix) {
+  matrix<double> a = laplacian_matrix(12);
+  std::vector<double> b = random_vector(a.rows(), 1), x;
+
+  krylov_options<double> options;
+  options.tolerance = 1e-10;
+  krylov_stats<double> stats = cg(a, b, x, options);
+
+  ASSERT_TRUE(stats.converged);
+  ASSERT_LE(stats.residual, 1e-10);
+  ASSERT_EQ(stats.history.size(), stats.iterations + 1);
+  ASSERT_DOUBLE_EQ(stats.history.front(), 1.0);
+  ASSERT_LT(relative_residual(a, b, x), 1e-9);
+}
+
+TEST(FTKrylov, ConjugateGradientCallableOperator) {
+  const std::size_t side = 40;
+  std::vector<double> b = random_vector(side * side, 2), x;
+
+  krylov_options<double> options;
+  options.tolerance = 1e-9;
+  krylov_stats<double> plain = cg(laplacian{side}, b, x, options);
+  ASSERT_TRUE(plain.converged);
+
+  std::vector<double> ax(b.size());
+  laplacian{side}(x.data(), ax.data());
+  for (std::size_t i = 0; i != b.size(); ++i)
+	ASSERT_NEAR(ax[i], b[i], 1e-7);
+
+  // A lambda works as well, the jacobi preconditioner of a constant diagonal changes nothing
+  std::vector<double> y;
+  const laplacian op{side};
+  krylov_stats<double> preconditioned = cg([&op](const double *in, double *out) { op(in, out); }, b, y, options,
+										   jacobi_preconditioner<double>(std::vector<double>(b.size(), 4.0)));
+  ASSERT_TRUE(preconditioned.converged);
+  ASSERT_EQ(preconditioned.iterations, plain.iterations);
+}
+
+TEST(FTKrylov, IncompleteCholesky) {
+  // No fill-in for a tridiagonal matrix, IC(0) is the exact factorization
+  matrix<double> tridiagonal(50, 50);
+  for (std::size_t i = 0; i != 50; ++i) {
+	tridiagonal(i, i) = 2.5;
+	if (i != 0) tridiagonal(i, i - 1) = tridiagonal(i - 1, i) = -1;
+  }
+  incomplete_cholesky<double> exact(tridiagonal);
+  ASSERT_EQ(exact.non_zeros(), 49);
+
+  std::vector<double> b = random_vector(50, 3), x;
+  krylov_stats<double> stats = cg(tridiagonal, b, x, krylov_options<double>(), exact);
+  ASSERT_TRUE(stats.converged);
+  ASSERT_EQ(stats.iterations, 1);
+
+  // On the Laplacian it drops fill-in but still cuts the iterations
+  matrix<double> a = laplacian_matrix(20);
+  std::vector<double> c = random_vector(a.rows(), 4), plain, preconditioned;
+  krylov_stats<double> without = cg(a, c, plain);
+  krylov_stats<double> with = cg(a, c, preconditioned, krylov_options<double>(), incomplete_cholesky<double>(a));
+
+  ASSERT_TRUE(without.converged);
+  ASSERT_TRUE(with.converged);
+  ASSERT_LT(with.iterations * 2, without.iterations);
+  ASSERT_LT(relative_residual(a, c, preconditioned), 1e-7);
+}
+
+TEST(FTKrylov, BiCgStab) {
+  matrix<double> a = convection_matrix(200);
+  std::vector<double> b = random_vector(200, 5), x;
+
+  krylov_options<double> options;
+  options.tolerance = 1e-10;
+  krylov_stats<double> stats = bicgstab(a, b, x, options);
+  ASSERT_TRUE(stats.converged);
+  ASSERT_LT(relative_residual(a, b, x), 1e-9);
+
+  std::vector<double> y;
+  krylov_stats<double> preconditioned = bicgstab(a, b, y, options, jacobi_preconditioner<double>(a));
+  ASSERT_TRUE(preconditioned.converged);
+  ASSERT_LT(relative_residual(a, b, y), 1e-9);
+}
+
+TEST(FTKrylov, Gmres) {
+  matrix<double> a = convection_matrix(300);
+  std::vector<double> b = random_vector(300, 6), x;
+
+  krylov_options<double> options;
+  options.tolerance = 1e-10;
+  options.restart = 20;
+  options.max_iterations = 5000;
+  krylov_stats<double> stats = gmres(a, b, x, options);
+
+  ASSERT_TRUE(stats.converged);
+  ASSERT_LT(relative_residual(a, b, x), 1e-9);
+  for (std::size_t i = 1; i != stats.history.size(); ++i)
+	ASSERT_LE(stats.history[i], stats.history[i - 1] * (1 + 1e-12));
+
+  // Without restarts GMRES terminates in at most n steps
+  matrix<double> small = convection_matrix(15);
+  std::vector<double> c = random_vector(15, 7), y;
+  options.restart = 15;
+  krylov_stats<double> full = gmres(small, c, y, options, jacobi_preconditioner<double>(small));
+  ASSERT_TRUE(full.converged);
+  ASSERT_LE(full.iterations, 15);
+}
+
+TEST(FTKrylov, WorkspaceReuse) {
+  matrix<double> a = convection_matrix(100);
+  krylov_workspace<double> workspace;
+  krylov_options<double> options;
+  options.restart = 10;
+  options.max_iterations = 2000;
+
+  std::vector<double> x;
+  gmres(a, random_vector(100, 1), x, options, jacobi_preconditioner<double>(a), workspace);
+  const std::size_t size = workspace.size();
+  const double *data = workspace.reserve(0);
+
+  for (int seed = 2; seed != 6; ++seed) {
+	std::vector<double> b = random_vector(100, seed), y;
+	ASSERT_TRUE(gmres(a, b, y, options, jacobi_preconditioner<double>(a), workspace).converged);
+	ASSERT_TRUE(bicgstab(a, b, y, options, jacobi_preconditioner<double>(a), workspace).converged);
+	ASSERT_EQ(workspace.size(), size);
+	ASSERT_EQ(workspace.reserve(0), data);
+  }
+}
+
+TEST(FTKrylov, InitialGuessAndZeroRhs) {
+  matrix<double> a = laplacian_matrix(6);
+  std::vector<double> b = random_vector(36, 8), x;
+  cg(a, b, x);
+
+  // The solution as the initial guess converges at once
+  std::vector<double> guess(x);
+  krylov_stats<double> stats = cg(a, b, guess);
+  ASSERT_TRUE(stats.converged);
+  ASSERT_LE(stats.iterations, 1);
+
+  std::vector<double> zero(36), y(36, 1.0);
+  stats = gmres(a, zero, y);
+  ASSERT_TRUE(stats.converged);
+  ASSERT_EQ(stats.iterations, 0);
+  ASSERT_EQ(y, zero);
+}
+
+TEST(FTKrylov, Float) {
+  matrix<float> a(3, 3, {4, 1, 0, 1, 3, 1, 0, 1, 2});
+  std::vector<float> b {1, 1.75f, 3}, x;
+
+  krylov_stats<float> stats = cg(a, b, x);
+  ASSERT_TRUE(stats.converged);
+  ASSERT_NEAR(x[0], 0.25f, 1e-3f);
+  ASSERT_NEAR(x[1], 0.0f, 1e-3f);
+  ASSERT_NEAR(x[2], 1.5f, 1e-3f);
+}
+
+TEST(FTKrylov, Exceptions) {
+  matrix<double> a = laplacian_matrix(3), rectangle(9, 8);
+  std::vector<double> b(9, 1.0), wrong(4), x;
+  krylov_options<double> options;
+
+  ASSERT_ANY_THROW(cg(rectangle, b, x));
+  ASSERT_ANY_THROW(cg(a, wrong, x));
+  ASSERT_ANY_THROW(cg(a, b, wrong));
+
+  options.restart = 0;
+  ASSERT_ANY_THROW(gmres(a, b, x, options));
+
+  matrix<double> indefinite(2, 2, {1, 2, 2, 1});
+  ASSERT_ANY_THROW(incomplete_cholesky<double>{indefinite});
+  ASSERT_ANY_THROW(jacobi_preconditioner<double>(matrix<double>(2, 2, {0, 1, 1, 0})));
+  ASSERT_ANY_THROW(jacobi_preconditioner<double>{rectangle});
+}
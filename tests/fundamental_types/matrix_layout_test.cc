@@ -0,0 +1,279 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+#include <iostream>
+#include <numeric>
+#include <algorithm>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_lu.h>
+#include <mtlt/matrix_qr.h>
+#include <mtlt/matrix_svd.h>
+#include <mtlt/matrix_eigen.h>
+#include <mtlt/matrix_solve.h>
+#include <mtlt/matrix_krylov.h>
+#include <mtlt/matrix_cholesky.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+namespace {
+
+template<typename T, typename Layout>
+using layout_matrix = matrix<T, default_allocator<T>, Layout>;
+
+template<typename Layout>
+void expect_bijection(std::size_t rows, std::size_t cols) {
+  std::vector<bool> used(rows * cols, false);
+
+  for (std::size_t row = 0; row != rows; ++row)
+	for (std::size_t col = 0; col != cols; ++col) {
+	  const std::size_t index = Layout::index(row, col, rows, cols);
+	  ASSERT_LT(index, rows * cols);
+	  ASSERT_FALSE(used[index]);
+	  used[index] = true;
+	}
+}
+
+template<typename Layout>
+void expect_products(const matrix<long long> &a, const matrix<long long> &b) {
+  const layout_matrix<long long, Layout> la(a), lb(b);
+  const matrix<long long> expected = a * b;
+
+  ASSERT_EQ(matrix<long long>(la * lb), expected);
+  ASSERT_EQ(matrix<long long>(la * b), expected);
+  ASSERT_EQ(a * lb, expected);
+  ASSERT_EQ(matrix<long long>(mul_tn(layout_matrix<long long, Layout>(a.transpose()), lb)), expected);
+  ASSERT_EQ(matrix<long long>(mul_nt(la, layout_matrix<long long, Layout>(b.transpose()))), expected);
+
+  layout_matrix<long long, Layout> c(a.rows(), b.cols(), 1);
+  gemm(2LL, la, b, 1LL, c);
+  ASSERT_EQ(matrix<long long>(c), expected * 2LL + 1LL);
+
+  std::vector<long long> x(b.cols(), 2), y(a.rows(), -1);
+  ASSERT_EQ(lb * x, b * x);
+  ASSERT_EQ(y * la, y * a);
+}
+
+template<typename Layout>
+double product_seconds(const matrix<double> &a, const matrix<double> &b) {
+  const layout_matrix<double, Layout> la(a), lb(b);
+  double best = 1e9;
+
+  for (int run = 0; run != 3; ++run) {
+	const auto start = std::chrono::steady_clock::now();
+	const layout_matrix<double, Layout> c = la * lb;
+	best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	EXPECT_EQ(c.rows(), a.rows());
+  }
+
+  return best;
+}
+
+} // namespace
+
+TEST(FTLayout, IndexIsBijection) {
+  const std::size_t sizes[][2] = {{1, 1}, {1, 7}, {7, 1}, {2, 3}, {5, 5}, {8, 8}, {13, 6}, {33, 70}, {64, 17}};
+
+  for (const auto &size : sizes) {
+	expect_bijection<row_major>(size[0], size[1]);
+	expect_bijection<column_major>(size[0], size[1]);
+	expect_bijection<tiled<4>>(size[0], size[1]);
+	expect_bijection<tiled<5>>(size[0], size[1]);
+	expect_bijection<tiled<>>(size[0], size[1]);
+	expect_bijection<morton>(size[0], size[1]);
+  }
+}
+
+TEST(FTLayout, StorageOrder) {
+  layout_matrix<int, column_major> columns(2, 3, {1, 2, 3, 4, 5, 6});
+  ASSERT_EQ(std::vector<int>(columns.data(), columns.data() + 6), std::vector<int>({1, 4, 2, 5, 3, 6}));
+  ASSERT_EQ(columns(1, 0), 4);
+  ASSERT_EQ(columns.to_vector(), std::vector<int>({1, 2, 3, 4, 5, 6}));
+
+  layout_matrix<int, tiled<2>> tiles(3, 3, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  ASSERT_EQ(std::vector<int>(tiles.data(), tiles.data() + 9), std::vector<int>({1, 2, 4, 5, 3, 6, 7, 8, 9}));
+
+  layout_matrix<int, morton> z(4, 4);
+  std::iota(z.begin(), z.end(), 0);
+  ASSERT_EQ(std::vector<int>(z.data(), z.data() + 4), std::vector<int>({0, 1, 4, 5}));
+  ASSERT_EQ(z.data()[15], 15);
+  ASSERT_EQ(z(2, 1), 9);
+}
+
+TEST(FTLayout, Iterators) {
+  layout_matrix<int, morton> m(3, 5);
+  std::iota(m.begin(), m.end(), 0);
+
+  ASSERT_EQ(m.end() - m.begin(), 15);
+  ASSERT_EQ(m(2, 4), 14);
+  ASSERT_EQ(m.begin()[7], 7);
+  ASSERT_EQ(*m.rbegin(), 14);
+  ASSERT_EQ(*std::prev(m.rend()), 0);
+  ASSERT_EQ(std::vector<int>(m.cbegin(), m.cend()), matrix<int>(m).to_vector());
+
+  std::reverse(m.begin(), m.end());
+  ASSERT_EQ(m(0, 0), 14);
+  std::sort(m.begin(), m.end());
+  ASSERT_EQ(m(1, 2), 7);
+  ASSERT_EQ(m.sum(), 105);
+}
+
+TEST(FTLayout, Conversion) {
+  const matrix<long long> a = integer_matrix<long long>(45, 70, 1);
+
+  layout_matrix<long long, column_major> columns(a);
+  layout_matrix<long long, tiled<8>> tiles(columns);
+  layout_matrix<long long, morton> z(tiles);
+  matrix<long long> back(z);
+
+  ASSERT_EQ(back, a);
+  ASSERT_EQ(columns.to_vector(), a.to_vector());
+  ASSERT_EQ(matrix<long long>(tiles.transpose()), a.transpose());
+  ASSERT_EQ(matrix<long long>(z.transpose()), a.transpose());
+  ASSERT_EQ(std::vector<long long>(z.begin(), z.end()), a.to_vector());
+  ASSERT_EQ(matrix<double>(columns.convert_to<double>()), a.convert_to<double>());
+}
+
+TEST(FTLayout, CompareAcrossLayouts) {
+  const matrix<long long> a = integer_matrix<long long>(5, 7, 3);
+  const layout_matrix<long long, column_major> columns(a);
+  const matrix<long long, std::allocator<long long>, morton> z_order(a);
+
+  ASSERT_TRUE(a == columns);
+  ASSERT_TRUE(columns == z_order);
+  ASSERT_FALSE(a != z_order);
+
+  layout_matrix<long long, tiled<4>> changed(a);
+  changed(4, 6) += 1;
+  ASSERT_TRUE(a != changed);
+  ASSERT_FALSE(changed == columns);
+  ASSERT_TRUE(a != matrix<long long>(7, 5));
+}
+
+TEST(FTLayout, ItemOperations) {
+  const matrix<long long> a = integer_matrix<long long>(9, 7, 2), b = integer_matrix<long long>(9, 7, 3);
+  layout_matrix<long long, column_major> columns(a);
+  layout_matrix<long long, morton> z(b);
+
+  ASSERT_EQ(matrix<long long>(columns + z), a + b);
+  ASSERT_EQ(matrix<long long>(z - columns), b - a);
+  ASSERT_EQ(matrix<long long>(columns + columns), a * 2LL);
+  ASSERT_EQ(matrix<long long>(z * 3LL + 1LL), b * 3LL + 1LL);
+  ASSERT_EQ(columns.sum(), a.sum());
+
+  matrix<long long> expected(a);
+  expected.swap_rows(1, 8);
+  expected.swap_cols(0, 6);
+  columns.swap_rows(1, 8);
+  columns.swap_cols(0, 6);
+  ASSERT_EQ(matrix<long long>(columns), expected);
+
+  z.resize(12, 4);
+  matrix<long long> resized(b);
+  resized.resize(12, 4);
+  ASSERT_EQ(matrix<long long>(z), resized);
+
+  const layout_matrix<long long, tiled<4>> tiles_a(a), tiles_b(b);
+  ASSERT_TRUE(tiles_a == tiles_a.transpose().transpose());
+  ASSERT_FALSE(tiles_a == tiles_b);
+}
+
+TEST(FTLayout, Products) {
+  const std::size_t sizes[][3] = {{1, 1, 1}, {3, 5, 7}, {40, 33, 50}, {67, 129, 45}, {150, 140, 130}};
+
+  for (const auto &size : sizes) {
+	const matrix<long long> a = integer_matrix<long long>(size[0], size[1], 3);
+	const matrix<long long> b = integer_matrix<long long>(size[1], size[2], 5);
+
+	expect_products<column_major>(a, b);
+	expect_products<tiled<8>>(a, b);
+	expect_products<morton>(a, b);
+  }
+
+  // The copies of the operands of other layouts hold bool items too
+  const matrix<bool> ones(9, 9, true);
+  const layout_matrix<bool, tiled<8>> tiles(ones);
+  ASSERT_TRUE(matrix<bool>(tiles * tiles) == ones);
+}
+
+TEST(FTLayout, ProductTimeCloseToRowMajor) {
+  const scoped_num_threads threads(1);
+  matrix<double> a(400, 400), b(400, 400);
+  a.fill_random(-1.0, 1.0);
+  b.fill_random(-1.0, 1.0);
+
+  // The other layouts are converted once, so the product costs about as much as the row major one
+  const double row_major_seconds = product_seconds<row_major>(a, b);
+  const double tiled_seconds = product_seconds<tiled<32>>(a, b);
+  const double morton_seconds = product_seconds<morton>(a, b);
+  std::cout << "row major " << row_major_seconds << " s, tiled " << tiled_seconds
+			<< " s, morton " << morton_seconds << " s" << std::endl;
+
+  ASSERT_LT(tiled_seconds, 3 * row_major_seconds + 0.005);
+  ASSERT_LT(morton_seconds, 3 * row_major_seconds + 0.005);
+}
+
+TEST(FTLayout, MixedGemm) {
+  matrix<double> a(100, 80), b(80, 90);
+  a.fill_random(-1.0, 1.0);
+  b.fill_random(-1.0, 1.0);
+
+  layout_matrix<double, column_major> columns(b), c(100, 90);
+  gemm(1.0, a, columns, 0.0, c);
+
+  const matrix<double> expected = a * b;
+  for (std::size_t row = 0; row != c.rows(); ++row)
+	for (std::size_t col = 0; col != c.cols(); ++col)
+	  ASSERT_NEAR(c(row, col), expected(row, col), 1e-12);
+}
+
+TEST(FTLayout, Decompositions) {
+  matrix<double> a(4, 4, {4, 3, 2, 1, 3, 5, 1, 2, 2, 1, 6, 3, 1, 2, 3, 7});
+  layout_matrix<double, column_major> columns(a);
+
+  ASSERT_NEAR(columns.determinant_gaussian(), a.determinant_gaussian(), 1e-9);
+
+  const matrix<double> inverse(columns.inverse());
+  const matrix<double> expected = a.inverse();
+  for (std::size_t row = 0; row != 4; ++row)
+	for (std::size_t col = 0; col != 4; ++col)
+	  ASSERT_NEAR(inverse(row, col), expected(row, col), 1e-12);
+
+  layout_matrix<long long, morton> integral(integer_matrix<long long>(6, 6, 4));
+  ASSERT_EQ(integral.determinant_bareiss(), matrix<long long>(integral).determinant_bareiss());
+}
+
+TEST(FTLayout, FactorizationsAndSolvers) {
+  const matrix<double> a = random_matrix(30, 30, 8) + matrix<double>::identity(30, 30) * 30.0;
+  const matrix<double> spd = mul_tn(a, a);
+  const matrix<double> tall = random_matrix(40, 12, 9), b = random_matrix(30, 3, 10);
+  const std::vector<double> y = random_vector(30, 11);
+
+  const layout_matrix<double, column_major> columns(a), spd_columns(spd), tall_columns(tall), b_columns(b);
+  const matrix<double, std::allocator<double>> standard(a), spd_standard(spd);
+
+  expect_near(solve(columns, b_columns), solve(a, b), 1e-12);
+  expect_near(solve(standard, b), solve(a, b), 1e-12);
+  ASSERT_EQ(solve(columns, y), solve(a, y));
+  expect_near(lu<double>(columns).inverse(), lu<double>(a).inverse(), 1e-12);
+  ASSERT_EQ(slogdet(standard).log_abs, slogdet(a).log_abs);
+
+  expect_near(cholesky<double>(spd_columns).lower(), cholesky<double>(spd).lower(), 1e-12);
+  expect_near(solve_spd(spd_standard, b_columns), solve_spd(spd, b), 1e-12);
+  expect_near(lstsq(tall_columns, random_matrix(40, 2, 12)), lstsq(tall, random_matrix(40, 2, 12)), 1e-12);
+
+  ASSERT_EQ(eigvalsh(spd_columns), eigvalsh(spd));
+  ASSERT_EQ(eigh(spd_standard, 3).values, eigh(spd, 3).values);
+  ASSERT_EQ(svd(tall_columns).s, svd(tall).s);
+  ASSERT_EQ(randomized_svd(tall_columns, 4).s.size(), 4);
+
+  std::vector<double> x(30), expected(30);
+  cg(spd_columns, y, x, krylov_options<double>(), jacobi_preconditioner<double>(spd_columns));
+  cg(spd, y, expected, krylov_options<double>(), incomplete_cholesky<double>(spd_standard));
+  for (std::size_t i = 0; i != x.size(); ++i)
+	ASSERT_NEAR(x[i], expected[i], 1e-6);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_lu.h>
+#include <mtlt/static_matrix.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+TEST(FTLu, FactorsReproduceMatrix) {
+  matrix<double> a = random_matrix(150, 150, 1);
+  lu<double> factorization(a);
+
+  matrix<double> permuted(a);
+  for (std::size_t i = 0; i != a.rows(); ++i)
+	permuted.swap_rows(i, factorization.pivots()[i]);
+
+  ASSERT_FALSE(factorization.singular());
+  expect_near(factorization.lower() * factorization.upper(), permuted, 1e-9);
+}
+
+TEST(FTLu, SolveAndInverse) {
+  matrix<double> a = random_matrix(130, 130, 2);
+  matrix<double> b = random_matrix(130, 7, 3);
+  lu<double> factorization(a);
+
+  expect_near(a * factorization.solve(b), b, 1e-8);
+  expect_near(a * factorization.inverse(), matrix<double>::identity(130, 130), 1e-8);
+
+  std::vector<double> column(130, 1.0);
+  std::vector<double> x = factorization.solve(column);
+  std::vector<double> product = a * x;
+  for (double item : product)
+	ASSERT_NEAR(item, 1.0, 1e-8);
+}
+
+TEST(FTLu, Determinant) {
+  matrix<int> a(3, 3, {2, 5, 0, 0, 9, 7, 8, 1, 3});
+  ASSERT_NEAR(lu<double>(a).determinant(), 320.0, 1e-9);
+  ASSERT_NEAR(lu<float>(a).determinant(), 320.0f, 1e-3f);
+
+  matrix<double> diagonal = matrix<double>::identity(100, 100);
+  diagonal(3, 3) = 2, diagonal(50, 50) = -3;
+  diagonal.swap_rows(0, 99);
+  ASSERT_DOUBLE_EQ(lu<double>(diagonal).determinant(), 6.0);
+  ASSERT_DOUBLE_EQ(diagonal.determinant_gaussian(), 6.0);
+}
+
+TEST(FTLu, Slogdet) {
+  matrix<double> a(3, 3, {2, 5, 0, 0, 9, 7, 8, 1, 3});
+  slogdet_result<double> det = slogdet(a);
+  ASSERT_EQ(det.sign, 1.0);
+  ASSERT_NEAR(det.log_abs, std::log(320.0), 1e-12);
+
+  a.swap_rows(0, 2);
+  det = lu<double>(a).slogdet();
+  ASSERT_EQ(det.sign, -1.0);
+  ASSERT_NEAR(det.log_abs, std::log(320.0), 1e-12);
+
+  // det = -10^400 and 0.01^400 are out of the double range
+  matrix<double> large = random_matrix(400, 400, 3);
+  matrix<double> tiny(large);
+  for (std::size_t row = 0; row != 400; ++row) {
+	for (std::size_t col = 0; col < row; ++col)
+	  large(row, col) = tiny(row, col) = 0;
+	large(row, row) = 10;
+	tiny(row, row) = 0.01;
+  }
+  large.swap_rows(5, 7);
+
+  ASSERT_TRUE(std::isinf(lu<double>(large).determinant()));
+  det = slogdet(large);
+  ASSERT_EQ(det.sign, -1.0);
+  ASSERT_NEAR(det.log_abs, 400 * std::log(10.0), 1e-9);
+
+  ASSERT_EQ(lu<double>(tiny).determinant(), 0.0);
+  det = slogdet(tiny);
+  ASSERT_EQ(det.sign, 1.0);
+  ASSERT_NEAR(det.log_abs, 400 * std::log(0.01), 1e-9);
+
+  slogdet_result<float> single = slogdet(matrix<float>(2, 2, {0, 2, 3, 0}));
+  ASSERT_EQ(single.sign, -1.0f);
+  ASSERT_NEAR(single.log_abs, std::log(6.0f), 1e-6f);
+}
+
+TEST(FTLu, Singular) {
+  matrix<int> a(3, 3, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  matrix<double> zero_column(80, 80, 1.0);
+  for (std::size_t row = 0; row != 80; ++row)
+	zero_column(row, 40) = 0;
+
+  lu<double> factorization(zero_column);
+  ASSERT_TRUE(factorization.singular());
+  ASSERT_EQ(factorization.determinant(), 0.0);
+  ASSERT_EQ(factorization.slogdet().sign, 0.0);
+  ASSERT_TRUE(std::isinf(factorization.slogdet().log_abs));
+  ASSERT_ANY_THROW(static_cast<void>(factorization.solve(zero_column)));
+  ASSERT_ANY_THROW(static_cast<void>(factorization.inverse()));
+  ASSERT_ANY_THROW(lu<double>(matrix<double>(3, 4)));
+  ASSERT_NEAR(a.determinant_gaussian(), 0.0, 1e-9);
+}
+
+TEST(FTLu, MatrixInverseUsesFactorization) {
+  matrix<double> a = random_matrix(200, 200, 4);
+  expect_near(a * a.inverse(), matrix<double>::identity(200, 200), 1e-8);
+  expect_near(a.inverse(a.determinant_gaussian()), lu<double>(a).inverse(), 1e-12);
+  ASSERT_NEAR(a.determinant_gaussian(), lu<double>(a).determinant(), std::fabs(a.determinant_gaussian()) * 1e-12);
+
+  // A small determinant alone doesn't make a matrix singular
+  matrix<double> half = 0.5 * matrix<double>::identity(30, 30);
+  matrix<double> tiny = 0.001 * matrix<double>::identity(3, 3);
+  expect_near(half.inverse(), 2.0 * matrix<double>::identity(30, 30), 1e-12);
+  expect_near(tiny.inverse(), lu<double>(tiny).inverse(), 1e-12);
+
+  matrix<double> singular(3, 3, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  ASSERT_ANY_THROW(static_cast<void>(singular.inverse()));
+  ASSERT_ANY_THROW(static_cast<void>(lu<double>(singular).inverse()));
+}
+
+TEST(FTLu, StaticMatrixInverse) {
+  static_matrix<double, 4, 4> a({4, 1, 0, 2,
+								 1, 5, 1, 0,
+								 0, 3, 6, 1,
+								 2, 0, 1, 7});
+  static_matrix<double, 4, 4> product = a * a.inverse();
+
+  for (std::size_t row = 0; row != 4; ++row)
+	for (std::size_t col = 0; col != 4; ++col)
+	  ASSERT_NEAR(product(row, col), row == col ? 1.0 : 0.0, 1e-12);
+
+  // The determinant 1e-9 is small, but the pivots are not next to the largest item
+  static_matrix<double, 3, 3> tiny({0.001, 0, 0, 0, 0.001, 0, 0, 0, 0.001});
+  static_matrix<double, 3, 3> inverse = tiny.inverse();
+  for (std::size_t row = 0; row != 3; ++row)
+	for (std::size_t col = 0; col != 3; ++col)
+	  ASSERT_NEAR(inverse(row, col), row == col ? 1000.0 : 0.0, 1e-9);
+
+  static_matrix<double, 3, 3> singular({1, 2, 3, 4, 5, 6, 7, 8, 9});
+  ASSERT_ANY_THROW(static_cast<void>(singular.inverse()));
+}
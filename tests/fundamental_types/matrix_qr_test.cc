@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_qr.h>
+#include <mtlt/matrix_cholesky.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+TEST(FTQr, FactorsReproduceMatrix) {
+  const std::size_t sizes[][2] = {{1, 1}, {5, 3}, {3, 5}, {40, 40}, {300, 70}, {150, 150}, {90, 200}};
+
+  for (const auto &size : sizes) {
+	matrix<double> a = random_matrix(size[0], size[1], static_cast<int>(size[0] + size[1]));
+	qr<double> factorization(a);
+
+	const std::size_t k = std::min(size[0], size[1]);
+	matrix<double> q = factorization.thin_q();
+	matrix<double> r = factorization.r();
+
+	ASSERT_EQ(q.rows(), size[0]);
+	ASSERT_EQ(q.cols(), k);
+	ASSERT_EQ(r.rows(), k);
+	expect_near(q * r, a, 1e-10);
+	expect_near(mul_tn(q, q), matrix<double>::identity(k, k), 1e-10);
+
+	for (std::size_t row = 0; row != k; ++row)
+	  for (std::size_t col = 0; col != row; ++col)
+		ASSERT_EQ(r(row, col), 0.0);
+  }
+}
+
+TEST(FTQr, FullQIsOrthogonal) {
+  matrix<double> a = random_matrix(130, 20, 1);
+  qr<double> factorization(a);
+  matrix<double> q = factorization.q();
+
+  expect_near(mul_tn(q, q), matrix<double>::identity(130, 130), 1e-10);
+
+  matrix<double> b = random_matrix(130, 4, 2);
+  matrix<double> applied(b);
+  factorization.apply_qt(applied);
+  expect_near(applied, mul_tn(q, b), 1e-10);
+
+  factorization.apply_q(applied);
+  expect_near(applied, b, 1e-10);
+}
+
+TEST(FTQr, LeastSquaresMatchesNormalEquations) {
+  matrix<double> a = random_matrix(500, 70, 3);
+  matrix<double> b = random_matrix(500, 3, 4);
+
+  matrix<double> x = lstsq(a, b);
+  matrix<double> expected = solve_spd(mul_tn(a, a), mul_tn(a, b));
+  ASSERT_EQ(x.rows(), 70);
+  expect_near(x, expected, 1e-9);
+
+  // The residual is orthogonal to the columns of a
+  expect_near(mul_tn(a, a * x - b), matrix<double>(70, 3), 1e-9);
+
+  std::vector<double> y(500);
+  for (std::size_t i = 0; i != y.size(); ++i)
+	y[i] = b(i, 0);
+
+  std::vector<double> vector_x = lstsq(a, y);
+  ASSERT_EQ(vector_x.size(), 70);
+  for (std::size_t i = 0; i != vector_x.size(); ++i)
+	ASSERT_NEAR(vector_x[i], x(i, 0), 1e-10);
+}
+
+TEST(FTQr, ExactSystemIsSolved) {
+  matrix<double> a(3, 2, {1, 1, 1, 2, 1, 3});
+  std::vector<double> x = lstsq(a, std::vector<double>{3, 5, 7});
+
+  ASSERT_NEAR(x[0], 1.0, 1e-12);
+  ASSERT_NEAR(x[1], 2.0, 1e-12);
+}
+
+TEST(FTQr, IllConditionedColumns) {
+  // Normal equations lose about 16 digits here, QR keeps about 8
+  const double epsilon = 1e-8;
+  matrix<double> a(3, 2, {1, 1, epsilon, 0, 0, epsilon});
+  std::vector<double> x = lstsq(a, std::vector<double>{2, epsilon, epsilon});
+
+  ASSERT_NEAR(x[0], 1.0, 1e-6);
+  ASSERT_NEAR(x[1], 1.0, 1e-6);
+}
+
+TEST(FTQr, ParallelMatchesSequential) {
+  matrix<double> a = random_matrix(700, 150, 5);
+  matrix<double> sequential = qr<double>(a).factors();
+
+  const scoped_num_threads threads(4);
+  matrix<double> parallel = qr<double>(a).factors();
+
+  expect_near(parallel, sequential, 1e-12);
+}
+
+TEST(FTQr, Exceptions) {
+  matrix<double> wide(2, 3, {1, 2, 3, 4, 5, 6});
+  ASSERT_ANY_THROW(static_cast<void>(lstsq(wide, std::vector<double>{1, 2})));
+
+  matrix<double> deficient(3, 2, {1, 0, 1, 0, 1, 0});
+  ASSERT_ANY_THROW(static_cast<void>(lstsq(deficient, std::vector<double>{1, 2, 3})));
+
+  matrix<double> a = random_matrix(4, 2, 6);
+  ASSERT_ANY_THROW(static_cast<void>(lstsq(a, std::vector<double>{1, 2})));
+  ASSERT_ANY_THROW(static_cast<void>(lstsq(a, matrix<double>(3, 1))));
+
+  matrix<double> wrong(3, 3);
+  ASSERT_ANY_THROW(qr<double>(a).apply_qt(wrong));
+}
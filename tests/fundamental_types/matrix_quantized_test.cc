@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <mtlt/matrix_quantized.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+namespace {
+
+template<typename T>
+matrix<T> sequence_matrix(std::size_t rows, std::size_t cols, int seed) {
+  matrix<T> m(rows, cols);
+  int value = seed;
+  m.generate([&value]() {
+	value = (value * 73 + 29) % 251;
+	return static_cast<T>(std::is_signed<T>::value ? value - 125 : value);
+  });
+  return m;
+}
+
+template<typename A, typename B>
+matrix<std::int32_t> naive_gemm_s8(const matrix<A> &lhs, const matrix<B> &rhs,
+								   const quantization &lhs_q, const quantization &rhs_q) {
+  matrix<std::int32_t> result(lhs.rows(), rhs.cols());
+  for (std::size_t row = 0; row != lhs.rows(); ++row)
+	for (std::size_t col = 0; col != rhs.cols(); ++col)
+	  for (std::size_t k = 0; k != lhs.cols(); ++k)
+		result(row, col) += (lhs(row, k) - lhs_q.zero_point_at(row)) * (rhs(k, col) - rhs_q.zero_point_at(col));
+  return result;
+}
+
+} // namespace
+
+TEST(FTQuantized, SignedProductDoesNotOverflow) {
+  matrix<std::int8_t> lhs(2, 300, std::int8_t(-128));
+  matrix<std::int8_t> rhs(300, 3, std::int8_t(-128));
+
+  ASSERT_EQ(gemm_s8(lhs, rhs), matrix<std::int32_t>(2, 3, 128 * 128 * 300));
+}
+
+TEST(FTQuantized, MatchesNaive) {
+  const std::size_t sizes[][3] = {{1, 1, 1}, {5, 7, 3}, {33, 65, 17}, {130, 257, 70}};
+
+  quantization none;
+  for (const auto &size : sizes) {
+	matrix<std::uint8_t> lhs = sequence_matrix<std::uint8_t>(size[0], size[1], 1);
+	matrix<std::int8_t> rhs = sequence_matrix<std::int8_t>(size[1], size[2], 2);
+	matrix<std::int8_t> signed_lhs = sequence_matrix<std::int8_t>(size[0], size[1], 3);
+
+	ASSERT_EQ(gemm_s8(lhs, rhs), naive_gemm_s8(lhs, rhs, none, none));
+	ASSERT_EQ(gemm_s8(signed_lhs, rhs), naive_gemm_s8(signed_lhs, rhs, none, none));
+  }
+}
+
+TEST(FTQuantized, ZeroPoints) {
+  matrix<std::uint8_t> lhs = sequence_matrix<std::uint8_t>(67, 131, 4);
+  matrix<std::uint8_t> rhs = sequence_matrix<std::uint8_t>(131, 45, 5);
+
+  quantization lhs_q, rhs_q;
+  lhs_q.zero_point = 128;
+  rhs_q.zero_points.resize(45);
+  for (std::size_t col = 0; col != 45; ++col)
+	rhs_q.zero_points[col] = static_cast<std::int32_t>(col * 5);
+
+  ASSERT_EQ(gemm_s8(lhs, rhs, lhs_q, rhs_q), naive_gemm_s8(lhs, rhs, lhs_q, rhs_q));
+
+  quantization per_row;
+  per_row.zero_points.resize(67);
+  for (std::size_t row = 0; row != 67; ++row)
+	per_row.zero_points[row] = static_cast<std::int32_t>(row) - 30;
+
+  ASSERT_EQ(gemm_s8(lhs, rhs, per_row, rhs_q), naive_gemm_s8(lhs, rhs, per_row, rhs_q));
+}
+
+TEST(FTQuantized, OtherLayouts) {
+  matrix<std::uint8_t> lhs = sequence_matrix<std::uint8_t>(67, 131, 4);
+  matrix<std::int8_t> rhs = sequence_matrix<std::int8_t>(131, 45, 5);
+
+  quantization lhs_q, rhs_q;
+  lhs_q.zero_point = 128;
+  rhs_q.zero_points.resize(45);
+  for (std::size_t col = 0; col != 45; ++col)
+	rhs_q.zero_points[col] = static_cast<std::int32_t>(col) - 20;
+
+  const matrix<std::int32_t> expected = naive_gemm_s8(lhs, rhs, lhs_q, rhs_q);
+  const matrix<std::uint8_t, default_allocator<std::uint8_t>, column_major> lhs_columns(lhs);
+  const matrix<std::int8_t, default_allocator<std::int8_t>, tiled<16>> rhs_tiles(rhs);
+
+  ASSERT_EQ(gemm_s8(lhs_columns, rhs, lhs_q, rhs_q), expected);
+  ASSERT_EQ(gemm_s8(lhs, rhs_tiles, lhs_q, rhs_q), expected);
+  ASSERT_EQ(gemm_s8(lhs_columns, rhs_tiles, lhs_q, rhs_q), expected);
+}
+
+TEST(FTQuantized, ParallelZeroPoints) {
+  const scoped_num_threads threads(4);
+
+  matrix<std::int8_t> lhs = sequence_matrix<std::int8_t>(200, 150, 6);
+  matrix<std::int8_t> rhs = sequence_matrix<std::int8_t>(150, 180, 7);
+  quantization lhs_q, rhs_q;
+  lhs_q.zero_point = -3;
+  rhs_q.zero_points.assign(180, 2);
+
+  matrix<std::int32_t> result = gemm_s8(lhs, rhs, lhs_q, rhs_q);
+
+  ASSERT_EQ(result, naive_gemm_s8(lhs, rhs, lhs_q, rhs_q));
+}
+
+TEST(FTQuantized, Dequantize) {
+  matrix<std::int32_t> accumulators(2, 3, {1, 2, 3, 4, 5, 6});
+  quantization lhs_q, rhs_q;
+  lhs_q.scales = {0.5f, 2.0f};
+  rhs_q.scale = 0.25f;
+
+  ASSERT_EQ(dequantize(accumulators, lhs_q, rhs_q), matrix<float>(2, 3, {0.125f, 0.25f, 0.375f, 2, 2.5f, 3}));
+}
+
+TEST(FTQuantized, Exceptions) {
+  matrix<std::int8_t> lhs(2, 3), rhs(3, 4);
+  quantization wrong;
+  wrong.zero_points = {1, 2, 3};
+
+  ASSERT_ANY_THROW(gemm_s8(lhs, lhs));
+  ASSERT_ANY_THROW(gemm_s8(lhs, rhs, wrong));
+  ASSERT_ANY_THROW(gemm_s8(lhs, rhs, quantization(), wrong));
+  ASSERT_NO_THROW(gemm_s8(lhs, rhs, quantization(), quantization()));
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_semiring.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+namespace {
+
+template<typename Semiring, typename T>
+matrix<T> naive_mul(const matrix<T> &lhs, const matrix<T> &rhs) {
+  matrix<T> result(lhs.rows(), rhs.cols(), Semiring::zero());
+  for (std::size_t row = 0; row != lhs.rows(); ++row)
+	for (std::size_t col = 0; col != rhs.cols(); ++col)
+	  for (std::size_t k = 0; k != lhs.cols(); ++k)
+		result(row, col) = Semiring::add(result(row, col), Semiring::mul(lhs(row, k), rhs(k, col)));
+  return result;
+}
+
+// Every fifth item is the zero of the semiring (no edge)
+template<typename Semiring, typename T>
+matrix<T> random_graph(std::size_t rows, std::size_t cols, int seed) {
+  matrix<T> m(rows, cols);
+  int value = seed;
+  m.generate([&value]() {
+	value = (value * 37 + 11) % 101;
+	return value % 5 == 0 ? Semiring::zero() : static_cast<T>(value % 23 + 1);
+  });
+  return m;
+}
+
+template<typename Semiring, typename T>
+void expect_matches_naive(std::size_t m, std::size_t k, std::size_t n) {
+  matrix<T> lhs = random_graph<Semiring, T>(m, k, 1);
+  matrix<T> rhs = random_graph<Semiring, T>(k, n, 2);
+  ASSERT_EQ(mul<Semiring>(lhs, rhs), (naive_mul<Semiring>(lhs, rhs)));
+}
+
+} // namespace
+
+TEST(FTSemiring, MinPlusTwoEdgePaths) {
+  const int inf = min_plus<int>::zero();
+  matrix<int> dist(3, 3, {0, 4, inf,
+						  inf, 0, 1,
+						  2, inf, 0});
+
+  ASSERT_EQ(mul<min_plus<int>>(dist, dist), matrix<int>(3, 3, {0, 4, 5,
+															   3, 0, 1,
+															   2, 6, 0}));
+}
+
+TEST(FTSemiring, EverySemiringMatchesNaive) {
+  const std::size_t sizes[][3] = {{1, 1, 1}, {5, 7, 3}, {67, 45, 129}, {130, 257, 31}};
+
+  for (const auto &size : sizes) {
+	expect_matches_naive<min_plus<int>, int>(size[0], size[1], size[2]);
+	expect_matches_naive<min_plus<double>, double>(size[0], size[1], size[2]);
+	expect_matches_naive<max_plus<int>, int>(size[0], size[1], size[2]);
+	expect_matches_naive<max_plus<float>, float>(size[0], size[1], size[2]);
+	expect_matches_naive<bottleneck<int>, int>(size[0], size[1], size[2]);
+	expect_matches_naive<bottleneck<double>, double>(size[0], size[1], size[2]);
+	expect_matches_naive<boolean<int>, int>(size[0], size[1], size[2]);
+	expect_matches_naive<boolean<bool>, bool>(size[0], size[1], size[2]);
+	expect_matches_naive<min_plus<long long>, long long>(size[0], size[1], size[2]);
+  }
+}
+
+TEST(FTSemiring, OtherLayouts) {
+  using columns_type = matrix<int, default_allocator<int>, column_major>;
+  using tiles_type = matrix<int, default_allocator<int>, tiled<16>>;
+
+  matrix<int> lhs = random_graph<min_plus<int>, int>(67, 45, 1);
+  matrix<int> rhs = random_graph<min_plus<int>, int>(45, 129, 2);
+  const matrix<int> expected = naive_mul<min_plus<int>>(lhs, rhs);
+
+  ASSERT_EQ(matrix<int>(mul<min_plus<int>>(columns_type(lhs), tiles_type(rhs))), expected);
+  ASSERT_EQ(matrix<int>(mul<min_plus<int>>(tiles_type(lhs), columns_type(rhs))), expected);
+  ASSERT_EQ(mul<min_plus<int>>(lhs, tiles_type(rhs)), expected);
+}
+
+TEST(FTSemiring, EverySimdLevelMatchesNaive) {
+  const simd_level detected = detected_simd_level();
+
+  for (int level = 0; level <= static_cast<int>(detected); ++level) {
+	set_simd_level(static_cast<simd_level>(level));
+
+	expect_matches_naive<min_plus<int>, int>(83, 131, 59);
+	expect_matches_naive<min_plus<float>, float>(83, 131, 59);
+	expect_matches_naive<max_plus<double>, double>(83, 131, 59);
+	expect_matches_naive<bottleneck<int>, int>(83, 131, 59);
+  }
+
+  set_simd_level(simd_level::avx512);
+  ASSERT_EQ(get_simd_level(), detected);
+}
+
+TEST(FTSemiring, AllPairsShortestPathsBySquaring) {
+  const scoped_num_threads threads(4);
+
+  const std::size_t n = 150;
+  const int inf = min_plus<int>::zero();
+  matrix<int> dist(n, n, inf);
+  for (std::size_t i = 0; i != n; ++i) {
+	dist(i, i) = 0;
+	dist(i, (i + 1) % n) = static_cast<int>(i % 7 + 1);
+	dist(i, (i * 13 + 5) % n) = static_cast<int>(i % 11 + 20);
+  }
+
+  matrix<int> floyd(dist);
+  for (std::size_t k = 0; k != n; ++k)
+	for (std::size_t i = 0; i != n; ++i)
+	  for (std::size_t j = 0; j != n; ++j)
+		floyd(i, j) = min_plus<int>::add(floyd(i, j), min_plus<int>::mul(floyd(i, k), floyd(k, j)));
+
+  matrix<int> squared(dist);
+  for (std::size_t edges = 1; edges < n; edges *= 2)
+	squared = mul<min_plus<int>>(squared, squared);
+
+  ASSERT_EQ(squared, floyd);
+}
+
+TEST(FTSemiring, InfinityIsAbsorbing) {
+  const int inf = min_plus<int>::zero();
+  matrix<int> lhs(40, 40, inf), rhs(40, 40, 5);
+
+  ASSERT_EQ(mul<min_plus<int>>(lhs, rhs), matrix<int>(40, 40, inf));
+  ASSERT_EQ(mul<max_plus<int>>(matrix<int>(40, 40, max_plus<int>::zero()), rhs),
+			matrix<int>(40, 40, max_plus<int>::zero()));
+}
+
+TEST(FTSemiring, BooleanTransitiveStep) {
+  matrix<bool> adjacency(3, 3, {true, true, false,
+								false, true, true,
+								false, false, true});
+
+  ASSERT_EQ(mul<boolean<bool>>(adjacency, adjacency), matrix<bool>(3, 3, {true, true, true,
+																		  false, true, true,
+																		  false, false, true}));
+}
+
+TEST(FTSemiring, Exceptions) {
+  matrix<int> lhs(3, 4), rhs(3, 4);
+  ASSERT_ANY_THROW(mul<min_plus<int>>(lhs, rhs));
+  ASSERT_EQ(mul<min_plus<int>>(matrix<int>(2, 0), matrix<int>(0, 3)), matrix<int>(2, 3, min_plus<int>::zero()));
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_solve.h>
+#include <mtlt/static_matrix.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+TEST(FTSolve, ManyRightHandSides) {
+  const std::size_t sizes[][2] = {{1, 1}, {5, 3}, {17, 40}, {150, 1}, {300, 70}};
+
+  for (const auto &size : sizes) {
+	matrix<double> a = random_matrix(size[0], size[0], 1);
+	matrix<double> b = random_matrix(size[0], size[1], 2);
+
+	expect_near(a * solve(a, b), b, 1e-8);
+  }
+}
+
+TEST(FTSolve, Vector) {
+  matrix<double> a = random_matrix(90, 90, 3);
+  std::vector<double> b(90);
+  for (std::size_t i = 0; i != b.size(); ++i)
+	b[i] = static_cast<double>(i);
+
+  std::vector<double> product = a * solve(a, b);
+  for (std::size_t i = 0; i != b.size(); ++i)
+	ASSERT_NEAR(product[i], b[i], 1e-8);
+}
+
+TEST(FTSolve, InPlace) {
+  const matrix<double> a = random_matrix(200, 200, 4);
+  const matrix<double> b = random_matrix(200, 30, 5);
+
+  matrix<double> factors(a), x(b);
+  solve_in_place(factors, x);
+  expect_near(a * x, b, 1e-8);
+
+  lu<double> factorization(a);
+  matrix<double> cached(b);
+  factorization.solve_in_place(cached);
+  expect_near(cached, x, 1e-10);
+}
+
+TEST(FTSolve, StaticMatrix) {
+  static_matrix<double, 3, 3> a;
+  static_matrix<double, 3, 2> b;
+  const double items[] = {2, 5, 0, 0, 9, 7, 8, 1, 3};
+  std::copy(items, items + 9, a.begin());
+  std::iota(b.begin(), b.end(), 1.0);
+
+  static_matrix<double, 3, 2> x = solve(a, b);
+  static_matrix<double, 3, 2> product = a * x;
+  for (std::size_t i = 0; i != 6; ++i)
+	ASSERT_NEAR(product.data()[i], b.data()[i], 1e-12);
+
+  solve_in_place(a, b);
+  ASSERT_EQ(b, x);
+}
+
+TEST(FTSolve, ParallelLargeSystem) {
+  const scoped_num_threads threads(4);
+
+  matrix<double> a = random_matrix(400, 400, 6);
+  matrix<double> b = random_matrix(400, 200, 7);
+  matrix<double> x = solve(a, b);
+
+  expect_near(a * x, b, 1e-8);
+}
+
+TEST(FTSolve, Exceptions) {
+  matrix<double> singular(3, 3, {1, 2, 3, 2, 4, 6, 1, 1, 1});
+
+  ASSERT_ANY_THROW(solve(singular, matrix<double>(3, 1)));
+  ASSERT_ANY_THROW(solve(matrix<double>(3, 4), matrix<double>(3, 1)));
+  ASSERT_ANY_THROW(solve(matrix<double>::identity(3, 3), matrix<double>(4, 1)));
+  ASSERT_ANY_THROW(solve(matrix<double>::identity(3, 3), std::vector<double>(4)));
+
+  matrix<double> wide(3, 4), b(3, 1);
+  ASSERT_ANY_THROW(solve_in_place(wide, b));
+}
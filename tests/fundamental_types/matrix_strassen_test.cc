@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include <mtlt/matrix_strassen.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+TEST(FTStrassen, PowerOfTwoMatchesBlocked) {
+  matrix<long long> lhs = integer_matrix<long long>(128, 128, 1);
+  matrix<long long> rhs = integer_matrix<long long>(128, 128, 2);
+
+  ASSERT_EQ(mul_strassen(lhs, rhs, 16), lhs * rhs);
+}
+
+TEST(FTStrassen, OddAndRectangularShapes) {
+  const std::size_t sizes[][3] = {{1, 1, 1}, {33, 33, 33}, {65, 47, 91}, {100, 17, 64}, {9, 130, 71}, {127, 129, 131}};
+
+  for (const auto &size : sizes) {
+	matrix<int> lhs = integer_matrix<int>(size[0], size[1], 3);
+	matrix<int> rhs = integer_matrix<int>(size[1], size[2], 4);
+
+	ASSERT_EQ(mul_strassen(lhs, rhs, 8), lhs * rhs);
+  }
+}
+
+TEST(FTStrassen, FloatingMatchesBlocked) {
+  matrix<double> lhs = integer_matrix<double>(150, 111, 5);
+  matrix<double> rhs = integer_matrix<double>(111, 97, 6);
+
+  matrix<double> strassen = mul_strassen(lhs, rhs, 10);
+  matrix<double> expected = lhs * rhs;
+
+  for (std::size_t i = 0; i != strassen.size(); ++i)
+	ASSERT_NEAR(strassen.data()[i], expected.data()[i], 1e-9);
+}
+
+TEST(FTStrassen, BelowCutoffUsesBlocked) {
+  matrix<float> lhs = integer_matrix<float>(40, 50, 7);
+  matrix<float> rhs = integer_matrix<float>(50, 60, 8);
+
+  ASSERT_EQ(mul_strassen(lhs, rhs), lhs * rhs);
+}
+
+TEST(FTStrassen, Exceptions) {
+  matrix<int> lhs(3, 4), rhs(3, 4);
+  ASSERT_ANY_THROW(mul_strassen(lhs, rhs));
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <mtlt/matrix.h>
+#include <mtlt/matrix_svd.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+namespace {
+
+template<typename T>
+matrix<T> reconstruct(const svd_result<T> &decomposition) {
+  matrix<T> scaled(decomposition.u);
+  for (std::size_t row = 0; row != scaled.rows(); ++row)
+	for (std::size_t col = 0; col != scaled.cols(); ++col)
+	  scaled(row, col) *= decomposition.s[col];
+  return scaled * decomposition.vt;
+}
+
+void expect_decomposition(const matrix<double> &a, const svd_result<double> &decomposition) {
+  const std::size_t k = std::min(a.rows(), a.cols());
+  ASSERT_EQ(decomposition.u.rows(), a.rows());
+  ASSERT_EQ(decomposition.u.cols(), k);
+  ASSERT_EQ(decomposition.s.size(), k);
+  ASSERT_EQ(decomposition.vt.rows(), k);
+  ASSERT_EQ(decomposition.vt.cols(), a.cols());
+
+  for (std::size_t i = 0; i + 1 < k; ++i)
+	ASSERT_GE(decomposition.s[i], decomposition.s[i + 1]);
+  ASSERT_GE(decomposition.s[k - 1], 0.0);
+
+  expect_near(reconstruct(decomposition), a, 1e-10);
+  expect_near(mul_tn(decomposition.u, decomposition.u), matrix<double>::identity(k, k), 1e-10);
+  expect_near(mul_nt(decomposition.vt, decomposition.vt), matrix<double>::identity(k, k), 1e-10);
+}
+
+} // namespace
+
+TEST(FTSvd, KnownValues) {
+  matrix<double> a(3, 2, {3, 0, 0, -4, 0, 0});
+  svd_result<double> decomposition = svd(a);
+
+  ASSERT_NEAR(decomposition.s[0], 4.0, 1e-14);
+  ASSERT_NEAR(decomposition.s[1], 3.0, 1e-14);
+  expect_decomposition(a, decomposition);
+}
+
+TEST(FTSvd, SquareTallAndWide) {
+  const std::size_t sizes[][2] = {{1, 1}, {7, 7}, {80, 80}, {150, 40}, {33, 97}, {5, 1}, {1, 6}};
+
+  for (const auto &size : sizes) {
+	matrix<double> a = random_matrix<double>(size[0], size[1], 3);
+	expect_decomposition(a, svd(a));
+  }
+}
+
+TEST(FTSvd, MatchesEigenvaluesOfGram) {
+  matrix<double> a = random_matrix<double>(60, 25, 7);
+  svd_result<double> decomposition = svd(a);
+
+  // The squared singular values are the Rayleigh quotients of a^T * a on the rows of vt
+  matrix<double> gram = mul_tn(a, a);
+  for (std::size_t i = 0; i != 25; ++i) {
+	double quotient = 0;
+	for (std::size_t row = 0; row != 25; ++row)
+	  for (std::size_t col = 0; col != 25; ++col)
+		quotient += decomposition.vt(i, row) * gram(row, col) * decomposition.vt(i, col);
+	ASSERT_NEAR(quotient, decomposition.s[i] * decomposition.s[i], 1e-10);
+  }
+}
+
+TEST(FTSvd, RankDeficient) {
+  matrix<double> a = random_matrix<double>(40, 3, 1) * random_matrix<double>(3, 12, 2);
+  svd_result<double> decomposition = svd(a);
+
+  for (std::size_t i = 3; i != 12; ++i)
+	ASSERT_NEAR(decomposition.s[i], 0.0, 1e-12);
+  expect_decomposition(a, decomposition);
+
+  matrix<double> zero(6, 4);
+  svd_result<double> zero_decomposition = svd(zero);
+  for (std::size_t i = 0; i != 4; ++i)
+	ASSERT_EQ(zero_decomposition.s[i], 0.0);
+  expect_decomposition(zero, zero_decomposition);
+
+  // The small singular values of a rank one matrix come out tiny but not zero
+  matrix<double> outer(6, 4);
+  for (std::size_t row = 0; row != 6; ++row)
+	for (std::size_t col = 0; col != 4; ++col)
+	  outer(row, col) = double((row + 1) * (col + 1));
+  svd_result<double> outer_decomposition = svd(outer);
+  for (std::size_t i = 1; i != 4; ++i)
+	ASSERT_NEAR(outer_decomposition.s[i], 0.0, 1e-12);
+  expect_decomposition(outer, outer_decomposition);
+}
+
+TEST(FTSvd, Float) {
+  matrix<float> a = random_matrix<float>(50, 30, 11);
+  svd_result<float> decomposition = svd(a);
+
+  expect_near(reconstruct(decomposition), a, 1e-5);
+  expect_near(mul_tn(decomposition.u, decomposition.u), matrix<float>::identity(30, 30), 1e-5);
+}
+
+TEST(FTSvd, RandomizedRecoversLowRank) {
+  matrix<double> a = random_matrix<double>(300, 8, 5) * random_matrix<double>(8, 120, 6);
+  svd_result<double> exact = svd(a);
+  svd_result<double> low_rank = randomized_svd(a, 8);
+
+  ASSERT_EQ(low_rank.u.rows(), 300);
+  ASSERT_EQ(low_rank.u.cols(), 8);
+  ASSERT_EQ(low_rank.s.size(), 8);
+  ASSERT_EQ(low_rank.vt.rows(), 8);
+  ASSERT_EQ(low_rank.vt.cols(), 120);
+
+  for (std::size_t i = 0; i != 8; ++i)
+	ASSERT_NEAR(low_rank.s[i], exact.s[i], 1e-9);
+  expect_near(reconstruct(low_rank), a, 1e-9);
+  expect_near(mul_tn(low_rank.u, low_rank.u), matrix<double>::identity(8, 8), 1e-10);
+}
+
+TEST(FTSvd, RandomizedLeadingValues) {
+  // Singular values 2^-i, the power iterations separate the leading ones
+  const std::size_t n = 60;
+  matrix<double> left = svd(random_matrix<double>(200, n, 1)).u;
+  matrix<double> right = svd(random_matrix<double>(n, n, 2)).vt;
+  for (std::size_t row = 0; row != left.rows(); ++row)
+	for (std::size_t col = 0; col != n; ++col)
+	  left(row, col) *= std::pow(0.5, static_cast<double>(col));
+  matrix<double> a = left * right;
+
+  svd_result<double> low_rank = randomized_svd(a, 5, 10, 2);
+  for (std::size_t i = 0; i != 5; ++i)
+	ASSERT_NEAR(low_rank.s[i], std::pow(0.5, static_cast<double>(i)), 1e-10);
+
+  // Fixed seed makes the result reproducible
+  svd_result<double> again = randomized_svd(a, 5, 10, 2);
+  ASSERT_EQ(low_rank.u, again.u);
+}
+
+TEST(FTSvd, RandomizedFloat) {
+  matrix<float> a = random_matrix<float>(500, 6, 9) * random_matrix<float>(6, 200, 10);
+  svd_result<float> low_rank = randomized_svd(a, 6, 4, 1);
+
+  expect_near(reconstruct(low_rank), a, 1e-4);
+}
+
+TEST(FTSvd, RandomizedExceptions) {
+  matrix<double> a(10, 4);
+
+  ASSERT_ANY_THROW(randomized_svd(a, 0));
+  ASSERT_ANY_THROW(randomized_svd(a, 5));
+  ASSERT_NO_THROW(randomized_svd(a, 4));
+}
@@ -273,6 +273,47 @@ TEST(FTDynamicmatrix, determinant) {
   EXPECT_THROW(m.determinant_gaussian(), std::logic_error);
 }
 
+TEST(FTDynamicmatrix, determinant_bareiss) {
+  matrix<int> m(3, 3, {3, 6, 2, 8, 6, 1, 9, 4, 7});
+  ASSERT_EQ(m.determinant_bareiss(), -212);
+
+  matrix<int> zero_pivot(3, 3, {0, 1, 2, 3, 4, 5, 6, 7, 9});
+  ASSERT_EQ(zero_pivot.determinant_bareiss(), -3);
+
+  matrix<long long> singular(3, 3, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  ASSERT_EQ(singular.determinant_bareiss(), 0);
+
+  // L * U with unit L and 3 on the diagonal of U, 3^38 is beyond the exact doubles
+  const std::size_t n = 38;
+  matrix<long long> lower = matrix<long long>::identity(n, n), upper(n, n);
+  for (std::size_t row = 0; row != n; ++row) {
+	upper(row, row) = 3;
+	for (std::size_t col = 0; col != n; ++col) {
+	  if (col < row && (row + col) % 3 == 0)
+		lower(row, col) = (row % 2 == 0) ? 1 : -1;
+	  if (col > row && (row * col) % 5 == 1)
+		upper(row, col) = (col % 2 == 0) ? 1 : -1;
+	}
+  }
+
+  long long expected = 1;
+  for (std::size_t i = 0; i != n; ++i)
+	expected *= 3;
+  ASSERT_EQ((lower * upper).determinant_bareiss(), expected);
+
+  m.resize(3, 4);
+  EXPECT_THROW(m.determinant_bareiss(), std::logic_error);
+}
+
+TEST(FTDynamicmatrix, determinant_laplacian_tiny_only) {
+  matrix<int> tiny = matrix<int>::identity(10, 10);
+  ASSERT_DOUBLE_EQ(tiny.determinant_laplacian(), 1.0);
+
+  matrix<int> large = matrix<int>::identity(11, 11);
+  EXPECT_THROW(large.determinant_laplacian(), std::logic_error);
+  ASSERT_EQ(large.determinant_bareiss(), 1);
+}
+
 TEST(FTDynamicmatrix, trace) {
   matrix<int> m(3, 3, {
 	  1, 2, 3,
@@ -568,3 +609,88 @@ TEST(FTDynamicmatrix, swap_cols) {
   bool equal = m == correct;
   ASSERT_TRUE(equal);
 }
+
+TEST(FTDynamicmatrix, Uninitializedmatrix) {
+  matrix<double> m(300, 200, uninitialized);
+  ASSERT_EQ(m.rows(), 300);
+  ASSERT_EQ(m.cols(), 200);
+
+  m.fill(2.5);
+  ASSERT_EQ(m(299, 199), 2.5);
+
+  matrix<double> copy(m);
+  ASSERT_TRUE(copy == m);
+
+  matrix<double> empty(0, 5, uninitialized);
+  ASSERT_EQ(empty.size(), 0);
+}
+
+TEST(FTDynamicmatrix, Filledmatrix) {
+  matrix<long long> m(50, 70, -3);
+  for (long long item : m)
+	ASSERT_EQ(item, -3);
+
+  matrix<float> zero(4, 4, 0.0f);
+  for (float item : zero)
+	ASSERT_EQ(item, 0.0f);
+}
+
+TEST(FTDynamicmatrix, Adoptmatrix) {
+  int released = 0;
+  double *buffer = new double[6]{1, 2, 3, 4, 5, 6};
+  {
+	matrix<double> m = matrix<double>::adopt(buffer, 2, 3, [&released](double *p) {
+	  ++released;
+	  delete[] p;
+	});
+	ASSERT_EQ(m.data(), buffer);
+	ASSERT_EQ(m(1, 2), 6.0);
+
+	matrix<double> copy(m);
+	ASSERT_NE(copy.data(), buffer);
+	ASSERT_TRUE(copy == m);
+
+	matrix<double> moved(std::move(m));
+	ASSERT_EQ(moved.data(), buffer);
+	ASSERT_EQ(released, 0);
+
+	moved.mul(2.0);
+	ASSERT_EQ(buffer[5], 12.0);
+
+	moved.resize(3, 3);
+	ASSERT_EQ(released, 1);
+	ASSERT_EQ(moved(1, 2), 12.0);
+  }
+  ASSERT_EQ(released, 1);
+
+  matrix<int> cleared = matrix<int>::adopt(new int[4](), 2, 2, [&released](int *p) {
+	++released;
+	delete[] p;
+  });
+  cleared.clear();
+  ASSERT_EQ(released, 2);
+  ASSERT_EQ(cleared.size(), 0);
+}
+
+TEST(FTDynamicmatrix, AdoptVectormatrix) {
+  std::vector<float> items(12, 1.5f);
+  const float *storage = items.data();
+
+  matrix<float> m = matrix<float>::adopt(std::move(items), 3, 4);
+  ASSERT_EQ(m.data(), storage);
+  ASSERT_EQ(m.sum(), 18.0f);
+
+  std::vector<float> wrong(5);
+  ASSERT_ANY_THROW(matrix<float>::adopt(std::move(wrong), 2, 2));
+}
+
+TEST(FTDynamicmatrix, Borrowmatrix) {
+  std::vector<long long> storage {1, 2, 3, 4};
+  {
+	matrix<long long> m = matrix<long long>::borrow(storage.data(), 2, 2);
+	m(0, 1) = 20;
+	matrix<long long> squared = m * m;
+	ASSERT_EQ(squared(0, 0), 61);
+  }
+  ASSERT_EQ(storage[1], 20);
+}
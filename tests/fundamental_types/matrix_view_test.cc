@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include <mtlt/matrix_view.h>
+
+using namespace mtlt;
+
+namespace {
+
+matrix<double> iota_matrix(std::size_t rows, std::size_t cols) {
+  matrix<double> m(rows, cols);
+  std::iota(m.begin(), m.end(), 0.0);
+  return m;
+}
+
+} // namespace
+
+TEST(FTMatrixView, WholeMatrix) {
+  matrix<double> m = iota_matrix(3, 4);
+  matrix_view<double> view(m);
+
+  ASSERT_EQ(view.rows(), 3);
+  ASSERT_EQ(view.cols(), 4);
+  ASSERT_EQ(view.leading_dimension(), 4);
+  ASSERT_TRUE(view.is_contiguous());
+  ASSERT_EQ(view.data(), m.data());
+  ASSERT_EQ(view(2, 3), 11.0);
+
+  view(1, 1) = -1.0;
+  ASSERT_EQ(m(1, 1), -1.0);
+  ASSERT_ANY_THROW(view.at(3, 0));
+}
+
+TEST(FTMatrixView, Submatrix) {
+  matrix<double> m = iota_matrix(5, 6);
+  matrix_view<double> block = make_view(m).submatrix(1, 2, 3, 3);
+
+  ASSERT_EQ(block.leading_dimension(), 6);
+  ASSERT_FALSE(block.is_contiguous());
+  ASSERT_EQ(block(0, 0), 8.0);
+  ASSERT_EQ(block(2, 2), 22.0);
+  ASSERT_EQ(block.sum(), 8 + 9 + 10 + 14 + 15 + 16 + 20 + 21 + 22);
+  ASSERT_EQ(block.trace(), 8 + 15 + 22);
+
+  block.fill(0.0);
+  ASSERT_EQ(m(1, 1), 7.0);
+  ASSERT_EQ(m(1, 2), 0.0);
+  ASSERT_EQ(m(3, 4), 0.0);
+  ASSERT_EQ(m(3, 5), 23.0);
+
+  ASSERT_ANY_THROW(make_view(m).submatrix(3, 0, 3, 1));
+  ASSERT_ANY_THROW(make_view(m).submatrix(0, 4, 1, 3));
+}
+
+TEST(FTMatrixView, RowsAndCols) {
+  matrix<double> m = iota_matrix(4, 3);
+  matrix_view<double> view(m);
+
+  matrix_view<double> row = view.row(2);
+  ASSERT_EQ(row.rows(), 1);
+  ASSERT_EQ(row.cols(), 3);
+  ASSERT_EQ(row(0, 1), 7.0);
+
+  matrix_view<double> col = view.col(1);
+  ASSERT_EQ(col.rows(), 4);
+  ASSERT_EQ(col.cols(), 1);
+  ASSERT_EQ(std::vector<double>(col.begin(), col.end()), std::vector<double>({1, 4, 7, 10}));
+
+  col.mul(10.0);
+  ASSERT_EQ(m(3, 1), 100.0);
+  ASSERT_EQ(m(3, 2), 11.0);
+}
+
+TEST(FTMatrixView, ExternalBuffer) {
+  std::vector<float> buffer(4 * 8, -1.0f);
+  matrix_view<float> padded(buffer.data(), 4, 6, 8);
+  padded.fill(2.0f);
+
+  for (std::size_t i = 0; i != buffer.size(); ++i)
+	ASSERT_EQ(buffer[i], i % 8 < 6 ? 2.0f : -1.0f);
+
+  matrix<float> copy = padded.to_matrix();
+  ASSERT_EQ(copy.rows(), 4);
+  ASSERT_EQ(copy.cols(), 6);
+  ASSERT_EQ(copy.sum(), 48.0f);
+
+  ASSERT_ANY_THROW(matrix_view<float>(buffer.data(), 4, 6, 5));
+}
+
+TEST(FTMatrixView, StaticMatrix) {
+  static_matrix<int, 3, 3> s({1, 2, 3, 4, 5, 6, 7, 8, 9});
+  matrix_view<int> view = make_view(s);
+  view.submatrix(1, 1, 2, 2).add(10);
+
+  ASSERT_EQ(s(0, 0), 1);
+  ASSERT_EQ(s(2, 2), 19);
+
+  const static_matrix<int, 3, 3> &cs = s;
+  matrix_view<const int> const_view = make_view(cs);
+  ASSERT_EQ(const_view(1, 1), 15);
+}
+
+TEST(FTMatrixView, Iterators) {
+  matrix<double> m = iota_matrix(4, 5);
+  matrix_view<double> block = make_view(m).submatrix(1, 1, 3, 3);
+
+  ASSERT_EQ(block.end() - block.begin(), 9);
+  ASSERT_EQ(block.begin()[4], 12.0);
+  ASSERT_EQ(*(block.begin() + 3), 11.0);
+  ASSERT_EQ(*(block.end() - 1), 18.0);
+  ASSERT_EQ(*block.rbegin(), 18.0);
+  ASSERT_EQ(*std::prev(block.rend()), 6.0);
+
+  std::vector<double> items(block.cbegin(), block.cend());
+  ASSERT_EQ(items, std::vector<double>({6, 7, 8, 11, 12, 13, 16, 17, 18}));
+
+  std::reverse(block.begin(), block.end());
+  ASSERT_EQ(m(1, 1), 18.0);
+  ASSERT_EQ(m(3, 3), 6.0);
+  ASSERT_EQ(m(1, 4), 9.0);
+
+  std::sort(block.begin(), block.end());
+  ASSERT_EQ(std::vector<double>(block.begin(), block.end()), items);
+}
+
+TEST(FTMatrixView, Arithmetic) {
+  matrix<double> m = iota_matrix(4, 4);
+  matrix_view<const double> top = make_view(m).submatrix(0, 0, 2, 2);
+  matrix_view<const double> bottom = make_view(m).submatrix(2, 2, 2, 2);
+
+  matrix<double> sum = top + bottom;
+  ASSERT_EQ(sum(0, 0), 10.0);
+  ASSERT_EQ(sum(1, 1), 20.0);
+
+  matrix<double> difference = bottom - top;
+  ASSERT_EQ(difference, matrix<double>(2, 2, 10.0));
+
+  matrix<double> scaled = top * 2.0;
+  ASSERT_EQ(scaled(1, 0), 8.0);
+
+  matrix<double> transposed = top.transpose();
+  ASSERT_EQ(transposed(0, 1), 4.0);
+
+  ASSERT_TRUE(top == make_view(m).submatrix(0, 0, 2, 2));
+  ASSERT_TRUE(top != bottom);
+
+  make_view(m).submatrix(2, 0, 2, 2).assign(top);
+  ASSERT_EQ(m(3, 1), 5.0);
+
+  make_view(m).submatrix(0, 0, 2, 4).swap_rows(0, 1);
+  ASSERT_EQ(m(0, 3), 7.0);
+  ASSERT_EQ(m(2, 3), 11.0);
+}
+
+TEST(FTMatrixView, Product) {
+  const std::size_t n = 96;
+  matrix<double> a(n, n), b(n, n);
+  a.fill_random(-1.0, 1.0);
+  b.fill_random(-1.0, 1.0);
+
+  matrix_view<const double> a_block = make_view(a).submatrix(8, 3, 40, 50);
+  matrix_view<const double> b_block = make_view(b).submatrix(11, 7, 50, 30);
+
+  matrix<double> product = a_block * b_block;
+  matrix<double> expected = a_block.to_matrix() * b_block.to_matrix();
+
+  ASSERT_EQ(product.rows(), 40);
+  ASSERT_EQ(product.cols(), 30);
+  for (std::size_t row = 0; row != product.rows(); ++row)
+	for (std::size_t col = 0; col != product.cols(); ++col)
+	  ASSERT_NEAR(product(row, col), expected(row, col), 1e-12);
+
+  std::vector<double> x(50, 1.0);
+  std::vector<double> ax = a_block * x;
+  for (std::size_t row = 0; row != ax.size(); ++row)
+	ASSERT_NEAR(ax[row], a_block.row(row).sum(), 1e-12);
+}
+
+TEST(FTMatrixView, GemmIntoBlock) {
+  const std::size_t n = 128;
+  matrix<double> a(n, n), b(n, n), c(n, n, 1.0);
+  a.fill_random(-1.0, 1.0);
+  b.fill_random(-1.0, 1.0);
+
+  matrix_view<double> va(a), vb(b), vc(c);
+  gemm(2.0, va.submatrix(0, 0, 64, n), vb.submatrix(0, 64, n, 64), 1.0, vc.submatrix(64, 0, 64, 64));
+
+  matrix<double> expected = a * b;
+  for (std::size_t row = 0; row != n; ++row)
+	for (std::size_t col = 0; col != n; ++col) {
+	  if (row >= 64 && col < 64)
+		ASSERT_NEAR(c(row, col), 1.0 + 2.0 * expected(row - 64, col + 64), 1e-11);
+	  else
+		ASSERT_EQ(c(row, col), 1.0);
+	}
+
+  ASSERT_ANY_THROW(gemm(1.0, va.submatrix(0, 0, 64, 64), vb.submatrix(0, 0, 64, 64), 0.0, va.submatrix(32, 32, 64, 64)));
+  ASSERT_ANY_THROW(gemm(1.0, va, vb.submatrix(0, 0, 64, 64), 0.0, vc));
+}
+
+TEST(FTMatrixView, GemmDisjointBlocksOfOneMatrix) {
+  const std::size_t n = 8, h = n / 2;
+  matrix<double> m(n, n);
+  m.fill_random(-1.0, 1.0);
+  const matrix<double> original = m;
+
+  // Trailing update of a blocked factorization: A22 -= A21 * A12
+  matrix_view<double> v(m);
+  gemm(-1.0, v.submatrix(h, 0, h, h), v.submatrix(0, h, h, h), 1.0, v.submatrix(h, h, h, h));
+
+  for (std::size_t row = 0; row != n; ++row)
+	for (std::size_t col = 0; col != n; ++col) {
+	  double expected = original(row, col);
+	  if (row >= h && col >= h)
+		for (std::size_t k = 0; k != h; ++k)
+		  expected -= original(row, k) * original(k, col);
+	  ASSERT_NEAR(m(row, col), expected, 1e-12);
+	}
+
+  // The left and right halves of the same rows are disjoint as well
+  ASSERT_NO_THROW(gemm(1.0, v.submatrix(0, 0, h, h), v.submatrix(h, 0, h, h), 0.0, v.submatrix(0, h, h, h)));
+  ASSERT_ANY_THROW(gemm(1.0, v.submatrix(0, 0, h, h), v.submatrix(0, 2, h, h), 0.0, v.submatrix(0, 3, h, h)));
+  ASSERT_ANY_THROW(gemm(1.0, v.submatrix(0, 0, h, h), v.submatrix(h, 0, h, h), 0.0, v.submatrix(2, 2, h, h)));
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <mtlt/static_matrix_batch.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+namespace {
+
+template<typename Matrix>
+std::vector<Matrix> sequence_batch(std::size_t count, int seed) {
+  std::vector<Matrix> batch(count);
+  for (auto &item : batch)
+	item.generate([&seed]() { return static_cast<typename Matrix::value_type>(next_integer(seed)); });
+  return batch;
+}
+
+} // namespace
+
+TEST(FTBatch, FloatTransforms) {
+  using transform = static_matrix<float, 4, 4>;
+  const std::size_t counts[] = {0, 1, 15, 16, 17, 100};
+
+  for (std::size_t count : counts) {
+	std::vector<transform> lhs = sequence_batch<transform>(count, 1);
+	std::vector<transform> rhs = sequence_batch<transform>(count, 2);
+	std::vector<transform> result = batch_mul(lhs, rhs);
+
+	ASSERT_EQ(result.size(), count);
+	for (std::size_t i = 0; i != count; ++i)
+	  ASSERT_EQ(result[i], lhs[i] * rhs[i]);
+  }
+}
+
+TEST(FTBatch, RectangularDouble) {
+  std::vector<static_matrix<double, 2, 3>> lhs = sequence_batch<static_matrix<double, 2, 3>>(37, 3);
+  std::vector<static_matrix<double, 3, 5>> rhs = sequence_batch<static_matrix<double, 3, 5>>(37, 4);
+  std::vector<static_matrix<double, 2, 5>> result = batch_mul(lhs, rhs);
+
+  for (std::size_t i = 0; i != lhs.size(); ++i)
+	ASSERT_EQ(result[i], lhs[i] * rhs[i]);
+}
+
+TEST(FTBatch, EverySimdLevel) {
+  const simd_level detected = detected_simd_level();
+
+  std::vector<static_matrix<int, 3, 3>> lhs = sequence_batch<static_matrix<int, 3, 3>>(50, 5);
+  std::vector<static_matrix<int, 3, 3>> rhs = sequence_batch<static_matrix<int, 3, 3>>(50, 6);
+
+  for (int level = 0; level <= static_cast<int>(detected); ++level) {
+	set_simd_level(static_cast<simd_level>(level));
+
+	std::vector<static_matrix<int, 3, 3>> result = batch_mul(lhs, rhs);
+	for (std::size_t i = 0; i != lhs.size(); ++i)
+	  ASSERT_EQ(result[i], lhs[i] * rhs[i]);
+  }
+
+  set_simd_level(detected);
+}
+
+TEST(FTBatch, InPlaceAndParallel) {
+  const scoped_num_threads threads(4);
+
+  using transform = static_matrix<float, 4, 4>;
+  std::vector<transform> lhs = sequence_batch<transform>(40000, 7);
+  std::vector<transform> rhs = sequence_batch<transform>(40000, 8);
+  std::vector<transform> expected(lhs.size());
+  for (std::size_t i = 0; i != lhs.size(); ++i)
+	expected[i] = lhs[i] * rhs[i];
+
+  batch_mul(lhs.data(), rhs.data(), lhs.data(), lhs.size());
+
+  ASSERT_EQ(lhs, expected);
+}
+
+TEST(FTBatch, FallbackAndExceptions) {
+  std::vector<static_matrix<int, 20, 20>> lhs = sequence_batch<static_matrix<int, 20, 20>>(3, 9);
+  std::vector<static_matrix<int, 20, 20>> rhs = sequence_batch<static_matrix<int, 20, 20>>(3, 10);
+  std::vector<static_matrix<int, 20, 20>> result = batch_mul(lhs, rhs);
+
+  for (std::size_t i = 0; i != lhs.size(); ++i)
+	ASSERT_EQ(result[i], lhs[i] * rhs[i]);
+
+  // Little work, but operands too large to be staged on the stack
+  static_assert(!detail::is_batch_compatible<double, 64, 64, 1>::value, "64 x 64 operands are not batched");
+  static_assert(!detail::is_batch_compatible<double, 64, 1, 64>::value, "64 x 64 results are not batched");
+  std::vector<static_matrix<double, 64, 1>> columns = sequence_batch<static_matrix<double, 64, 1>>(5, 11);
+  std::vector<static_matrix<double, 1, 64>> rows = sequence_batch<static_matrix<double, 1, 64>>(5, 12);
+  std::vector<static_matrix<double, 64, 64>> outer = batch_mul(columns, rows);
+  for (std::size_t i = 0; i != columns.size(); ++i)
+	ASSERT_EQ(outer[i], columns[i] * rows[i]);
+
+  rhs.pop_back();
+  ASSERT_ANY_THROW(batch_mul(lhs, rhs));
+}
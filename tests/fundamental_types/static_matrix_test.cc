@@ -219,6 +219,15 @@ TEST(FTStaticMatrix, determinant) {
   ASSERT_DOUBLE_EQ(determinant2, -212.0);
 }
 
+TEST(FTStaticMatrix, determinant_bareiss) {
+  static_matrix<int, 3, 3> m({3, 6, 2, 8, 6, 1, 9, 4, 7});
+  ASSERT_EQ(m.determinant_bareiss(), -212);
+  ASSERT_DOUBLE_EQ(m.determinant_laplacian(), -212.0);
+
+  static_matrix<long long, 3, 3> zero_pivot({0, 1, 2, 3, 4, 5, 6, 7, 9});
+  ASSERT_EQ(zero_pivot.determinant_bareiss(), -3);
+}
+
 TEST(FTStaticMatrix, trace) {
   static_matrix<int, 3, 3> m({
 								 1, 2, 3,
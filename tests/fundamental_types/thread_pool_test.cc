@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+
+#include <mtlt/thread_pool.h>
+
+#include "matrix_test_helpers.h"
+
+using namespace mtlt;
+using namespace mtlt::test;
+
+TEST(FTThreadPool, ParallelForRunsEveryTask) {
+  thread_pool pool(4);
+  ASSERT_EQ(pool.size(), 4);
+
+  std::vector<std::atomic<int>> hits(1000);
+  pool.parallel_for(hits.size(), [&hits](std::size_t task) { hits[task].fetch_add(1); });
+
+  for (const auto &hit : hits)
+	ASSERT_EQ(hit.load(), 1);
+}
+
+TEST(FTThreadPool, NestedParallelFor) {
+  thread_pool pool(3);
+  std::atomic<int> sum{0};
+
+  pool.parallel_for(8, [&pool, &sum](std::size_t outer) {
+	pool.parallel_for(8, [&sum, outer](std::size_t inner) {
+	  sum.fetch_add(static_cast<int>(outer * inner));
+	});
+  });
+
+  ASSERT_EQ(sum.load(), 28 * 28);
+}
+
+TEST(FTThreadPool, WaitingThreadRunsNestedTasks) {
+  thread_pool pool(2);
+  const std::thread::id caller = std::this_thread::get_id();
+  std::atomic<int> started{0}, arrived{0};
+  std::atomic<bool> met{true};
+
+  auto reaches = [](const std::atomic<int> &counter, int value) {
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (counter.load() < value)
+	  if (std::chrono::steady_clock::now() > deadline)
+		return false;
+	return true;
+  };
+
+  pool.parallel_for(2, [&](std::size_t) {
+	started.fetch_add(1);
+	if (std::this_thread::get_id() == caller) {
+	  reaches(started, 2);
+	  return;
+	}
+
+	// The inner tasks meet only if the caller, which waits for this outer task
+	// with empty queues by now, runs one of them
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	pool.parallel_for(2, [&](std::size_t) {
+	  arrived.fetch_add(1);
+	  if (!reaches(arrived, 2))
+		met.store(false);
+	});
+  });
+
+  ASSERT_TRUE(met.load());
+}
+
+TEST(FTThreadPool, ExceptionIsRethrown) {
+  thread_pool pool(4);
+  std::atomic<int> finished{0};
+
+  ASSERT_THROW(pool.parallel_for(64, [&finished](std::size_t task) {
+	if (task == 17)
+	  throw std::runtime_error("task failed");
+	finished.fetch_add(1);
+  }), std::runtime_error);
+
+  ASSERT_EQ(finished.load(), 63);
+}
+
+TEST(FTThreadPool, NumThreads) {
+  const scoped_num_threads threads(3);
+  ASSERT_EQ(get_num_threads(), 3);
+
+  set_num_threads(0);
+  ASSERT_GE(get_num_threads(), 1);
+}
@@ -0,0 +1,89 @@
+#ifndef MTLT_TESTS_MATRIX_TEST_HELPERS_H_
+#define MTLT_TESTS_MATRIX_TEST_HELPERS_H_
+
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <cstddef>
+
+#include <mtlt/matrix.h>
+#include <mtlt/thread_pool.h>
+
+namespace mtlt {
+
+namespace test {
+
+/**
+ * Next item of the sequence of small integers in [-9, 9], the
+ * products of such items are exact for every arithmetic type
+ */
+inline int next_integer(int &state) {
+  state = (state * 37 + 11) % 19;
+  return state - 9;
+}
+
+/**
+ * Next item of the linear congruential sequence in [-0.5, 0.5]
+ */
+inline double next_random(unsigned &state) {
+  state = state * 1103515245u + 12345u;
+  return static_cast<double>(state >> 16 & 0x7fff) / 0x7fff - 0.5;
+}
+
+template<typename T>
+matrix<T> integer_matrix(std::size_t rows, std::size_t cols, int seed) {
+  matrix<T> m(rows, cols);
+  m.generate([&seed]() { return static_cast<T>(next_integer(seed)); });
+  return m;
+}
+
+template<typename T = double>
+matrix<T> random_matrix(std::size_t rows, std::size_t cols, int seed) {
+  matrix<T> m(rows, cols);
+  unsigned state = static_cast<unsigned>(seed);
+  m.generate([&state]() { return static_cast<T>(next_random(state)); });
+  return m;
+}
+
+inline std::vector<double> random_vector(std::size_t size, int seed) {
+  std::vector<double> v(size);
+  unsigned state = static_cast<unsigned>(seed);
+  for (double &item : v)
+	item = next_random(state);
+  return v;
+}
+
+template<typename T>
+void expect_near(const matrix<T> &lhs, const matrix<T> &rhs, double tolerance) {
+  ASSERT_EQ(lhs.rows(), rhs.rows());
+  ASSERT_EQ(lhs.cols(), rhs.cols());
+  for (std::size_t i = 0; i != lhs.size(); ++i)
+	ASSERT_NEAR(lhs.data()[i], rhs.data()[i], tolerance);
+}
+
+/**
+ * Sets the number of threads of the pool for the scope, the previous
+ * number is restored even when an assertion fails or an exception is thrown
+ */
+class scoped_num_threads {
+public:
+  explicit scoped_num_threads(std::size_t threads) : saved_(get_num_threads()) {
+	set_num_threads(threads);
+  }
+
+  scoped_num_threads(const scoped_num_threads &) = delete;
+  scoped_num_threads &operator=(const scoped_num_threads &) = delete;
+
+  ~scoped_num_threads() {
+	set_num_threads(saved_);
+  }
+
+private:
+  std::size_t saved_;
+};
+
+} // namespace test end
+
+} // namespace mtlt end
+
+#endif // MTLT_TESTS_MATRIX_TEST_HELPERS_H_
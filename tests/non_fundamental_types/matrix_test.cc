@@ -490,3 +490,11 @@ TEST(NFTDynamicmatrix, swap_cols) {
   bool equal = m == correct;
   ASSERT_TRUE(equal);
 }
+
+TEST(NFTDynamicmatrix, Uninitializedmatrix) {
+  matrix<std::string> m(2, 3, uninitialized);
+  ASSERT_EQ(m(1, 2), "");
+
+  matrix<std::string> filled(2, 3, "MTLT");
+  ASSERT_EQ(filled(1, 2), "MTLT");
+}